@@ -0,0 +1,596 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogCache.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Compiled (binary) form of the conversion catalog.  The cache is
+//				 keyed by a hash of the XML it was built from and is read through a
+//				 memory mapping, without any parsing or equation solving.
+// History:
+
+// Standard C++ headers
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+// wxWidgets headers
+#include <wx/file.h>
+#include <wx/filefn.h>
+
+// Local headers
+#include "catalogCache.h"
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CatalogCache class.  The version must
+//					be incremented whenever the layout changes.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const uint32_t CatalogCache::version(5);
+const char CatalogCache::magic[8] = { 'C', 'N', 'V', 'C', 'A', 'C', 'H', 'E' };
+const uint32_t CatalogCache::byteOrderMark(0x01020304);
+const uint32_t CatalogCache::noString(0xFFFFFFFF);
+const uint32_t CatalogCache::pathEdgeFlag(0x1);
+const uint32_t CatalogCache::defaultDisplay(2);
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Hash
+//
+// Description:		Computes the 64-bit FNV-1a hash of the data.
+//
+// Input Arguments:
+//		data	= const char*
+//		size	= const size_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		uint64_t
+//
+//==========================================================================
+uint64_t CatalogCache::Hash(const char *data, const size_t &size)
+{
+	uint64_t hash(0xCBF29CE484222325ULL);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		HashHeader
+//
+// Description:		Hashes the header, which holds the size and location of
+//					everything else.  Writing the cache under a temporary
+//					name and renaming it means the rest of the file cannot
+//					be partial, so only the header is hashed.
+//
+// Input Arguments:
+//		header	= Header (copied, so its hash can be cleared)
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		uint64_t
+//
+//==========================================================================
+uint64_t CatalogCache::HashHeader(Header header)
+{
+	header.headerHash = 0;
+	return Hash(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Align
+//
+// Description:		Rounds the offset up so that the following section is
+//					aligned for direct access through the mapping.
+//
+// Input Arguments:
+//		offset	= const uint64_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		uint64_t
+//
+//==========================================================================
+static uint64_t Align(const uint64_t &offset)
+{
+	return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Intern
+//
+// Description:		Returns the index of the string in the string table,
+//					adding it if necessary.
+//
+// Input Arguments:
+//		s		= const wxString&
+//		strings	= std::vector<std::string>&
+//		ids		= std::unordered_map<std::string, uint32_t>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		uint32_t
+//
+//==========================================================================
+static uint32_t Intern(const wxString &s, std::vector<std::string> &strings,
+	std::unordered_map<std::string, uint32_t> &ids)
+{
+	std::string utf8(s.utf8_str());
+	std::unordered_map<std::string, uint32_t>::const_iterator it(ids.find(utf8));
+	if (it != ids.end())
+		return it->second;
+
+	const uint32_t id(static_cast<uint32_t>(strings.size()));
+	ids.insert(std::make_pair(utf8, id));
+	strings.push_back(std::move(utf8));
+	return id;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Write
+//
+// Description:		Writes the cache for the specified groups.  The file is
+//					written under a temporary name and renamed, so readers
+//					never see a partial cache.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		sourceHash	= const uint64_t&
+//		sourceSize	= const uint64_t&
+//		groups		= const std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool CatalogCache::Write(const wxString &fileName, const uint64_t &sourceHash,
+	const uint64_t &sourceSize, const std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, uint32_t> ids;
+	std::vector<GroupEntry> groupTable;
+	std::vector<EquivalenceEntry> equivalenceTable;
+
+	groupTable.reserve(groups.size());
+	for (const auto &group : groups)
+	{
+		GroupEntry g;
+		g.name = Intern(group.name, strings, ids);
+		g.display = !group.displaySet ? defaultDisplay : group.display ? 1 : 0;
+		g.firstEquivalence = static_cast<uint32_t>(equivalenceTable.size());
+		g.equivalenceCount = static_cast<uint32_t>(group.equiv.size());
+
+		for (const auto &equiv : group.equiv)
+		{
+			EquivalenceEntry e;
+			e.aUnit = Intern(equiv.aUnit, strings, ids);
+			e.bUnit = Intern(equiv.bUnit, strings, ids);
+			e.equation = Intern(equiv.equation, strings, ids);
+			e.aSolution = equiv.aSolution.IsEmpty() ? noString : Intern(equiv.aSolution, strings, ids);
+			e.bSolution = equiv.bSolution.IsEmpty() ? noString : Intern(equiv.bSolution, strings, ids);
+			e.flags = equiv.pathEdge ? pathEdgeFlag : 0;
+			equivalenceTable.push_back(e);
+		}
+
+		groupTable.push_back(g);
+	}
+
+	std::vector<StringEntry> stringTable(strings.size());
+	uint64_t stringDataSize(0);
+	for (size_t i = 0; i < strings.size(); i++)
+	{
+		stringTable[i].offset = static_cast<uint32_t>(stringDataSize);
+		stringTable[i].length = static_cast<uint32_t>(strings[i].size());
+		stringDataSize += strings[i].size();
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.byteOrderMark = byteOrderMark;
+	header.sourceHash = sourceHash;
+	header.sourceSize = sourceSize;
+	header.stringCount = static_cast<uint32_t>(stringTable.size());
+	header.groupCount = static_cast<uint32_t>(groupTable.size());
+	header.equivalenceCount = static_cast<uint32_t>(equivalenceTable.size());
+	header.stringTableOffset = Align(sizeof(header));
+	header.groupTableOffset = Align(header.stringTableOffset + stringTable.size() * sizeof(StringEntry));
+	header.equivalenceTableOffset = Align(header.groupTableOffset + groupTable.size() * sizeof(GroupEntry));
+	header.stringDataOffset = Align(header.equivalenceTableOffset + equivalenceTable.size() * sizeof(EquivalenceEntry));
+	header.fileSize = header.stringDataOffset + stringDataSize;
+	header.headerHash = HashHeader(header);
+
+	std::vector<char> buffer(static_cast<size_t>(header.fileSize), 0);
+	memcpy(buffer.data(), &header, sizeof(header));
+	if (!stringTable.empty())
+		memcpy(buffer.data() + header.stringTableOffset, stringTable.data(), stringTable.size() * sizeof(StringEntry));
+	if (!groupTable.empty())
+		memcpy(buffer.data() + header.groupTableOffset, groupTable.data(), groupTable.size() * sizeof(GroupEntry));
+	if (!equivalenceTable.empty())
+		memcpy(buffer.data() + header.equivalenceTableOffset, equivalenceTable.data(), equivalenceTable.size() * sizeof(EquivalenceEntry));
+	for (size_t i = 0; i < strings.size(); i++)
+		memcpy(buffer.data() + header.stringDataOffset + stringTable[i].offset, strings[i].data(), strings[i].size());
+
+	const wxString temporaryFileName(fileName + _T(".tmp"));
+	wxFile file;
+	if (!file.Create(temporaryFileName, true))
+		return false;
+
+	const bool written(file.Write(buffer.data(), buffer.size()) == buffer.size());
+	file.Close();
+	if (!written)
+	{
+		wxRemoveFile(temporaryFileName);
+		return false;
+	}
+
+	return wxRenameFile(temporaryFileName, fileName, true);
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		SectionIsValid
+//
+// Description:		Checks that a table lies within the file and is aligned.
+//
+// Input Arguments:
+//		header		= const Header&
+//		offset		= const uint64_t&
+//		count		= const uint64_t&
+//		entrySize	= const size_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool CatalogCache::SectionIsValid(const Header &header, const uint64_t &offset,
+	const uint64_t &count, const size_t &entrySize)
+{
+	return offset % 8 == 0 && offset <= header.fileSize &&
+		count <= (header.fileSize - offset) / entrySize;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Read
+//
+// Description:		Reads the groups from the cache.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		sourceHash	= const uint64_t&
+//		sourceSize	= const uint64_t&
+//
+// Output Arguments:
+//		groups		= std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Return Value:
+//		bool, true if the cache was valid for the specified source
+//
+//==========================================================================
+bool CatalogCache::Read(const wxString &fileName, const uint64_t &sourceHash,
+	const uint64_t &sourceSize, std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	CatalogCache cache;
+	if (!cache.Open(fileName, sourceHash, sourceSize))
+		return false;
+
+	cache.GetGroups(groups);
+	return true;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Open
+//
+// Description:		Maps and validates the specified cache, which must have
+//					been built from the specified source.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		sourceHash	= const uint64_t&
+//		sourceSize	= const uint64_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool CatalogCache::Open(const wxString &fileName, const uint64_t &sourceHash,
+	const uint64_t &sourceSize)
+{
+	Close();
+	if (!::wxFileExists(fileName) || !file.Open(fileName) || !Validate(sourceHash, sourceSize))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Close
+//
+// Description:		Unmaps the cache.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogCache::Close()
+{
+	file.Close();
+	header = nullptr;
+	stringTable = nullptr;
+	groupTable = nullptr;
+	equivalenceTable = nullptr;
+	stringData = nullptr;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		Validate
+//
+// Description:		Checks the header and every offset and index in the
+//					mapped file, and sets up the table pointers.  The text
+//					is only read as groups are copied out.
+//
+// Input Arguments:
+//		sourceHash	= const uint64_t&
+//		sourceSize	= const uint64_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if the cache is valid
+//
+//==========================================================================
+bool CatalogCache::Validate(const uint64_t &sourceHash, const uint64_t &sourceSize)
+{
+	if (file.GetSize() < sizeof(Header))
+		return false;
+
+	// The mapping is page-aligned, so the header and tables are aligned
+	const char *data(file.GetData());
+	const Header &h(*reinterpret_cast<const Header*>(data));
+	if (memcmp(h.magic, magic, sizeof(magic)) != 0 ||
+		h.version != version ||
+		h.byteOrderMark != byteOrderMark ||
+		h.headerHash != HashHeader(h) ||
+		h.sourceHash != sourceHash ||
+		h.sourceSize != sourceSize ||
+		h.fileSize != file.GetSize() ||
+		!SectionIsValid(h, h.stringTableOffset, h.stringCount, sizeof(StringEntry)) ||
+		!SectionIsValid(h, h.groupTableOffset, h.groupCount, sizeof(GroupEntry)) ||
+		!SectionIsValid(h, h.equivalenceTableOffset, h.equivalenceCount, sizeof(EquivalenceEntry)) ||
+		h.stringDataOffset > h.fileSize)
+		return false;
+
+	const StringEntry *strings(reinterpret_cast<const StringEntry*>(data + h.stringTableOffset));
+	const GroupEntry *groups(reinterpret_cast<const GroupEntry*>(data + h.groupTableOffset));
+	const EquivalenceEntry *equivalences(reinterpret_cast<const EquivalenceEntry*>(data + h.equivalenceTableOffset));
+	const uint64_t stringDataSize(h.fileSize - h.stringDataOffset);
+
+	uint32_t i;
+	for (i = 0; i < h.stringCount; i++)
+	{
+		if (strings[i].offset > stringDataSize ||
+			strings[i].length > stringDataSize - strings[i].offset)
+			return false;
+	}
+
+	for (i = 0; i < h.groupCount; i++)
+	{
+		if (groups[i].name >= h.stringCount || groups[i].display > defaultDisplay ||
+			groups[i].firstEquivalence > h.equivalenceCount ||
+			groups[i].equivalenceCount > h.equivalenceCount - groups[i].firstEquivalence)
+			return false;
+	}
+
+	for (i = 0; i < h.equivalenceCount; i++)
+	{
+		const EquivalenceEntry &e(equivalences[i]);
+		if (e.aUnit >= h.stringCount || e.bUnit >= h.stringCount ||
+			e.equation >= h.stringCount ||
+			(e.aSolution != noString && e.aSolution >= h.stringCount) ||
+			(e.bSolution != noString && e.bSolution >= h.stringCount) ||
+			(e.flags & ~pathEdgeFlag) != 0)
+			return false;
+	}
+
+	header = &h;
+	stringTable = strings;
+	groupTable = groups;
+	equivalenceTable = equivalences;
+	stringData = data + h.stringDataOffset;
+
+	return true;
+}
+
+//==========================================================================
+// Class:			CatalogCache::Text
+// Function:		ToString
+//
+// Description:		Converts the text to a wxString.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString
+//
+//==========================================================================
+wxString CatalogCache::Text::ToString() const
+{
+	return wxString::FromUTF8(data, length);
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		GetString
+//
+// Description:		Returns the specified entry from the string table.
+//
+// Input Arguments:
+//		i	= const uint32_t& (may be noString)
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		Text
+//
+//==========================================================================
+CatalogCache::Text CatalogCache::GetString(const uint32_t &i) const
+{
+	Text text;
+	if (i == noString)
+	{
+		text.data = stringData;
+		text.length = 0;
+	}
+	else
+	{
+		text.data = stringData + stringTable[i].offset;
+		text.length = stringTable[i].length;
+	}
+
+	return text;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		GetGroupName
+//
+// Description:		Returns the name of the specified group.
+//
+// Input Arguments:
+//		group	= const uint32_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		Text
+//
+//==========================================================================
+CatalogCache::Text CatalogCache::GetGroupName(const uint32_t &group) const
+{
+	return GetString(groupTable[group].name);
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		GetGroup
+//
+// Description:		Copies the specified group out of the mapping.
+//
+// Input Arguments:
+//		group	= const uint32_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		XMLConversionFactors::FactorGroup
+//
+//==========================================================================
+XMLConversionFactors::FactorGroup CatalogCache::GetGroup(const uint32_t &group) const
+{
+	XMLConversionFactors::FactorGroup g;
+	g.name = GetGroupName(group).ToString();
+	g.display = GetGroupDisplay(group);
+	g.displaySet = GetGroupSetsDisplay(group);
+	g.equiv.resize(groupTable[group].equivalenceCount);
+	for (uint32_t i = 0; i < g.equiv.size(); i++)
+	{
+		const EquivalenceEntry &e(equivalenceTable[groupTable[group].firstEquivalence + i]);
+		g.equiv[i].aUnit = GetString(e.aUnit).ToString();
+		g.equiv[i].bUnit = GetString(e.bUnit).ToString();
+		g.equiv[i].equation = GetString(e.equation).ToString();
+		g.equiv[i].aSolution = GetString(e.aSolution).ToString();
+		g.equiv[i].bSolution = GetString(e.bSolution).ToString();
+		g.equiv[i].pathEdge = (e.flags & pathEdgeFlag) != 0;
+	}
+	g.IndexUnits();
+
+	return g;
+}
+
+//==========================================================================
+// Class:			CatalogCache
+// Function:		GetGroups
+//
+// Description:		Copies all groups out of the mapping.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		groups	= std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogCache::GetGroups(std::vector<XMLConversionFactors::FactorGroup> &groups) const
+{
+	groups.resize(header->groupCount);
+	for (uint32_t i = 0; i < header->groupCount; i++)
+		groups[i] = GetGroup(i);
+}
@@ -0,0 +1,137 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogCache.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Compiled (binary) form of the conversion catalog.  The cache is
+//				 keyed by a hash of the XML it was built from and is read through a
+//				 memory mapping, without any parsing or equation solving.
+// History:
+
+#ifndef _CATALOG_CACHE_H_
+#define _CATALOG_CACHE_H_
+
+// Standard C++ headers
+#include <cstdint>
+#include <vector>
+
+// Local headers
+#include "xmlConversionFactors.h"
+#include "mappedFile.h"
+
+class CatalogCache
+{
+public:
+	static uint64_t Hash(const char *data, const size_t &size);
+
+	// Read() fails (and the caller should fall back to the XML) if the cache
+	// is missing, corrupt, from a different version or built from other source
+	static bool Read(const wxString &fileName, const uint64_t &sourceHash,
+		const uint64_t &sourceSize, std::vector<XMLConversionFactors::FactorGroup> &groups);
+	static bool Write(const wxString &fileName, const uint64_t &sourceHash,
+		const uint64_t &sourceSize, const std::vector<XMLConversionFactors::FactorGroup> &groups);
+
+	static const uint32_t version;
+
+	// The cache can also be kept open.  The file is mapped read-only and
+	// shared, so any number of processes can attach to the same cache (or
+	// inherit it across fork()) and share one copy of the catalog; each copies
+	// out only the groups it uses.  Open() checks the header and the tables
+	// (but not the text), so GetGroup() does not need to.
+	bool Open(const wxString &fileName, const uint64_t &sourceHash, const uint64_t &sourceSize);
+	void Close();
+	bool IsOpen() const { return file.IsOpen(); };
+
+	// Points into the mapping; not null-terminated
+	struct Text
+	{
+		const char *data;
+		uint32_t length;
+
+		wxString ToString() const;
+	};
+
+	uint32_t GroupCount() const { return header->groupCount; };
+	Text GetGroupName(const uint32_t &group) const;
+	bool GetGroupDisplay(const uint32_t &group) const { return groupTable[group].display != 0; };
+	bool GetGroupSetsDisplay(const uint32_t &group) const { return groupTable[group].display != defaultDisplay; };
+
+	void GetGroups(std::vector<XMLConversionFactors::FactorGroup> &groups) const;
+	XMLConversionFactors::FactorGroup GetGroup(const uint32_t &group) const;
+
+private:
+	static const char magic[8];
+	static const uint32_t byteOrderMark;
+	static const uint32_t noString;
+	static const uint32_t pathEdgeFlag;
+	static const uint32_t defaultDisplay;
+
+	// All offsets are relative to the start of the file, so the contents
+	// are position-independent
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrderMark;
+		uint64_t sourceHash;
+		uint64_t sourceSize;
+		uint64_t fileSize;
+		uint64_t headerHash;// Of the header, with this field zero
+
+		uint32_t stringCount;
+		uint32_t groupCount;
+		uint32_t equivalenceCount;
+		uint32_t reserved;
+
+		uint64_t stringTableOffset;// StringEntry[stringCount]
+		uint64_t stringDataOffset;// UTF-8 text, not terminated
+		uint64_t groupTableOffset;// GroupEntry[groupCount]
+		uint64_t equivalenceTableOffset;// EquivalenceEntry[equivalenceCount]
+	};
+
+	struct StringEntry
+	{
+		uint32_t offset;// From stringDataOffset
+		uint32_t length;
+	};
+
+	struct GroupEntry
+	{
+		uint32_t name;
+		uint32_t display;// 0, 1 or defaultDisplay (shown, but not set by the catalog)
+		uint32_t firstEquivalence;
+		uint32_t equivalenceCount;
+	};
+
+	struct EquivalenceEntry
+	{
+		uint32_t aUnit;
+		uint32_t bUnit;
+		uint32_t equation;
+		uint32_t aSolution;// Equation solved for a (noString if it could not be solved)
+		uint32_t bSolution;
+		uint32_t flags;
+	};
+
+	static bool SectionIsValid(const Header &header, const uint64_t &offset,
+		const uint64_t &count, const size_t &entrySize);
+
+	MappedFile file;
+	const Header *header = nullptr;
+	const StringEntry *stringTable = nullptr;
+	const GroupEntry *groupTable = nullptr;
+	const EquivalenceEntry *equivalenceTable = nullptr;
+	const char *stringData = nullptr;
+
+	static uint64_t HashHeader(Header header);
+	bool Validate(const uint64_t &sourceHash, const uint64_t &sourceSize);
+	Text GetString(const uint32_t &i) const;
+};
+
+#endif// _CATALOG_CACHE_H_
@@ -0,0 +1,1041 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogFormat.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Readers and writers for the catalog formats other than XML:  JSON
+//				 Lines (one record per line, for diffing and streaming) and a
+//				 columnar binary form.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+// wxWidgets headers
+#include <wx/file.h>
+#include <wx/filename.h>
+
+// Local headers
+#include "catalogFormat.h"
+#include "catalogCache.h"
+#include "editJournal.h"
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CatalogFormat class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const uint32_t CatalogFormat::version(1);
+const char CatalogFormat::magic[8] = { 'C', 'N', 'V', 'C', 'O', 'L', 'M', 'N' };
+const uint32_t CatalogFormat::byteOrderMark(0x01020304);
+const uint8_t CatalogFormat::defaultDisplay(2);
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+//
+// Description:		Parses a single-line JSON object whose members are
+//					strings, numbers, true, false or null.  Nested objects and
+//					arrays are not needed by the catalog and are rejected.
+//
+//==========================================================================
+class CatalogFormat::JSONObject
+{
+public:
+	struct Member
+	{
+		bool isString;
+		std::string value;// UTF-8 for strings, otherwise the literal text
+	};
+
+	wxString Parse(const char *first, const char *last);
+	const Member* Find(const std::string &name) const;
+
+private:
+	std::unordered_map<std::string, Member> members;
+	const char *position;
+	const char *end;
+
+	void SkipWhitespace();
+	wxString ReadString(std::string &s);
+	wxString ReadLiteral(std::string &s);
+	bool ReadHex(uint32_t &c);
+	static void AppendUTF8(const uint32_t &c, std::string &s);
+};
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		Parse
+//
+// Description:		Parses the object, replacing any members already read.
+//
+// Input Arguments:
+//		first	= const char*
+//		last	= const char*, one past the end of the line
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CatalogFormat::JSONObject::Parse(const char *first, const char *last)
+{
+	members.clear();
+	position = first;
+	end = last;
+
+	SkipWhitespace();
+	if (position == end || *position != '{')
+		return _T("Expected '{'");
+	position++;
+	SkipWhitespace();
+
+	if (position != end && *position == '}')
+		position++;
+	else
+	{
+		while (true)
+		{
+			std::string name;
+			Member member;
+			wxString error;
+
+			SkipWhitespace();
+			if (position == end || *position != '"')
+				return _T("Expected a member name");
+			error = ReadString(name);
+			if (!error.IsEmpty())
+				return error;
+
+			SkipWhitespace();
+			if (position == end || *position != ':')
+				return _T("Expected ':'");
+			position++;
+			SkipWhitespace();
+
+			if (position != end && (*position == '{' || *position == '['))
+				return _T("Nested objects and arrays are not supported");
+
+			member.isString = position != end && *position == '"';
+			error = member.isString ? ReadString(member.value) : ReadLiteral(member.value);
+			if (!error.IsEmpty())
+				return error;
+
+			if (!members.insert(std::make_pair(name, member)).second)
+				return _T("Duplicate member '") + wxString::FromUTF8(name.c_str()) + _T("'");
+
+			SkipWhitespace();
+			if (position != end && *position == ',')
+			{
+				position++;
+				continue;
+			}
+
+			if (position != end && *position == '}')
+			{
+				position++;
+				break;
+			}
+
+			return _T("Expected ',' or '}'");
+		}
+	}
+
+	SkipWhitespace();
+	if (position != end)
+		return _T("Unexpected text after the object");
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		Find
+//
+// Description:		Finds the named member.
+//
+// Input Arguments:
+//		name	= const std::string&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const Member*, NULL if not found
+//
+//==========================================================================
+const CatalogFormat::JSONObject::Member* CatalogFormat::JSONObject::Find(const std::string &name) const
+{
+	std::unordered_map<std::string, Member>::const_iterator it(members.find(name));
+	if (it == members.end())
+		return nullptr;
+
+	return &it->second;
+}
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		SkipWhitespace
+//
+// Description:		Advances past any whitespace (including the carriage
+//					return of a CRLF line ending).
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogFormat::JSONObject::SkipWhitespace()
+{
+	while (position != end && (*position == ' ' || *position == '\t' || *position == '\r'))
+		position++;
+}
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		ReadString
+//
+// Description:		Reads a quoted string, replacing escape sequences.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		s	= std::string&, UTF-8
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CatalogFormat::JSONObject::ReadString(std::string &s)
+{
+	s.clear();
+	position++;// Opening quote
+	while (position != end)
+	{
+		const char c(*position++);
+		if (c == '"')
+			return wxEmptyString;
+
+		if (static_cast<unsigned char>(c) < 0x20)
+			return _T("Control character in string");
+
+		if (c != '\\')
+		{
+			s += c;
+			continue;
+		}
+
+		if (position == end)
+			break;
+
+		uint32_t code;
+		switch (*position++)
+		{
+		case '"':
+			s += '"';
+			break;
+
+		case '\\':
+			s += '\\';
+			break;
+
+		case '/':
+			s += '/';
+			break;
+
+		case 'b':
+			s += '\b';
+			break;
+
+		case 'f':
+			s += '\f';
+			break;
+
+		case 'n':
+			s += '\n';
+			break;
+
+		case 'r':
+			s += '\r';
+			break;
+
+		case 't':
+			s += '\t';
+			break;
+
+		case 'u':
+			if (!ReadHex(code) || (code >= 0xDC00 && code <= 0xDFFF))
+				return _T("Invalid \\u escape");
+
+			// Characters beyond the basic plane are written as surrogate pairs
+			if (code >= 0xD800 && code <= 0xDBFF)
+			{
+				uint32_t low;
+				if (end - position < 2 || position[0] != '\\' || position[1] != 'u')
+					return _T("Invalid \\u escape");
+				position += 2;
+				if (!ReadHex(low) || low < 0xDC00 || low > 0xDFFF)
+					return _T("Invalid \\u escape");
+				code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+			}
+
+			AppendUTF8(code, s);
+			break;
+
+		default:
+			return _T("Invalid escape sequence in string");
+		}
+	}
+
+	return _T("Unterminated string");
+}
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		ReadLiteral
+//
+// Description:		Reads a number, true, false or null.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		s	= std::string&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CatalogFormat::JSONObject::ReadLiteral(std::string &s)
+{
+	const char *first(position);
+	while (position != end && *position != ',' && *position != '}' &&
+		*position != ' ' && *position != '\t' && *position != '\r')
+		position++;
+	s.assign(first, position);
+
+	if (s == "true" || s == "false" || s == "null")
+		return wxEmptyString;
+
+	if (!s.empty() && (s[0] == '-' || isdigit(static_cast<unsigned char>(s[0]))) &&
+		std::all_of(s.begin(), s.end(), [](const char &c)
+	{
+		return isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+' ||
+			c == '.' || c == 'e' || c == 'E';
+	}))
+		return wxEmptyString;
+
+	return _T("Expected a value");
+}
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		ReadHex
+//
+// Description:		Reads the four hexadecimal digits of a \u escape.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		c	= uint32_t&
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool CatalogFormat::JSONObject::ReadHex(uint32_t &c)
+{
+	if (end - position < 4)
+		return false;
+
+	c = 0;
+	for (unsigned int i = 0; i < 4; i++, position++)
+	{
+		const char digit(static_cast<char>(tolower(static_cast<unsigned char>(*position))));
+		if (digit >= '0' && digit <= '9')
+			c = c * 16 + (digit - '0');
+		else if (digit >= 'a' && digit <= 'f')
+			c = c * 16 + (digit - 'a' + 10);
+		else
+			return false;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			CatalogFormat::JSONObject
+// Function:		AppendUTF8
+//
+// Description:		Appends the UTF-8 encoding of a code point.
+//
+// Input Arguments:
+//		c	= const uint32_t&
+//
+// Output Arguments:
+//		s	= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogFormat::JSONObject::AppendUTF8(const uint32_t &c, std::string &s)
+{
+	if (c < 0x80)
+		s += static_cast<char>(c);
+	else if (c < 0x800)
+	{
+		s += static_cast<char>(0xC0 | (c >> 6));
+		s += static_cast<char>(0x80 | (c & 0x3F));
+	}
+	else if (c < 0x10000)
+	{
+		s += static_cast<char>(0xE0 | (c >> 12));
+		s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		s += static_cast<char>(0x80 | (c & 0x3F));
+	}
+	else
+	{
+		s += static_cast<char>(0xF0 | (c >> 18));
+		s += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+		s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		s += static_cast<char>(0x80 | (c & 0x3F));
+	}
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		FromFileName
+//
+// Description:		Determines a catalog's format from its extension.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		Type
+//
+//==========================================================================
+CatalogFormat::Type CatalogFormat::FromFileName(const wxString &fileName)
+{
+	const wxString extension(wxFileName(fileName).GetExt().Lower());
+	if (extension.Cmp(_T("jsonl")) == 0 || extension.Cmp(_T("ndjson")) == 0)
+		return typeJSONLines;
+	else if (extension.Cmp(_T("ccol")) == 0)
+		return typeColumnar;
+
+	return typeXML;
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		Read
+//
+// Description:		Reads a catalog in the specified (non-XML) format.
+//
+// Input Arguments:
+//		type				= const Type&
+//		data				= const char*
+//		size				= const size_t&
+//		allowEmptyGroups	= const bool&
+//
+// Output Arguments:
+//		groups	= std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CatalogFormat::Read(const Type &type, const char *data, const size_t &size,
+	const bool &allowEmptyGroups, std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	assert(type != typeXML);
+
+	groups.clear();
+	const wxString error(type == typeJSONLines ?
+		ReadJSONLines(data, size, groups) : ReadColumnar(data, size, groups));
+	if (!error.IsEmpty())
+	{
+		groups.clear();
+		return error;
+	}
+
+	for (auto &group : groups)
+	{
+		if (group.equiv.empty() && !allowEmptyGroups)
+		{
+			const wxString name(group.name);
+			groups.clear();
+			return _T("Group '") + name + _T("' has no equivalence definitions");
+		}
+
+		group.IndexUnits();
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		Write
+//
+// Description:		Writes the groups in the specified (non-XML) format.
+//
+// Input Arguments:
+//		type	= const Type&
+//		groups	= const std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string CatalogFormat::Write(const Type &type,
+	const std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	assert(type != typeXML);
+
+	if (type == typeJSONLines)
+		return WriteJSONLines(groups);
+	return WriteColumnar(groups);
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		Save
+//
+// Description:		Writes the groups to the specified file, in the format
+//					given by its extension, and flushes it to disk.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		groups		= const std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool CatalogFormat::Save(const wxString &fileName,
+	const std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	const std::string contents(Write(FromFileName(fileName), groups));
+
+	wxFile file;
+	if (!file.Create(fileName, true))
+		return false;
+
+	const bool written(file.Write(contents.data(), contents.size()) == contents.size());
+	file.Close();
+
+	return written && EditJournal::Sync(fileName);
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		ReadJSONLines
+//
+// Description:		Reads a JSON Lines catalog.  Errors give the line number.
+//
+// Input Arguments:
+//		data	= const char*
+//		size	= const size_t&
+//
+// Output Arguments:
+//		groups	= std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CatalogFormat::ReadJSONLines(const char *data, const size_t &size,
+	std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	const char *position(data), *end(data + size);
+	if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+		position += 3;// Byte order mark
+
+	unsigned int line(0);
+	auto fail = [&line](const wxString &message)
+	{
+		return message + wxString::Format(_T(" (line %u)"), line);
+	};
+
+	JSONObject object;
+	while (position < end)
+	{
+		line++;
+		const char *first(position);
+		const char *last(static_cast<const char*>(memchr(position, '\n', end - position)));
+		if (!last)
+			last = end;
+		position = last == end ? end : last + 1;
+
+		if (std::all_of(first, last, [](const char &c)
+		{
+			return isspace(static_cast<unsigned char>(c)) != 0;
+		}))
+			continue;
+
+		const wxString error(object.Parse(first, last));
+		if (!error.IsEmpty())
+			return fail(error);
+
+		const JSONObject::Member *name(object.Find("group"));
+		if (name)
+		{
+			if (!name->isString)
+				return fail(_T("'group' must be a string"));
+
+			XMLConversionFactors::FactorGroup group;
+			group.name = wxString::FromUTF8(name->value.c_str(), name->value.size());
+			group.display = true;
+
+			const JSONObject::Member *display(object.Find("display"));
+			if (display)
+			{
+				if (display->isString || (display->value != "true" && display->value != "false"))
+					return fail(_T("'display' must be true or false"));
+				group.display = display->value == "true";
+			}
+			group.displaySet = display != nullptr;
+
+			groups.push_back(std::move(group));
+			continue;
+		}
+
+		if (groups.empty())
+			return fail(_T("Equivalence before the first group"));
+
+		XMLConversionFactors::Equivalence equiv;
+		const std::pair<const char*, wxString*> fields[] = {
+			std::make_pair("a", &equiv.aUnit),
+			std::make_pair("b", &equiv.bUnit),
+			std::make_pair("relation", &equiv.equation) };
+		for (const auto &field : fields)
+		{
+			const JSONObject::Member *member(object.Find(field.first));
+			if (!member || !member->isString)
+				return fail(_T("Cannot read '") + wxString::FromUTF8(field.first) + _T("' for equivalence"));
+			*field.second = wxString::FromUTF8(member->value.c_str(), member->value.size());
+		}
+
+		const wxString invalid(XMLConversionFactors::CheckEquivalence(equiv));
+		if (!invalid.IsEmpty())
+			return fail(invalid);
+
+		groups.back().equiv.push_back(std::move(equiv));
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			None
+// Function:		AppendJSONString
+//
+// Description:		Appends the string as a quoted JSON string.  Characters
+//					other than quotes, backslashes and control characters are
+//					written as UTF-8.
+//
+// Input Arguments:
+//		s	= const wxString&
+//
+// Output Arguments:
+//		out	= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static void AppendJSONString(const wxString &s, std::string &out)
+{
+	const std::string utf8(s.utf8_str());
+	out += '"';
+	for (const char &c : utf8)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char escape[8];
+			snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned int>(c));
+			out += escape;
+		}
+		else
+			out += c;
+	}
+	out += '"';
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		WriteJSONLines
+//
+// Description:		Writes a JSON Lines catalog.
+//
+// Input Arguments:
+//		groups	= const std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string CatalogFormat::WriteJSONLines(const std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	std::string out;
+	for (const auto &group : groups)
+	{
+		out += "{\"group\":";
+		AppendJSONString(group.name, out);
+		if (!group.displaySet)
+			out += "}\n";
+		else
+			out += group.display ? ",\"display\":true}\n" : ",\"display\":false}\n";
+
+		for (const auto &equiv : group.equiv)
+		{
+			out += "{\"a\":";
+			AppendJSONString(equiv.aUnit, out);
+			out += ",\"b\":";
+			AppendJSONString(equiv.bUnit, out);
+			out += ",\"relation\":";
+			AppendJSONString(equiv.equation, out);
+			out += "}\n";
+		}
+	}
+
+	return out;
+}
+
+//==========================================================================
+// Class:			None
+// Function:		Align
+//
+// Description:		Rounds the offset up to a multiple of eight bytes.
+//
+// Input Arguments:
+//		offset	= const uint64_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		uint64_t
+//
+//==========================================================================
+static uint64_t Align(const uint64_t &offset)
+{
+	return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+//==========================================================================
+// Class:			None
+// Function:		Intern
+//
+// Description:		Returns the index of the string in the string list,
+//					adding it if necessary.
+//
+// Input Arguments:
+//		s		= const wxString&
+//
+// Output Arguments:
+//		strings	= std::vector<std::string>&, UTF-8
+//		ids		= std::unordered_map<std::string, uint32_t>&
+//
+// Return Value:
+//		uint32_t
+//
+//==========================================================================
+static uint32_t Intern(const wxString &s, std::vector<std::string> &strings,
+	std::unordered_map<std::string, uint32_t> &ids)
+{
+	std::string utf8(s.utf8_str());
+	std::unordered_map<std::string, uint32_t>::const_iterator it(ids.find(utf8));
+	if (it != ids.end())
+		return it->second;
+
+	const uint32_t id(static_cast<uint32_t>(strings.size()));
+	ids.insert(std::make_pair(utf8, id));
+	strings.push_back(std::move(utf8));
+	return id;
+}
+
+//==========================================================================
+// Class:			None
+// Function:		ReadColumn
+//
+// Description:		Copies an array out of the file (which need not be
+//					aligned in memory).
+//
+// Input Arguments:
+//		data	= const char*, start of the array
+//		count	= const uint64_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::vector<T>
+//
+//==========================================================================
+template <typename T>
+static std::vector<T> ReadColumn(const char *data, const uint64_t &count)
+{
+	std::vector<T> column(static_cast<size_t>(count));
+	if (!column.empty())
+		memcpy(column.data(), data, column.size() * sizeof(T));
+	return column;
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		ColumnarSize
+//
+// Description:		Computes the offset of each section of a columnar catalog
+//					and the size of the file.
+//
+// Input Arguments:
+//		header	= const Header&
+//
+// Output Arguments:
+//		sectionOffsets	= std::vector<uint64_t>&, indexed by Section
+//
+// Return Value:
+//		uint64_t
+//
+//==========================================================================
+uint64_t CatalogFormat::ColumnarSize(const Header &header, std::vector<uint64_t> &sectionOffsets)
+{
+	const uint64_t sectionSizes[] = {
+		(static_cast<uint64_t>(header.stringCount) + 1) * sizeof(uint32_t),
+		static_cast<uint64_t>(header.groupCount) * sizeof(uint32_t),
+		static_cast<uint64_t>(header.groupCount) * sizeof(uint32_t),
+		static_cast<uint64_t>(header.groupCount) * sizeof(uint8_t),
+		static_cast<uint64_t>(header.equivalenceCount) * sizeof(uint32_t),
+		static_cast<uint64_t>(header.equivalenceCount) * sizeof(uint32_t),
+		static_cast<uint64_t>(header.equivalenceCount) * sizeof(uint32_t),
+		header.stringDataSize };
+
+	sectionOffsets.clear();
+	uint64_t offset(sizeof(Header));
+	for (const auto &size : sectionSizes)
+	{
+		offset = Align(offset);
+		sectionOffsets.push_back(offset);
+		offset += size;
+	}
+
+	return offset;
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		ReadColumnar
+//
+// Description:		Reads a columnar catalog.  Every offset and index is
+//					checked before it is used.
+//
+// Input Arguments:
+//		data	= const char*
+//		size	= const size_t&
+//
+// Output Arguments:
+//		groups	= std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CatalogFormat::ReadColumnar(const char *data, const size_t &size,
+	std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	Header header;
+	if (size < sizeof(header))
+		return _T("Columnar catalog is truncated");
+	memcpy(&header, data, sizeof(header));
+
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0)
+		return _T("Not a columnar catalog");
+	if (header.byteOrderMark != byteOrderMark)
+		return _T("Columnar catalog was written with a different byte order");
+	if (header.version != version)
+		return wxString::Format(_T("Columnar catalog version %u is not supported (expected %u)"),
+			header.version, version);
+
+	std::vector<uint64_t> sections;
+	if (ColumnarSize(header, sections) != size)
+		return _T("Columnar catalog is truncated");
+	if (CatalogCache::Hash(data + sizeof(header), size - sizeof(header)) != header.contentHash)
+		return _T("Columnar catalog is corrupt");
+
+	const std::vector<uint32_t> stringOffsets(ReadColumn<uint32_t>(
+		data + sections[sectionStringOffsets], static_cast<uint64_t>(header.stringCount) + 1));
+	const std::vector<uint32_t> groupNames(ReadColumn<uint32_t>(data + sections[sectionGroupNames], header.groupCount));
+	const std::vector<uint32_t> groupEnds(ReadColumn<uint32_t>(data + sections[sectionGroupEnds], header.groupCount));
+	const std::vector<uint8_t> groupDisplay(ReadColumn<uint8_t>(data + sections[sectionGroupDisplay], header.groupCount));
+	const std::vector<uint32_t> aUnits(ReadColumn<uint32_t>(data + sections[sectionAUnits], header.equivalenceCount));
+	const std::vector<uint32_t> bUnits(ReadColumn<uint32_t>(data + sections[sectionBUnits], header.equivalenceCount));
+	const std::vector<uint32_t> relations(ReadColumn<uint32_t>(data + sections[sectionRelations], header.equivalenceCount));
+
+	auto validIds = [&header](const std::vector<uint32_t> &ids)
+	{
+		return std::all_of(ids.begin(), ids.end(), [&header](const uint32_t &id)
+		{
+			return id < header.stringCount;
+		});
+	};
+
+	if (stringOffsets.front() != 0 || stringOffsets.back() != header.stringDataSize ||
+		!std::is_sorted(stringOffsets.begin(), stringOffsets.end()) ||
+		!std::is_sorted(groupEnds.begin(), groupEnds.end()) ||
+		(groupEnds.empty() ? header.equivalenceCount != 0 : groupEnds.back() != header.equivalenceCount) ||
+		!validIds(groupNames) || !validIds(aUnits) || !validIds(bUnits) || !validIds(relations))
+		return _T("Columnar catalog is corrupt");
+
+	// Each string is converted once
+	std::vector<wxString> strings(header.stringCount);
+	const char *stringData(data + sections[sectionStringData]);
+	for (uint32_t i = 0; i < header.stringCount; i++)
+		strings[i] = wxString::FromUTF8(stringData + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]);
+
+	groups.resize(header.groupCount);
+	uint32_t equivalence(0);
+	for (uint32_t i = 0; i < header.groupCount; i++)
+	{
+		groups[i].name = strings[groupNames[i]];
+		groups[i].display = groupDisplay[i] != 0;
+		groups[i].displaySet = groupDisplay[i] != defaultDisplay;
+		groups[i].equiv.resize(groupEnds[i] - equivalence);
+		for (auto &equiv : groups[i].equiv)
+		{
+			equiv.aUnit = strings[aUnits[equivalence]];
+			equiv.bUnit = strings[bUnits[equivalence]];
+			equiv.equation = strings[relations[equivalence]];
+			equivalence++;
+
+			const wxString error(XMLConversionFactors::CheckEquivalence(equiv));
+			if (!error.IsEmpty())
+				return error + _T(" in group '") + groups[i].name + _T("'");
+		}
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CatalogFormat
+// Function:		WriteColumnar
+//
+// Description:		Writes a columnar catalog.
+//
+// Input Arguments:
+//		groups	= const std::vector<XMLConversionFactors::FactorGroup>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string CatalogFormat::WriteColumnar(const std::vector<XMLConversionFactors::FactorGroup> &groups)
+{
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, uint32_t> ids;
+	std::vector<uint32_t> groupNames, groupEnds, aUnits, bUnits, relations;
+	std::vector<uint8_t> groupDisplay;
+
+	for (const auto &group : groups)
+	{
+		groupNames.push_back(Intern(group.name, strings, ids));
+		groupDisplay.push_back(!group.displaySet ? defaultDisplay : group.display ? 1 : 0);
+		for (const auto &equiv : group.equiv)
+		{
+			aUnits.push_back(Intern(equiv.aUnit, strings, ids));
+			bUnits.push_back(Intern(equiv.bUnit, strings, ids));
+			relations.push_back(Intern(equiv.equation, strings, ids));
+		}
+		groupEnds.push_back(static_cast<uint32_t>(aUnits.size()));
+	}
+
+	std::vector<uint32_t> stringOffsets(1, 0);
+	for (const auto &s : strings)
+		stringOffsets.push_back(stringOffsets.back() + static_cast<uint32_t>(s.size()));
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.byteOrderMark = byteOrderMark;
+	header.stringCount = static_cast<uint32_t>(strings.size());
+	header.groupCount = static_cast<uint32_t>(groups.size());
+	header.equivalenceCount = static_cast<uint32_t>(aUnits.size());
+	header.stringDataSize = stringOffsets.back();
+
+	std::vector<uint64_t> sections;
+	std::string buffer(static_cast<size_t>(ColumnarSize(header, sections)), '\0');
+	auto copy = [&buffer, &sections](const Section &section, const void *source, const size_t &size)
+	{
+		if (size > 0)
+			memcpy(&buffer[sections[section]], source, size);
+	};
+
+	copy(sectionStringOffsets, stringOffsets.data(), stringOffsets.size() * sizeof(uint32_t));
+	copy(sectionGroupNames, groupNames.data(), groupNames.size() * sizeof(uint32_t));
+	copy(sectionGroupEnds, groupEnds.data(), groupEnds.size() * sizeof(uint32_t));
+	copy(sectionGroupDisplay, groupDisplay.data(), groupDisplay.size() * sizeof(uint8_t));
+	copy(sectionAUnits, aUnits.data(), aUnits.size() * sizeof(uint32_t));
+	copy(sectionBUnits, bUnits.data(), bUnits.size() * sizeof(uint32_t));
+	copy(sectionRelations, relations.data(), relations.size() * sizeof(uint32_t));
+	for (size_t i = 0; i < strings.size(); i++)
+		memcpy(&buffer[sections[sectionStringData] + stringOffsets[i]], strings[i].data(), strings[i].size());
+
+	header.contentHash = CatalogCache::Hash(buffer.data() + sizeof(header), buffer.size() - sizeof(header));
+	memcpy(&buffer[0], &header, sizeof(header));
+
+	return buffer;
+}
@@ -0,0 +1,112 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogFormat.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Readers and writers for the catalog formats other than XML:  JSON
+//				 Lines (one record per line, for diffing and streaming) and a
+//				 columnar binary form.
+// History:
+
+#ifndef _CATALOG_FORMAT_H_
+#define _CATALOG_FORMAT_H_
+
+// Standard C++ headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Local headers
+#include "xmlConversionFactors.h"
+
+class CatalogFormat
+{
+public:
+	enum Type
+	{
+		typeXML,
+		typeJSONLines,
+		typeColumnar
+	};
+
+	// By extension:  .jsonl (or .ndjson) for JSON Lines, .ccol for columnar
+	// and anything else for XML
+	static Type FromFileName(const wxString &fileName);
+
+	// JSON Lines catalogs hold one object per line.  A group line starts a
+	// group, and the equivalence lines after it belong to it:
+	//   {"group":"Distance","display":true}
+	//   {"a":"inch","b":"foot","relation":"a=b*12"}
+	// Display defaults to true (in an overlay, to the display of the group
+	// beneath); other members are ignored.  Blank lines are skipped.
+	//
+	// Readers fill in each group's names, display flag and equivalences
+	// (indexed, but not solved).  They return an error message (empty on
+	// success).  Writers leave out the solutions.
+	static wxString Read(const Type &type, const char *data, const size_t &size,
+		const bool &allowEmptyGroups, std::vector<XMLConversionFactors::FactorGroup> &groups);
+	static std::string Write(const Type &type, const std::vector<XMLConversionFactors::FactorGroup> &groups);
+
+	// Writes the groups in the format given by the file name (which must not
+	// be XML) and flushes the file to disk
+	static bool Save(const wxString &fileName, const std::vector<XMLConversionFactors::FactorGroup> &groups);
+
+	static const uint32_t version;// Of the columnar form
+
+private:
+	static const char magic[8];
+	static const uint32_t byteOrderMark;
+	static const uint8_t defaultDisplay;// Shown, but not set by the catalog
+
+	static wxString ReadJSONLines(const char *data, const size_t &size,
+		std::vector<XMLConversionFactors::FactorGroup> &groups);
+	static std::string WriteJSONLines(const std::vector<XMLConversionFactors::FactorGroup> &groups);
+
+	class JSONObject;
+
+	// The columnar form is a header followed by one array per field (each
+	// aligned to eight bytes):  the string offsets (stringCount + 1, into
+	// the string data), the group names, the ends of each group's
+	// equivalences, the group display flags (one byte each:  0, 1, or 2 if
+	// not set), the a units, the b units and the relations.  Names and
+	// relations are indices of strings, which are stored once each as UTF-8.
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrderMark;
+		uint32_t stringCount;
+		uint32_t groupCount;
+		uint32_t equivalenceCount;
+		uint32_t stringDataSize;
+		uint64_t contentHash;// Of everything after the header
+	};
+
+	enum Section
+	{
+		sectionStringOffsets,
+		sectionGroupNames,
+		sectionGroupEnds,
+		sectionGroupDisplay,
+		sectionAUnits,
+		sectionBUnits,
+		sectionRelations,
+		sectionStringData
+	};
+
+	static wxString ReadColumnar(const char *data, const size_t &size,
+		std::vector<XMLConversionFactors::FactorGroup> &groups);
+	static std::string WriteColumnar(const std::vector<XMLConversionFactors::FactorGroup> &groups);
+	static uint64_t ColumnarSize(const Header &header, std::vector<uint64_t> &sectionOffsets);
+};
+
+#endif// _CATALOG_FORMAT_H_
@@ -0,0 +1,324 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogImport.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Imports equivalences in bulk from comma or tab separated files.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Local headers
+#include "catalogImport.h"
+#include "mappedFile.h"
+#include "expressionTree.h"
+#include "compiledConversion.h"
+#include "parallel.h"
+
+//==========================================================================
+// Class:			CatalogImport
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CatalogImport class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const unsigned int CatalogImport::fieldCount(4);
+const unsigned int CatalogImport::maxReported(10);
+
+//==========================================================================
+// Class:			CatalogImport
+// Function:		Import
+//
+// Description:		Reads the file in one pass through a memory mapping,
+//					checks the relations in parallel and adds the rows to the
+//					catalog as one batch.
+//
+// Input Arguments:
+//		catalog		= LayeredCatalog&
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		warnings	= wxString&, from checking the changed groups
+//
+// Return Value:
+//		wxString, error message (empty for success)
+//
+//==========================================================================
+wxString CatalogImport::Import(LayeredCatalog &catalog, const wxString &fileName, wxString &warnings)
+{
+	warnings.Clear();
+
+	MappedFile file;
+	if (!file.Open(fileName))
+		return _T("Cannot open '") + fileName + _T("'");
+
+	std::vector<Entry> entries;
+	std::vector<unsigned int> lines;
+	wxString error(ReadRows(file.GetData(), file.GetSize(), entries, lines));
+	file.Close();
+
+	if (error.IsEmpty() && entries.empty())
+		error = _T("No rows found");
+	if (error.IsEmpty())
+		error = CheckRows(entries, lines);
+	if (!error.IsEmpty())
+		return _T("Cannot import '") + fileName + _T("':\n") + error;
+
+	try
+	{
+		warnings = catalog.AddEquivalences(entries);
+	}
+	catch (std::exception &e)
+	{
+		return _T("Cannot import '") + fileName + _T("':\n") + wxString(e.what(), wxConvUTF8);
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CatalogImport
+// Function:		ReadRows
+//
+// Description:		Splits the data into rows.  Blank lines are skipped.
+//
+// Input Arguments:
+//		data	= const char*, UTF-8
+//		size	= const size_t&
+//
+// Output Arguments:
+//		entries	= std::vector<Entry>&
+//		lines	= std::vector<unsigned int>&, line on which each row starts
+//
+// Return Value:
+//		wxString, error message (empty for success)
+//
+//==========================================================================
+wxString CatalogImport::ReadRows(const char *data, const size_t &size,
+	std::vector<Entry> &entries, std::vector<unsigned int> &lines)
+{
+	const char *position(data);
+	const char *end(data + size);
+	if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)// Byte order mark
+		position += 3;
+
+	const char *firstLineEnd(std::find(position, end, '\n'));
+	const char delimiter(std::find(position, firstLineEnd, '\t') != firstLineEnd ? '\t' : ',');
+
+	unsigned int line(1);
+	bool firstRow(true);
+	std::vector<std::string> fields;
+	while (position < end)
+	{
+		const unsigned int rowLine(line);
+		bool endOfRow(false);
+		fields.clear();
+		while (!endOfRow)
+		{
+			fields.push_back(std::string());
+			if (!ReadField(position, end, delimiter, line, fields.back(), endOfRow))
+				return wxString::Format(_T("Line %u:  Quoted field is not terminated"), rowLine);
+		}
+
+		if (fields.size() == 1 && fields.front().empty())
+			continue;
+
+		if (fields.size() != fieldCount)
+			return wxString::Format(_T("Line %u:  Expected %u fields (group, unit, equivalent unit, relation) but found %u"),
+				rowLine, fieldCount, static_cast<unsigned int>(fields.size()));
+
+		const bool header(firstRow && wxString::FromUTF8(fields[0].c_str()).CmpNoCase(_T("group")) == 0);
+		firstRow = false;
+		if (header)
+			continue;
+
+		Entry entry;
+		entry.first = wxString::FromUTF8(fields[0].c_str());
+		entry.second.aUnit = wxString::FromUTF8(fields[1].c_str());
+		entry.second.bUnit = wxString::FromUTF8(fields[2].c_str());
+		entry.second.equation = wxString::FromUTF8(fields[3].c_str());
+		entries.push_back(entry);
+		lines.push_back(rowLine);
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CatalogImport
+// Function:		ReadField
+//
+// Description:		Reads one field and the delimiter or line break after it.
+//					Spaces around unquoted fields are removed.  Quotes are
+//					only special at the start of a comma separated field;
+//					anything between the closing quote and the delimiter is
+//					ignored.
+//
+// Input Arguments:
+//		position	= const char*&
+//		end			= const char*
+//		delimiter	= const char&
+//		line		= unsigned int&
+//
+// Output Arguments:
+//		position	= const char*&, start of the next field
+//		line		= unsigned int&, line of the next field
+//		field		= std::string&
+//		endOfRow	= bool&, true if this was the last field in the row
+//
+// Return Value:
+//		bool, false if a quoted field is not terminated
+//
+//==========================================================================
+bool CatalogImport::ReadField(const char *&position, const char *end, const char &delimiter,
+	unsigned int &line, std::string &field, bool &endOfRow)
+{
+	while (position < end && *position == ' ')
+		++position;
+
+	const bool quoted(delimiter == ',' && position < end && *position == '"');
+	if (quoted)
+	{
+		for (++position; ; ++position)
+		{
+			if (position == end)
+				return false;
+			else if (*position == '"' && position + 1 < end && position[1] == '"')
+				++position;
+			else if (*position == '"')
+				break;
+			else if (*position == '\n')
+				++line;
+
+			field += *position;
+		}
+		++position;
+	}
+
+	const char *fieldEnd(position);
+	while (fieldEnd < end && *fieldEnd != delimiter && *fieldEnd != '\n')
+		++fieldEnd;
+
+	if (!quoted)
+	{
+		const char *last(fieldEnd);
+		while (last > position && (last[-1] == ' ' || last[-1] == '\r'))
+			--last;
+		field.assign(position, last);
+	}
+
+	endOfRow = fieldEnd == end || *fieldEnd == '\n';
+	position = fieldEnd;
+	if (position < end)
+	{
+		if (*position == '\n')
+			++line;
+		++position;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			CatalogImport
+// Function:		CheckRows
+//
+// Description:		Checks each row, in parallel.
+//
+// Input Arguments:
+//		lines	= const std::vector<unsigned int>&
+//
+// Output Arguments:
+//		entries	= std::vector<Entry>&, solved
+//
+// Return Value:
+//		wxString, the first few errors (empty if there are none)
+//
+//==========================================================================
+wxString CatalogImport::CheckRows(std::vector<Entry> &entries, const std::vector<unsigned int> &lines)
+{
+	std::vector<wxString> errors(entries.size());
+	Parallel::For(entries.size(), [&entries, &errors](const size_t &i)
+	{
+		errors[i] = CheckRow(entries[i]);
+	});
+
+	unsigned int count(0);
+	wxString report;
+	for (size_t i = 0; i < errors.size(); i++)
+	{
+		if (errors[i].IsEmpty())
+			continue;
+
+		if (count < maxReported)
+			report += (count == 0 ? wxString() : wxString(_T("\n")))
+				+ wxString::Format(_T("Line %u:  "), lines[i]) + errors[i];
+		count++;
+	}
+
+	if (count > maxReported)
+		report += wxString::Format(_T("\n(%u more rows are invalid)"), count - maxReported);
+
+	return report;
+}
+
+//==========================================================================
+// Class:			CatalogImport
+// Function:		CheckRow
+//
+// Description:		Checks the names in a row and that its relation can be
+//					solved (and compiled) for each unit.  The solutions are
+//					kept, so the catalog need not find them again.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		entry	= Entry&
+//
+// Return Value:
+//		wxString, error message (empty if the row is valid)
+//
+//==========================================================================
+wxString CatalogImport::CheckRow(Entry &entry)
+{
+	XMLConversionFactors::Equivalence &e(entry.second);
+	if (entry.first.IsEmpty() || e.aUnit.IsEmpty() || e.bUnit.IsEmpty())
+		return _T("Group and unit names cannot be empty");
+
+	if (e.aUnit.Cmp(e.bUnit) == 0)
+		return _T("Unit names must be unique");
+
+	ExpressionTree tree;
+	CompiledConversion check;
+	wxString error(tree.SolveForString(e.equation, _T("a"), e.aSolution));
+	if (error.IsEmpty())
+		error = check.Compile(e.aSolution, _T("b"));
+	if (error.IsEmpty())
+		error = tree.SolveForString(e.equation, _T("b"), e.bSolution);
+	if (error.IsEmpty())
+		error = check.Compile(e.bSolution, _T("a"));
+
+	if (!error.IsEmpty())
+		return _T("Cannot solve '") + e.equation + _T("':  ") + error;
+
+	return wxEmptyString;
+}
@@ -0,0 +1,58 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogImport.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Imports equivalences in bulk from comma or tab separated files.
+// History:
+
+#ifndef _CATALOG_IMPORT_H_
+#define _CATALOG_IMPORT_H_
+
+// Standard C++ headers
+#include <string>
+#include <utility>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Local headers
+#include "layeredCatalog.h"
+
+class CatalogImport
+{
+public:
+	// Each row gives a group, a unit (a), an equivalent unit (b) and the
+	// relation between them, e.g. "Distance,inch,foot,a=b*12".  Fields are
+	// separated by tabs if the first line contains one, otherwise by commas
+	// (and may be quoted, as in RFC 4180).  A first row naming the columns
+	// (starting with "group") is skipped.  If any row is invalid, nothing is
+	// imported.  Rows are added to the catalog's last layer.  Returns an error message (empty on success).
+	static wxString Import(LayeredCatalog &catalog, const wxString &fileName, wxString &warnings);
+
+	static const unsigned int fieldCount;
+	static const unsigned int maxReported;// Invalid rows
+
+	// Reads one (possibly quoted) field, appending it to field, and moves
+	// past the delimiter or line break after it.  Returns false if a quoted
+	// field is not terminated.
+	static bool ReadField(const char *&position, const char *end, const char &delimiter,
+		unsigned int &line, std::string &field, bool &endOfRow);
+
+private:
+	typedef std::pair<wxString, XMLConversionFactors::Equivalence> Entry;
+
+	static wxString ReadRows(const char *data, const size_t &size,
+		std::vector<Entry> &entries, std::vector<unsigned int> &lines);
+	static wxString CheckRows(std::vector<Entry> &entries, const std::vector<unsigned int> &lines);
+	static wxString CheckRow(Entry &entry);
+};
+
+#endif// _CATALOG_IMPORT_H_
@@ -0,0 +1,356 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogWatcher.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Watches the catalog file (and its journal) for changes made
+//				 outside the application and reloads the catalog in the
+//				 background once the changes stop.
+// History:
+
+// wxWidgets headers
+#include <wx/filename.h>
+
+// Local headers
+#include "catalogWatcher.h"
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CatalogWatcher class.  Editors and tools
+//					often write a file in several steps; the reload waits until
+//					there have been no changes for this long.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const int CatalogWatcher::debounceTime(500);// [msec]
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		CatalogWatcher
+//
+// Description:		Constructor for the CatalogWatcher class.  Watching starts
+//					once the event loop is running (as wxFileSystemWatcher
+//					requires).
+//
+// Input Arguments:
+//		xml			= XMLConversionFactors&
+//		reloaded	= const std::function<void(const std::set<wxString>&)>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+CatalogWatcher::CatalogWatcher(XMLConversionFactors &xml,
+	const std::function<void(const std::set<wxString>&)> &reloaded)
+	: xml(xml), reloaded(reloaded), timer(this), generation(0), paused(false), changed(false)
+{
+	CallAfter(&CatalogWatcher::StartWatching);
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		~CatalogWatcher
+//
+// Description:		Destructor for the CatalogWatcher class.  Waits for any
+//					running reload.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+CatalogWatcher::~CatalogWatcher()
+{
+	timer.Stop();
+	if (reloadThread.joinable())
+		reloadThread.join();
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		Event Table
+//
+// Description:		Links events with event handler functions.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+BEGIN_EVENT_TABLE(CatalogWatcher, wxEvtHandler)
+	EVT_FSWATCHER(wxID_ANY,	CatalogWatcher::OnFileSystemEvent)
+	EVT_TIMER(wxID_ANY,		CatalogWatcher::OnTimer)
+END_EVENT_TABLE();
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		StartWatching
+//
+// Description:		Watches the directory containing the catalog.  Files are
+//					often replaced rather than rewritten (e.g. by renaming a
+//					new copy over them), so the directory is watched rather
+//					than the file itself.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::StartWatching()
+{
+	wxFileName file(xml.GetFileName());
+	file.MakeAbsolute();
+	fileName = file.GetFullName();
+	journalFileName = fileName + _T(".journal");
+
+	watcher = std::make_unique<wxFileSystemWatcher>();
+	watcher->SetOwner(this);
+	if (!watcher->Add(wxFileName::DirName(file.GetPath()), wxFSW_EVENT_CREATE |
+		wxFSW_EVENT_DELETE | wxFSW_EVENT_RENAME | wxFSW_EVENT_MODIFY))
+		watcher.reset();// Changes will only be seen after a restart
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		Pause
+//
+// Description:		Stops reloading (so that the catalog can be edited).
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::Pause()
+{
+	paused = true;
+	generation++;
+	if (timer.IsRunning())
+	{
+		timer.Stop();
+		changed = true;
+	}
+
+	if (reloadThread.joinable())
+	{
+		reloadThread.join();
+		changed = true;
+	}
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		Resume
+//
+// Description:		Resumes reloading, starting with any changes seen while
+//					paused.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::Resume()
+{
+	paused = false;
+	if (changed)
+	{
+		changed = false;
+		timer.StartOnce(debounceTime);
+	}
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		StartReload
+//
+// Description:		Loads the catalog on another thread.  Conversions continue
+//					to use the current catalog, which is only read.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::StartReload()
+{
+	std::shared_ptr<Reload> reload(std::make_shared<Reload>());
+	reload->generation = generation;
+	reload->catalog = std::make_unique<XMLConversionFactors>(xml.GetFileName(), xml.IsLazy(), xml.IsOverlay());
+	reload->catalog->DeferMessages(true);
+	reload->loaded = false;
+
+	reloadThread = std::thread([this, reload]()
+	{
+		reload->loaded = reload->catalog->Load(xml, reload->changedGroups);
+		CallAfter([this, reload]()
+		{
+			FinishReload(reload);
+		});
+	});
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		FinishReload
+//
+// Description:		Publishes a completed reload (on the main thread).  The
+//					catalogs are swapped, which takes constant time.  The
+//					callback is made even if no group changed, since the
+//					groups may have been reordered.
+//
+// Input Arguments:
+//		reload	= const std::shared_ptr<Reload>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::FinishReload(const std::shared_ptr<Reload> &reload)
+{
+	if (reload->generation != generation)
+		return;// Discarded by Pause(), which has already joined the thread
+
+	reloadThread.join();
+	reload->catalog->ShowMessages();
+	if (reload->loaded)
+	{
+		xml.Swap(*reload->catalog);
+		reloaded(reload->changedGroups);
+	}
+
+	if (changed)
+	{
+		changed = false;
+		timer.StartOnce(debounceTime);
+	}
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		IsCatalogFile
+//
+// Description:		Checks whether the path is the catalog or its journal.
+//
+// Input Arguments:
+//		path	= const wxFileName&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool CatalogWatcher::IsCatalogFile(const wxFileName &path) const
+{
+	return path.GetFullName().Cmp(fileName) == 0 ||
+		path.GetFullName().Cmp(journalFileName) == 0;
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		OnFileSystemEvent
+//
+// Description:		Handles changes in the catalog's directory.  Each change
+//					restarts the timer, so a burst of writes causes one reload.
+//
+// Input Arguments:
+//		event	= wxFileSystemWatcherEvent&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::OnFileSystemEvent(wxFileSystemWatcherEvent &event)
+{
+	if (event.IsError() || (!IsCatalogFile(event.GetPath()) &&
+		!(event.GetChangeType() == wxFSW_EVENT_RENAME && IsCatalogFile(event.GetNewPath()))))
+		return;
+
+	if (paused)
+		changed = true;
+	else
+		timer.StartOnce(debounceTime);
+}
+
+//==========================================================================
+// Class:			CatalogWatcher
+// Function:		OnTimer
+//
+// Description:		Starts a reload once the catalog has stopped changing.
+//
+// Input Arguments:
+//		event	= wxTimerEvent&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogWatcher::OnTimer(wxTimerEvent& WXUNUSED(event))
+{
+	if (paused)
+		changed = true;
+	else if (reloadThread.joinable())
+		changed = true;// Reloaded again when the running reload finishes
+	else
+		StartReload();
+}
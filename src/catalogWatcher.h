@@ -0,0 +1,84 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogWatcher.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Watches the catalog file (and its journal) for changes made
+//				 outside the application and reloads the catalog in the
+//				 background once the changes stop.
+// History:
+
+#ifndef _CATALOG_WATCHER_H_
+#define _CATALOG_WATCHER_H_
+
+// Standard C++ headers
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+
+// wxWidgets headers
+#include <wx/wx.h>
+#include <wx/fswatcher.h>
+#include <wx/timer.h>
+
+// Local headers
+#include "xmlConversionFactors.h"
+
+class CatalogWatcher : public wxEvtHandler
+{
+public:
+	// After a reload, the new catalog is swapped into xml (on the main
+	// thread) and reloaded is called with the names of the changed groups
+	// (if any)
+	CatalogWatcher(XMLConversionFactors &xml,
+		const std::function<void(const std::set<wxString>&)> &reloaded);
+	~CatalogWatcher();
+
+	// The catalog must not be edited while a reload is running.  Pause()
+	// waits for any reload to finish and discards it (it may not include the
+	// edits); changes seen while paused are reloaded after Resume().
+	void Pause();
+	void Resume();
+
+	static const int debounceTime;// [msec]
+
+private:
+	XMLConversionFactors &xml;
+	const std::function<void(const std::set<wxString>&)> reloaded;
+
+	wxString fileName, journalFileName;// Without path, for matching events
+	std::unique_ptr<wxFileSystemWatcher> watcher;
+	wxTimer timer;
+
+	struct Reload
+	{
+		unsigned int generation;
+		std::unique_ptr<XMLConversionFactors> catalog;
+		bool loaded;
+		std::set<wxString> changedGroups;
+	};
+
+	std::thread reloadThread;// Joinable until FinishReload() (or Pause())
+	unsigned int generation;// Incremented by Pause() to discard running reloads
+	bool paused;
+	bool changed;// Since the running reload started, or while paused
+
+	void StartWatching();
+	void StartReload();
+	void FinishReload(const std::shared_ptr<Reload> &reload);
+	bool IsCatalogFile(const wxFileName &path) const;
+
+	void OnFileSystemEvent(wxFileSystemWatcherEvent &event);
+	void OnTimer(wxTimerEvent &event);
+
+	DECLARE_EVENT_TABLE();
+};
+
+#endif// _CATALOG_WATCHER_H_
@@ -0,0 +1,394 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  chebyshevApproximation.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Piecewise Chebyshev approximation of a compiled conversion over a
+//				 fixed input range.
+// History:
+
+// Standard C++ headers
+#include <cmath>
+#include <algorithm>
+
+// Local headers
+#include "chebyshevApproximation.h"
+#include "compiledConversion.h"
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		Constant Definitions
+//
+// Description:		Constants for the ChebyshevApproximation class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const unsigned int ChebyshevApproximation::maxDegree(16);
+const unsigned int ChebyshevApproximation::minDegree(2);
+const unsigned int ChebyshevApproximation::maxSegments(4096);
+const unsigned int ChebyshevApproximation::samplesPerSegment(129);
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		Fit
+//
+// Description:		Fits a piecewise Chebyshev series to the conversion over the
+//					specified range.  The range is divided into equal segments
+//					(so the segment for a value can be computed without
+//					searching), and the number of segments and the series
+//					degree are increased until the error measured against the
+//					exact conversion is within tolerance.  The tolerance is
+//					relative for results with magnitude greater than one and
+//					absolute otherwise.
+//
+//					The error is measured, not bounded:  each segment is
+//					sampled on a uniform grid and at the extrema of the first
+//					omitted Chebyshev polynomial (where the truncation error of
+//					a smooth conversion peaks).  Conversions with features
+//					narrower than the grid spacing may exceed the tolerance
+//					between samples.
+//
+// Input Arguments:
+//		conversion	= const CompiledConversion&
+//		minimum		= const double&
+//		maximum		= const double&
+//		tolerance	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if an approximation meeting the tolerance was found
+//
+//==========================================================================
+bool ChebyshevApproximation::Fit(const CompiledConversion &conversion,
+	const double &minimum, const double &maximum, const double &tolerance)
+{
+	coefficients.clear();
+	segmentCount = 0;
+	if (!(maximum > minimum) || !(tolerance > 0.0))
+		return false;
+
+	this->minimum = minimum;
+	this->maximum = maximum;
+
+	const unsigned int stride(maxDegree + 1);
+	for (unsigned int segments = 1; segments <= maxSegments; segments *= 2)
+	{
+		const double width((maximum - minimum) / segments);
+		std::vector<double> fullCoefficients(segments * stride);
+		const std::vector<double> t(GetSamplePoints());
+		const size_t samples(t.size());
+		std::vector<double> x(segments * samples);
+		std::vector<double> exact(x.size());
+
+		unsigned int i;
+		size_t j;
+		for (i = 0; i < segments; i++)
+		{
+			const double start(minimum + i * width);
+			const std::vector<double> c(FitSegment(conversion, start, start + width));
+			std::copy(c.begin(), c.end(), fullCoefficients.begin() + i * stride);
+
+			for (j = 0; j < samples; j++)
+				x[i * samples + j] = start + 0.5 * (t[j] + 1.0) * width;
+		}
+
+		conversion.Evaluate(x.data(), exact.data(), x.size());
+		for (i = 0; i < exact.size(); i++)
+		{
+			// Singularities and domain errors cannot be approximated
+			if (!std::isfinite(exact[i]))
+				return false;
+		}
+
+		for (unsigned int d = minDegree; d <= maxDegree; d++)
+		{
+			// Stops at the first segment out of tolerance
+			double error(0.0);
+			for (i = 0; i < segments && error <= tolerance; i++)
+			{
+				for (j = 0; j < samples; j++)
+					error = std::max(error, Error(EvaluateSeries(&fullCoefficients[i * stride], d, t[j]),
+						exact[i * samples + j]));
+			}
+
+			if (error <= tolerance)
+			{
+				degree = d;
+				segmentCount = segments;
+				scale = segments / (maximum - minimum);
+				maximumError = error;
+
+				coefficients.resize(segments * (d + 1));
+				for (i = 0; i < segments; i++)
+					std::copy(fullCoefficients.begin() + i * stride,
+						fullCoefficients.begin() + i * stride + d + 1,
+						coefficients.begin() + i * (d + 1));
+
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		GetSamplePoints
+//
+// Description:		Returns the points (within a segment) at which the error
+//					is measured:  a uniform grid including the ends, and the
+//					extrema of T(d + 1) for each degree d that may be chosen.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::vector<double> (in the range [-1, 1])
+//
+//==========================================================================
+std::vector<double> ChebyshevApproximation::GetSamplePoints()
+{
+	const double pi(4.0 * atan(1.0));
+	std::vector<double> t;
+	unsigned int j;
+	for (j = 0; j < samplesPerSegment; j++)
+		t.push_back(-1.0 + 2.0 * j / (samplesPerSegment - 1));
+
+	for (unsigned int d = minDegree; d <= maxDegree; d++)
+	{
+		for (j = 1; j <= d; j++)// The ends are already in the grid
+			t.push_back(cos(pi * j / (d + 1)));
+	}
+
+	return t;
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		FitSegment
+//
+// Description:		Computes the Chebyshev interpolant of maximum degree for one
+//					segment from values at the Chebyshev nodes.  Lower-degree
+//					approximations are obtained by truncating the series.
+//
+// Input Arguments:
+//		conversion	= const CompiledConversion&
+//		start		= const double&
+//		end			= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::vector<double> containing maxDegree + 1 coefficients
+//
+//==========================================================================
+std::vector<double> ChebyshevApproximation::FitSegment(const CompiledConversion &conversion,
+	const double &start, const double &end)
+{
+	const unsigned int n(maxDegree + 1);
+	const double pi(4.0 * atan(1.0));
+	const double middle(0.5 * (start + end)), halfWidth(0.5 * (end - start));
+
+	std::vector<double> nodes(n), values(n);
+	unsigned int j, k;
+	for (j = 0; j < n; j++)
+		nodes[j] = middle + halfWidth * cos(pi * (j + 0.5) / n);
+	conversion.Evaluate(nodes.data(), values.data(), n);
+
+	std::vector<double> c(n, 0.0);
+	for (k = 0; k < n; k++)
+	{
+		for (j = 0; j < n; j++)
+			c[k] += values[j] * cos(pi * k * (j + 0.5) / n);
+		c[k] *= 2.0 / n;
+	}
+	c[0] *= 0.5;
+
+	return c;
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		EvaluateSeries
+//
+// Description:		Evaluates a Chebyshev series using Clenshaw's recurrence.
+//
+// Input Arguments:
+//		c		= const double* (degree + 1 coefficients)
+//		degree	= const unsigned int&
+//		t		= const double& (in the range [-1, 1])
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double ChebyshevApproximation::EvaluateSeries(const double *c, const unsigned int &degree, const double &t)
+{
+	double b0, b1(0.0), b2(0.0);
+	for (unsigned int k = degree; k > 0; k--)
+	{
+		b0 = c[k] + 2.0 * t * b1 - b2;
+		b2 = b1;
+		b1 = b0;
+	}
+
+	return c[0] + t * b1 - b2;
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		Error
+//
+// Description:		Computes the error metric used for the tolerance check.
+//
+// Input Arguments:
+//		approximate	= const double&
+//		exact		= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double ChebyshevApproximation::Error(const double &approximate, const double &exact)
+{
+	return fabs(approximate - exact) / std::max(1.0, fabs(exact));
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		GetSegment
+//
+// Description:		Computes the segment containing the value and the position
+//					of the value within the segment.  Values outside of the fit
+//					range are assigned to the nearest segment (extrapolated),
+//					and NaN to the first, so the segment is always valid (the
+//					result for such values is meaningless).
+//
+// Input Arguments:
+//		value	= const double&
+//
+// Output Arguments:
+//		t		= double& (position within segment, nominally [-1, 1])
+//
+// Return Value:
+//		unsigned int
+//
+//==========================================================================
+unsigned int ChebyshevApproximation::GetSegment(const double &value, double &t) const
+{
+	const double position((value - minimum) * scale);
+
+	// Written so that NaN fails the first test
+	double segment(floor(position));
+	segment = segment >= 0.0 ? segment : 0.0;
+	segment = segment <= segmentCount - 1.0 ? segment : segmentCount - 1.0;
+	t = 2.0 * (position - segment) - 1.0;
+	return static_cast<unsigned int>(segment);
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		Evaluate
+//
+// Description:		Evaluates the approximation for a single value.
+//
+// Input Arguments:
+//		value	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double ChebyshevApproximation::Evaluate(const double &value) const
+{
+	double t;
+	const unsigned int segment(GetSegment(value, t));
+	return EvaluateSeries(&coefficients[segment * (degree + 1)], degree, t);
+}
+
+//==========================================================================
+// Class:			ChebyshevApproximation
+// Function:		Evaluate
+//
+// Description:		Evaluates the approximation for an array of values.  The
+//					recurrence is run for all lanes together, with the
+//					coefficients for each lane gathered from its segment, so
+//					the loop body contains no data-dependent branches.  Values
+//					outside of the fit range (and NaN) give meaningless results;
+//					callers are expected to check InRange().  Results may
+//					alias the input array.
+//
+// Input Arguments:
+//		values	= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		results	= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ChebyshevApproximation::Evaluate(const double *values, double *results, const size_t &count) const
+{
+	const size_t blockSize(CompiledConversion::blockSize);
+	const unsigned int stride(degree + 1);
+	size_t offset[CompiledConversion::blockSize];
+	double t[CompiledConversion::blockSize];
+	double b0, b1[CompiledConversion::blockSize], b2[CompiledConversion::blockSize];
+
+	for (size_t start = 0; start < count; start += blockSize)
+	{
+		const size_t lanes(std::min(blockSize, count - start));
+		size_t i;
+		for (i = 0; i < lanes; i++)
+		{
+			offset[i] = GetSegment(values[start + i], t[i]) * stride;
+			b1[i] = 0.0;
+			b2[i] = 0.0;
+		}
+
+		for (unsigned int k = degree; k > 0; k--)
+		{
+			for (i = 0; i < lanes; i++)
+			{
+				b0 = coefficients[offset[i] + k] + 2.0 * t[i] * b1[i] - b2[i];
+				b2[i] = b1[i];
+				b1[i] = b0;
+			}
+		}
+
+		for (i = 0; i < lanes; i++)
+			results[start + i] = coefficients[offset[i]] + t[i] * b1[i] - b2[i];
+	}
+}
@@ -0,0 +1,72 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  chebyshevApproximation.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Piecewise Chebyshev approximation of a compiled conversion over a
+//				 fixed input range.
+// History:
+
+#ifndef _CHEBYSHEV_APPROXIMATION_H_
+#define _CHEBYSHEV_APPROXIMATION_H_
+
+// Standard C++ headers
+#include <vector>
+
+// Local forward declarations
+class CompiledConversion;
+
+class ChebyshevApproximation
+{
+public:
+	ChebyshevApproximation() = default;
+	~ChebyshevApproximation() = default;
+
+	bool Fit(const CompiledConversion &conversion, const double &minimum,
+		const double &maximum, const double &tolerance);
+
+	double Evaluate(const double &value) const;
+	void Evaluate(const double *values, double *results, const size_t &count) const;
+
+	// False for NaN
+	bool InRange(const double &value) const { return value >= minimum && value <= maximum; };
+
+	double GetMaximumError() const { return maximumError; };
+	double GetMinimum() const { return minimum; };
+	double GetMaximum() const { return maximum; };
+	unsigned int GetSegmentCount() const { return segmentCount; };
+	unsigned int GetDegree() const { return degree; };
+
+private:
+	static const unsigned int maxDegree;
+	static const unsigned int minDegree;
+	static const unsigned int maxSegments;
+	static const unsigned int samplesPerSegment;// Uniform error samples
+
+	double minimum = 0.0;
+	double maximum = 0.0;
+	double scale = 0.0;// Segments per unit input
+
+	unsigned int degree = 0;
+	unsigned int segmentCount = 0;
+	double maximumError = 0.0;
+
+	// (degree + 1) coefficients per segment, stored contiguously
+	std::vector<double> coefficients;
+
+	static std::vector<double> GetSamplePoints();
+	static std::vector<double> FitSegment(const CompiledConversion &conversion,
+		const double &start, const double &end);
+	static double EvaluateSeries(const double *c, const unsigned int &degree, const double &t);
+	static double Error(const double &approximate, const double &exact);
+
+	unsigned int GetSegment(const double &value, double &t) const;
+};
+
+#endif// _CHEBYSHEV_APPROXIMATION_H_
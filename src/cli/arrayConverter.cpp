@@ -0,0 +1,528 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  arrayConverter.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Converts binary arrays of floating point values (raw files or
+//				 NumPy .npy files) without formatting them as text.  The file is
+//				 mapped and converted a block at a time, in place or to a new
+//				 file.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+
+// wxWidgets headers
+#include <wx/filename.h>
+
+// Local headers
+#include "arrayConverter.h"
+#include "compiledConversion.h"
+#include "mappedFile.h"
+#include "parallel.h"
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		Constant Definitions
+//
+// Description:		Constants for the ArrayConverter class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const size_t ArrayConverter::blockSize(64 * 1024);
+const unsigned int ArrayConverter::blocksPerThread(4);
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		ArrayConverter
+//
+// Description:		Constructor for ArrayConverter class.
+//
+// Input Arguments:
+//		conversion	= const CompiledConversion&
+//		rawType		= const Type&, of files other than .npy files
+//		outputType	= const Type&, typeNone to keep the input's type
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+ArrayConverter::ArrayConverter(const CompiledConversion &conversion,
+	const Type &rawType, const Type &outputType) : conversion(conversion),
+	rawType(rawType), outputType(outputType)
+{
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		ParseType
+//
+// Description:		Reads the name of a type.
+//
+// Input Arguments:
+//		name	= const std::string&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		Type, typeNone if the name is not recognized
+//
+//==========================================================================
+ArrayConverter::Type ArrayConverter::ParseType(const std::string &name)
+{
+	if (name == "f4" || name == "float32")
+		return typeFloat32;
+	else if (name == "f8" || name == "float64")
+		return typeFloat64;
+	return typeNone;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		IsNPY
+//
+// Description:		Checks the file's extension.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for .npy files
+//
+//==========================================================================
+bool ArrayConverter::IsNPY(const wxString &fileName)
+{
+	return wxFileName(fileName).GetExt().CmpNoCase(_T("npy")) == 0;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		ConvertInPlace
+//
+// Description:		Converts the values in the file, writing the results over
+//					them.  Blocks are converted in parallel.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString ArrayConverter::ConvertInPlace(const wxString &fileName)
+{
+	if (!HostIsLittleEndian())
+		return _T("Binary arrays require a little-endian system");
+
+	MappedFile file;
+	if (!file.Open(fileName, true))
+		return _T("Cannot open '") + fileName + _T("' for writing");
+
+	Layout layout;
+	const wxString error(ReadLayout(fileName, file.GetData(), file.GetSize(), rawType, layout));
+	if (!error.IsEmpty())
+		return error;
+	else if (outputType != typeNone && outputType != layout.type)
+		return _T("The type cannot be changed in place");
+
+	file.AdviseSequential();
+	char *data(file.GetWritableData() + layout.dataOffset);
+	const size_t valueSize(Size(layout.type));
+	const size_t blockCount((layout.count + blockSize - 1) / blockSize);
+	Parallel::For(blockCount, [&](const size_t &i)
+	{
+		char *block(data + i * blockSize * valueSize);
+		ConvertBlock(block, layout.type, block, layout.type,
+			std::min(blockSize, layout.count - i * blockSize));
+	});
+
+	if (!file.Flush())
+		return _T("Cannot write '") + fileName + _T("'");
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		Convert
+//
+// Description:		Converts the values in the file and writes the results.
+//					Blocks are converted in parallel a window at a time, and
+//					each window is written before the next is converted.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		out			= std::ostream&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString ArrayConverter::Convert(const wxString &fileName, std::ostream &out)
+{
+	if (!HostIsLittleEndian())
+		return _T("Binary arrays require a little-endian system");
+
+	MappedFile file;
+	if (!file.Open(fileName))
+		return _T("Cannot open '") + fileName + _T("'");
+
+	Layout layout;
+	const wxString error(ReadLayout(fileName, file.GetData(), file.GetSize(), rawType, layout));
+	if (!error.IsEmpty())
+		return error;
+
+	const Type type(outputType == typeNone ? layout.type : outputType);
+	if (layout.npy)
+	{
+		const std::string header(WriteNPYHeader(layout, type));
+		out.write(header.data(), header.size());
+	}
+
+	file.AdviseSequential();
+	const char *data(file.GetData() + layout.dataOffset);
+	const size_t inputSize(Size(layout.type)), outputSize(Size(type));
+	const size_t windowSize(blockSize * Parallel::ThreadCount() * blocksPerThread);
+	std::vector<char> output(std::min(windowSize, layout.count) * outputSize);
+	for (size_t windowStart = 0; windowStart < layout.count && out; windowStart += windowSize)
+	{
+		const size_t count(std::min(windowSize, layout.count - windowStart));
+		Parallel::For((count + blockSize - 1) / blockSize, [&](const size_t &i)
+		{
+			ConvertBlock(data + (windowStart + i * blockSize) * inputSize, layout.type,
+				output.data() + i * blockSize * outputSize, type,
+				std::min(blockSize, count - i * blockSize));
+		});
+
+		out.write(output.data(), count * outputSize);
+	}
+
+	if (!out)
+		return _T("Cannot write the output");
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		Size
+//
+// Description:		Returns the size of one value of the specified type.
+//
+// Input Arguments:
+//		type	= const Type&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		size_t [bytes]
+//
+//==========================================================================
+size_t ArrayConverter::Size(const Type &type)
+{
+	return type == typeFloat32 ? sizeof(float) : sizeof(double);
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		ReadLayout
+//
+// Description:		Finds the type, number and location of the values in the
+//					file.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		data		= const char*
+//		size		= const size_t&
+//		rawType		= const Type&
+//
+// Output Arguments:
+//		layout		= Layout&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString ArrayConverter::ReadLayout(const wxString &fileName, const char *data,
+	const size_t &size, const Type &rawType, Layout &layout)
+{
+	layout.npy = IsNPY(fileName);
+	layout.fortranOrder = false;
+	layout.shape.clear();
+	if (layout.npy)
+		return ReadNPYHeader(data, size, layout);
+
+	if (rawType == typeNone)
+		return _T("The type of '") + fileName + _T("' must be given");
+
+	layout.dataOffset = 0;
+	layout.type = rawType;
+	layout.count = size / Size(rawType);
+	if (size % Size(rawType) != 0)
+		return _T("The size of '") + fileName + _T("' is not a multiple of the value size");
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		ReadNPYHeader
+//
+// Description:		Reads the header of a .npy file (versions 1 to 3).  The
+//					header is a Python dictionary literal with keys descr,
+//					fortran_order and shape.  Only little-endian float32 and
+//					float64 arrays are accepted.
+//
+// Input Arguments:
+//		data	= const char*
+//		size	= const size_t&
+//
+// Output Arguments:
+//		layout	= Layout&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString ArrayConverter::ReadNPYHeader(const char *data, const size_t &size, Layout &layout)
+{
+	const char magic[] = "\x93NUMPY";
+	const size_t magicLength(sizeof(magic) - 1);
+	if (size < magicLength + 4 || memcmp(data, magic, magicLength) != 0)
+		return _T("Not a .npy file");
+
+	const unsigned char major(static_cast<unsigned char>(data[magicLength]));
+	size_t headerLength;
+	if (major == 1)
+	{
+		headerLength = static_cast<unsigned char>(data[magicLength + 2])
+			| static_cast<unsigned char>(data[magicLength + 3]) << 8;
+		layout.dataOffset = magicLength + 4 + headerLength;
+	}
+	else if ((major == 2 || major == 3) && size >= magicLength + 6)
+	{
+		uint32_t length;
+		memcpy(&length, data + magicLength + 2, sizeof(length));
+		headerLength = length;
+		layout.dataOffset = magicLength + 6 + headerLength;
+	}
+	else
+		return wxString::Format(_T(".npy version %u is not supported"), major);
+
+	if (headerLength > size || layout.dataOffset > size)
+		return _T(".npy header is truncated");
+	const std::string header(data + layout.dataOffset - headerLength, data + layout.dataOffset);
+
+	auto findValue = [&header](const std::string &key)
+	{
+		size_t position(header.find("'" + key + "'"));
+		if (position != std::string::npos)
+			position = header.find(':', position);
+		if (position != std::string::npos)
+			position = header.find_first_not_of(" ", position + 1);
+		return position;
+	};
+
+	const size_t descr(findValue("descr"));
+	if (descr == std::string::npos)
+		return _T(".npy header has no descr");
+	else if (header.compare(descr, 5, "'<f4'") == 0)
+		layout.type = typeFloat32;
+	else if (header.compare(descr, 5, "'<f8'") == 0)
+		layout.type = typeFloat64;
+	else
+		return _T(".npy type ") + wxString::FromUTF8(header.substr(descr, header.find_first_of(",}", descr) - descr).c_str())
+			+ _T(" is not supported (only little-endian float32 and float64)");
+
+	const size_t fortranOrder(findValue("fortran_order"));
+	layout.fortranOrder = fortranOrder != std::string::npos && header.compare(fortranOrder, 4, "True") == 0;
+
+	size_t position(findValue("shape"));
+	if (position == std::string::npos || header[position] != '(')
+		return _T(".npy header has no shape");
+
+	layout.count = 1;
+	for (position++; position < header.size() && header[position] != ')'; position++)
+	{
+		if (header[position] < '0' || header[position] > '9')
+			continue;
+
+		// The count must not wrap, or a huge shape could pass the size check
+		char *end;
+		errno = 0;
+		const unsigned long long dimension(std::strtoull(header.c_str() + position, &end, 10));
+		if (errno == ERANGE || dimension > SIZE_MAX
+			|| (dimension != 0 && layout.count > SIZE_MAX / dimension))
+			return _T(".npy shape is too large");
+
+		layout.shape.push_back(dimension);
+		layout.count *= dimension;
+		position = end - header.c_str() - 1;
+	}
+
+	const size_t dataSize(size - layout.dataOffset);
+	if (position >= header.size())
+		return _T(".npy shape is not terminated");
+	else if (dataSize % Size(layout.type) != 0 || layout.count != dataSize / Size(layout.type))
+		return _T(".npy data size does not match its shape");
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		WriteNPYHeader
+//
+// Description:		Writes a .npy header for the layout with the specified
+//					type, padded so the data is aligned to 64 bytes.
+//
+// Input Arguments:
+//		layout	= const Layout&
+//		type	= const Type&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string ArrayConverter::WriteNPYHeader(const Layout &layout, const Type &type)
+{
+	std::string dictionary("{'descr': '");
+	dictionary.append(type == typeFloat32 ? "<f4" : "<f8");
+	dictionary.append("', 'fortran_order': ");
+	dictionary.append(layout.fortranOrder ? "True" : "False");
+	dictionary.append(", 'shape': (");
+	for (size_t i = 0; i < layout.shape.size(); i++)
+	{
+		if (i > 0)
+			dictionary.append(", ");
+		dictionary.append(std::to_string(layout.shape[i]));
+	}
+	if (layout.shape.size() == 1)
+		dictionary.append(",");
+	dictionary.append("), }");
+
+	// Version 1 lengths are 16 bits
+	const unsigned char major(dictionary.size() + 1 + 10 + 64 > 0xFFFF ? 2 : 1);
+	const size_t prefixLength(major == 1 ? 10 : 12);
+	const size_t alignment(64);
+	dictionary.append(alignment - (prefixLength + dictionary.size() + 1) % alignment, ' ');
+	dictionary.append("\n");
+
+	std::string header("\x93NUMPY");
+	header.push_back(static_cast<char>(major));
+	header.push_back(0);
+	const uint32_t length(static_cast<uint32_t>(dictionary.size()));
+	header.push_back(static_cast<char>(length & 0xFF));
+	header.push_back(static_cast<char>(length >> 8 & 0xFF));
+	if (major > 1)
+	{
+		header.push_back(static_cast<char>(length >> 16 & 0xFF));
+		header.push_back(static_cast<char>(length >> 24 & 0xFF));
+	}
+
+	return header + dictionary;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		HostIsLittleEndian
+//
+// Description:		Checks the byte order of this system.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool ArrayConverter::HostIsLittleEndian()
+{
+	const uint16_t value(1);
+	unsigned char first;
+	memcpy(&first, &value, 1);
+	return first == 1;
+}
+
+//==========================================================================
+// Class:			ArrayConverter
+// Function:		ConvertBlock
+//
+// Description:		Converts one block of values.  The values are all read
+//					before any are written, so input and output may be the
+//					same.
+//
+// Input Arguments:
+//		input		= const char*
+//		inputType	= const Type&
+//		type		= const Type&, of the output
+//		count		= const size_t&
+//
+// Output Arguments:
+//		output		= char*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ArrayConverter::ConvertBlock(const char *input, const Type &inputType,
+	char *output, const Type &type, const size_t &count) const
+{
+	std::vector<double> values(count), results(count);
+	if (inputType == typeFloat64)
+		memcpy(values.data(), input, count * sizeof(double));
+	else
+	{
+		std::vector<float> singles(count);
+		memcpy(singles.data(), input, count * sizeof(float));
+		std::copy(singles.begin(), singles.end(), values.begin());
+	}
+
+	conversion.Evaluate(values.data(), results.data(), count);
+
+	if (type == typeFloat64)
+		memcpy(output, results.data(), count * sizeof(double));
+	else
+	{
+		std::vector<float> singles(results.begin(), results.end());
+		memcpy(output, singles.data(), count * sizeof(float));
+	}
+}
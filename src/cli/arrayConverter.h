@@ -0,0 +1,93 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  arrayConverter.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Converts binary arrays of floating point values (raw files or
+//				 NumPy .npy files) without formatting them as text.  The file is
+//				 mapped and converted a block at a time, in place or to a new
+//				 file.
+// History:
+
+#ifndef _ARRAY_CONVERTER_H_
+#define _ARRAY_CONVERTER_H_
+
+// Standard C++ headers
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/string.h>
+
+// Local forward declarations
+class CompiledConversion;
+
+class ArrayConverter
+{
+public:
+	// Values are always little-endian
+	enum Type
+	{
+		typeNone,
+		typeFloat32,
+		typeFloat64
+	};
+
+	// Accepts f4, f8, float32 and float64; typeNone if not recognized
+	static Type ParseType(const std::string &name);
+
+	// By extension (.npy)
+	static bool IsNPY(const wxString &fileName);
+
+	// Files other than .npy files are read as raw values of rawType.  The
+	// output has outputType, or the input's type if it is typeNone.
+	ArrayConverter(const CompiledConversion &conversion, const Type &rawType, const Type &outputType);
+
+	// The output type must match the input's.  Returns an error message
+	// (empty on success).
+	wxString ConvertInPlace(const wxString &fileName);
+
+	// A .npy file is written as a .npy file with the same shape.  Returns an
+	// error message (empty on success).
+	wxString Convert(const wxString &fileName, std::ostream &out);
+
+	static const size_t blockSize;// [values] Converted by one thread at a time
+	static const unsigned int blocksPerThread;// Written together when streaming
+
+private:
+	const CompiledConversion &conversion;
+	const Type rawType;
+	const Type outputType;
+
+	struct Layout
+	{
+		bool npy;
+		size_t dataOffset;// [bytes]
+		Type type;
+		size_t count;
+
+		// For .npy files
+		bool fortranOrder;
+		std::vector<uint64_t> shape;
+	};
+
+	static size_t Size(const Type &type);
+	static wxString ReadLayout(const wxString &fileName, const char *data,
+		const size_t &size, const Type &rawType, Layout &layout);
+	static wxString ReadNPYHeader(const char *data, const size_t &size, Layout &layout);
+	static std::string WriteNPYHeader(const Layout &layout, const Type &type);
+	static bool HostIsLittleEndian();
+
+	void ConvertBlock(const char *input, const Type &inputType,
+		char *output, const Type &type, const size_t &count) const;
+};
+
+#endif// _ARRAY_CONVERTER_H_
@@ -0,0 +1,828 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  converterCli.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Command line converter for batch jobs and scripts.  Uses the
+//				 conversion engine without initializing the GUI.
+// History:
+
+// Standard C++ headers
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+// wxWidgets headers
+#include <wx/init.h>
+
+// Local headers
+#include "converterCli.h"
+#include "layeredCatalog.h"
+#include "converter.h"
+#include "catalogImport.h"
+#include "messageReporter.h"
+#include "numberParser.h"
+#include "numberFormatter.h"
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		Constant Definitions
+//
+// Description:		Constants for the ConverterCLI class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const char *ConverterCLI::name("converter-cli");
+const size_t ConverterCLI::blockSize(4096);
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ConverterCLI
+//
+// Description:		Constructor for ConverterCLI class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+ConverterCLI::ConverterCLI() : precision(NumberFormatter::shortestRoundTrip),
+	approximate(false), approximationMinimum(0.0), approximationMaximum(0.0),
+	approximationTolerance(0.0), hasHeader(false), rawType(ArrayConverter::typeNone), outputType(ArrayConverter::typeNone),
+	inPlace(false), arrays(false), out(&std::cout), failedLines(false), conversionError(false)
+{
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		Run
+//
+// Description:		Converts the inputs named on the command line (or stdin).
+//					Engine messages are written to stderr while running.  A
+//					partial output file from a failed column or array
+//					conversion is removed.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ExitCode
+//
+//==========================================================================
+int ConverterCLI::Run(int argc, char *argv[])
+{
+	bool help;
+	if (!ParseArguments(argc, argv, help))
+		return exitError;
+	else if (help)
+	{
+		PrintUsage();
+		return exitSuccess;
+	}
+
+	std::ofstream outputFile;
+	if (!outputFileName.empty())
+	{
+		outputFile.open(outputFileName.c_str(), std::ios::binary);
+		if (!outputFile.is_open())
+		{
+			std::cerr << name << ":  cannot create '" << outputFileName << "'" << std::endl;
+			return exitError;
+		}
+		out = &outputFile;
+	}
+
+	MessageReporter::SetHandler([this](const MessageReporter::Severity &severity, const wxString &message)
+	{
+		if (severity == MessageReporter::severityError)
+			conversionError = true;
+
+		// Written at once, as messages may come from several threads
+		std::cerr << std::string(name) + (severity == MessageReporter::severityError ? ":  error:  " : ":  warning:  ")
+			+ message.utf8_str().data() + "\n" << std::flush;
+	});
+
+	const int exitCode(ConvertInputs());
+	MessageReporter::SetHandler(MessageReporter::Handler());
+
+	if (outputFile.is_open())
+	{
+		outputFile.close();
+		if ((!columns.empty() || arrays) && exitCode != exitSuccess)
+			std::remove(outputFileName.c_str());
+	}
+
+	return exitCode;
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ParseArguments
+//
+// Description:		Reads the options and input file names.  Options taking
+//					a value accept it as the next argument or (for the long
+//					form) after '='.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		help	= bool&, true if usage was requested
+//
+// Return Value:
+//		bool, false if the arguments are invalid (the error has been written)
+//
+//==========================================================================
+bool ConverterCLI::ParseArguments(int argc, char *argv[], bool &help)
+{
+	help = false;
+	bool optionsEnded(false);
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument(argv[i]);
+		if (optionsEnded || argument == "-" || argument.empty() || argument[0] != '-')
+		{
+			inputFileNames.push_back(argument);
+			continue;
+		}
+
+		std::string option(argument), value;
+		bool hasValue(false);
+		const size_t equals(argument.find('='));
+		if (argument.compare(0, 2, "--") == 0 && equals != std::string::npos)
+		{
+			option = argument.substr(0, equals);
+			value = argument.substr(equals + 1);
+			hasValue = true;
+		}
+
+		auto readValue = [&](wxString &target)
+		{
+			if (!hasValue && i + 1 < argc)
+			{
+				value = argv[++i];
+				hasValue = true;
+			}
+
+			if (!hasValue)
+				std::cerr << name << ":  '" << option << "' requires a value" << std::endl;
+			target = wxString::FromUTF8(value.c_str());
+			return hasValue;
+		};
+
+		wxString text;
+		if (option == "--")
+			optionsEnded = true;
+		else if (option == "-h" || option == "--help")
+			help = true;
+		else if (option == "-c" || option == "--catalog")
+		{
+			if (!readValue(text))
+				return false;
+			catalogFileNames.push_back(text);
+		}
+		else if (option == "-g" || option == "--group")
+		{
+			if (!readValue(defaultGroup))
+				return false;
+		}
+		else if (option == "-f" || option == "--from")
+		{
+			if (!readValue(defaultInUnit))
+				return false;
+		}
+		else if (option == "-t" || option == "--to")
+		{
+			if (!readValue(defaultOutUnit))
+				return false;
+		}
+		else if (option == "--approximate")
+		{
+			if (!readValue(text))
+				return false;
+
+			char *end;
+			const char *position(value.c_str());
+			double *targets[] = { &approximationMinimum, &approximationMaximum, &approximationTolerance };
+			unsigned int count(0);
+			for (; count < 3; count++)
+			{
+				*targets[count] = std::strtod(position, &end);
+				if (end == position || (count < 2 && *end != ',') || (count == 2 && *end != '\0'))
+					break;
+				position = end + 1;
+			}
+
+			if (count < 3 || !(approximationMaximum > approximationMinimum) || !(approximationTolerance > 0.0))
+			{
+				std::cerr << name << ":  --approximate requires MIN,MAX,TOLERANCE (MIN < MAX, TOLERANCE > 0)" << std::endl;
+				return false;
+			}
+			approximate = true;
+		}
+		else if (option == "--column")
+		{
+			if (!readValue(text))
+				return false;
+
+			const char *position(value.data()), *end(value.data() + value.size());
+			unsigned int lines(0);
+			std::vector<std::string> fields;
+			bool endOfRow(false);
+			while (!endOfRow)
+			{
+				fields.push_back(std::string());
+				if (!CatalogImport::ReadField(position, end, ',', lines, fields.back(), endOfRow))
+					break;
+			}
+
+			if (!endOfRow || fields.size() != CatalogImport::fieldCount)
+			{
+				std::cerr << name << ":  --column requires COLUMN,GROUP,IN,OUT" << std::endl;
+				return false;
+			}
+
+			CSVColumnConverter::Column column;
+			column.name = wxString::FromUTF8(fields[0].c_str());
+			column.group = wxString::FromUTF8(fields[1].c_str());
+			column.inUnit = wxString::FromUTF8(fields[2].c_str());
+			column.outUnit = wxString::FromUTF8(fields[3].c_str());
+			columns.push_back(column);
+		}
+		else if (option == "--header")
+			hasHeader = true;
+		else if (option == "--raw" || option == "--output-type")
+		{
+			if (!readValue(text))
+				return false;
+
+			const ArrayConverter::Type type(ArrayConverter::ParseType(value));
+			if (type == ArrayConverter::typeNone)
+			{
+				std::cerr << name << ":  type must be f4 (float32) or f8 (float64)" << std::endl;
+				return false;
+			}
+			(option == "--raw" ? rawType : outputType) = type;
+		}
+		else if (option == "--in-place")
+			inPlace = true;
+		else if (option == "-o" || option == "--output")
+		{
+			if (!readValue(text))
+				return false;
+			outputFileName = value;
+		}
+		else if (option == "-p" || option == "--precision")
+		{
+			if (!readValue(text))
+				return false;
+
+			char *end;
+			precision = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+			if (value.empty() || *end != '\0' || precision < 1 ||
+				precision > NumberFormatter::maxSignificantDigits)
+			{
+				std::cerr << name << ":  precision must be from 1 to "
+					<< NumberFormatter::maxSignificantDigits << std::endl;
+				return false;
+			}
+		}
+		else
+		{
+			std::cerr << name << ":  unknown option '" << option << "' (see --help)" << std::endl;
+			return false;
+		}
+	}
+
+	if (catalogFileNames.empty())
+		catalogFileNames = LayeredCatalog::GetSharedFileNames();
+	if (inputFileNames.empty())
+		inputFileNames.push_back("-");
+
+	if (!columns.empty() && (inputFileNames.size() != 1 || inputFileNames.front() == "-"))
+	{
+		std::cerr << name << ":  --column requires one input file (stdin cannot be mapped)" << std::endl;
+		return false;
+	}
+	else if (hasHeader && columns.empty())
+	{
+		std::cerr << name << ":  --header requires --column" << std::endl;
+		return false;
+	}
+	else if (approximate && (defaultGroup.IsEmpty() || defaultInUnit.IsEmpty() || defaultOutUnit.IsEmpty()))
+	{
+		std::cerr << name << ":  --approximate requires --group, --from and --to" << std::endl;
+		return false;
+	}
+
+	arrays = rawType != ArrayConverter::typeNone || (inputFileNames.size() == 1 &&
+		ArrayConverter::IsNPY(wxString::FromUTF8(inputFileNames.front().c_str())));
+	if (!arrays)
+	{
+		if (inPlace || outputType != ArrayConverter::typeNone)
+		{
+			std::cerr << name << ":  --in-place and --output-type require a binary array (--raw or a .npy file)" << std::endl;
+			return false;
+		}
+	}
+	else if (!columns.empty() || inputFileNames.size() != 1 || inputFileNames.front() == "-")
+	{
+		std::cerr << name << ":  binary arrays require one input file (and no --column)" << std::endl;
+		return false;
+	}
+	else if (inPlace == !outputFileName.empty())
+	{
+		std::cerr << name << ":  binary arrays require one of --output and --in-place" << std::endl;
+		return false;
+	}
+	else if (defaultGroup.IsEmpty() || defaultInUnit.IsEmpty() || defaultOutUnit.IsEmpty())
+	{
+		std::cerr << name << ":  binary arrays require --group, --from and --to" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		PrintUsage
+//
+// Description:		Writes the command line help to stdout.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterCLI::PrintUsage()
+{
+	std::cout << "Usage:  " << name << " [options] [file ...]\n"
+		"Converts the values in the files (or stdin, or '-') and writes one line to\n"
+		"stdout for each input line.  Each line is either group,in,out,value (comma\n"
+		"or tab separated) or a single value.  Lines that cannot be converted are\n"
+		"written as empty lines and reported on stderr.\n\n"
+		"Options:\n"
+		"  -c, --catalog FILE   Catalog to use; repeat to layer catalogs, each taking\n"
+		"                       precedence over those before it.  By default, the\n"
+		"                       application's catalog and $" << LayeredCatalog::siteCatalogVariable.utf8_str() << "\n"
+		"  -g, --group NAME     Group of single values\n"
+		"  -f, --from UNIT      Unit of single values\n"
+		"  -t, --to UNIT        Unit to convert single values to\n"
+		"  -p, --precision N    Significant digits in results (by default, as many as\n"
+		"                       are needed to read back the same value)\n"
+		"  --column COL,GROUP,IN,OUT\n"
+		"                       Convert column COL (a number from 1, or a name from\n"
+		"                       the header) of a CSV file in place, copying the rest\n"
+		"                       of each line; repeat for more columns.  Requires one\n"
+		"                       input file, which is converted in parallel\n"
+		"  --header             The CSV file's first line names its columns\n"
+		"  --raw TYPE           Convert the input file as a binary array of little-\n"
+		"                       endian values of TYPE (f4 or f8); .npy files are\n"
+		"                       binary arrays without --raw.  Arrays are converted\n"
+		"                       as given by --group, --from and --to, and require\n"
+		"                       --output or --in-place\n"
+		"  --output-type TYPE   Type of the converted array (by default, the input's)\n"
+		"  --in-place           Write the converted array over the input\n"
+		"  -o, --output FILE    Write to FILE instead of stdout\n"
+		"  --approximate MIN,MAX,TOLERANCE\n"
+		"                       Convert single values from MIN to MAX with a fitted\n"
+		"                       approximation (faster for conversions that are not\n"
+		"                       linear).  The error, measured at many points, is\n"
+		"                       within TOLERANCE (relative for results larger than\n"
+		"                       one, otherwise absolute); other values are converted\n"
+		"                       exactly\n"
+		"  -h, --help           Show this message\n\n"
+		"Exit status is 0 on success, 1 if any line could not be converted and 2 if\n"
+		"the arguments, catalog or an input could not be read.\n";
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ConvertInputs
+//
+// Description:		Loads the catalog and converts each input in turn.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ExitCode
+//
+//==========================================================================
+int ConverterCLI::ConvertInputs()
+{
+	// Only the groups that are used are read
+	LayeredCatalog catalog(catalogFileNames, true);
+	if (!catalog.Load())
+		return exitError;
+	Converter converter(catalog);
+
+	if (!columns.empty())
+		return ConvertColumns(converter);
+	else if (arrays)
+		return ConvertArray(converter);
+
+	double maximumError;
+	if (approximate && converter.CanConvert(defaultGroup, defaultInUnit, defaultOutUnit) &&
+		!converter.CompileApproximation(defaultGroup, defaultInUnit, defaultOutUnit,
+		approximationMinimum, approximationMaximum, approximationTolerance, maximumError))
+		std::cerr << name << ":  warning:  no approximation is within the tolerance; converting exactly" << std::endl;
+
+	bool read(true);
+	for (const auto &fileName : inputFileNames)
+	{
+		if (fileName == "-")
+		{
+			read = ConvertStream(std::cin, "stdin", catalog, converter) && read;
+			continue;
+		}
+
+		std::ifstream file(fileName.c_str(), std::ios::binary);
+		if (!file.is_open())
+		{
+			std::cerr << name << ":  cannot open '" << fileName << "'" << std::endl;
+			read = false;
+			continue;
+		}
+
+		read = ConvertStream(file, fileName, catalog, converter) && read;
+	}
+
+	Flush(converter);
+	WriteOutput(true);
+
+	if (!read)
+		return exitError;
+	return failedLines ? exitFailedLines : exitSuccess;
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ConvertColumns
+//
+// Description:		Converts the columns of the input file in place.
+//
+// Input Arguments:
+//		converter	= Converter&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ExitCode
+//
+//==========================================================================
+int ConverterCLI::ConvertColumns(Converter &converter)
+{
+	const std::string &fileName(inputFileNames.front());
+	CSVColumnConverter csv(columns, hasHeader, precision);
+	const wxString error(csv.Convert(wxString::FromUTF8(fileName.c_str()), *out, converter));
+	out->flush();
+
+	if (!error.IsEmpty())
+	{
+		std::cerr << name << ":  " << fileName << ":  " << error.utf8_str() << std::endl;
+		return exitError;
+	}
+
+	return exitSuccess;
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ConvertArray
+//
+// Description:		Converts the binary array in the input file.
+//
+// Input Arguments:
+//		converter	= Converter&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ExitCode
+//
+//==========================================================================
+int ConverterCLI::ConvertArray(Converter &converter)
+{
+	const std::string &fileName(inputFileNames.front());
+	const CompiledConversion *conversion(nullptr);
+	wxString error;
+	if (!converter.CanConvert(defaultGroup, defaultInUnit, defaultOutUnit))
+		error = _T("Cannot convert from '") + defaultInUnit + _T("' to '") + defaultOutUnit
+			+ _T("' in group '") + defaultGroup + _T("'");
+	else
+		error = converter.Compile(defaultGroup, defaultInUnit, defaultOutUnit, conversion);
+
+	if (error.IsEmpty())
+	{
+		ArrayConverter array(*conversion, rawType, outputType);
+		if (inPlace)
+			error = array.ConvertInPlace(wxString::FromUTF8(fileName.c_str()));
+		else
+		{
+			error = array.Convert(wxString::FromUTF8(fileName.c_str()), *out);
+			out->flush();
+		}
+	}
+
+	if (!error.IsEmpty())
+	{
+		std::cerr << name << ":  " << fileName << ":  " << error.utf8_str() << std::endl;
+		return exitError;
+	}
+
+	return exitSuccess;
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ConvertStream
+//
+// Description:		Converts each line of the input.  Values are converted
+//					and written in blocks, but whenever the input has nothing
+//					more buffered (and the next read would wait), what has
+//					been read is converted and flushed, so that a client
+//					writing one line at a time through a pipe gets each
+//					result before it writes the next line.
+//
+// Input Arguments:
+//		in			= std::istream&
+//		inputName	= const std::string&, for error messages
+//		catalog		= const LayeredCatalog&
+//		converter	= Converter&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false if the input could not be read
+//
+//==========================================================================
+bool ConverterCLI::ConvertStream(std::istream &in, const std::string &inputName,
+	const LayeredCatalog &catalog, Converter &converter)
+{
+	std::string line;
+	unsigned int lineNumber(0);
+	while (std::getline(in, line))
+	{
+		lineNumber++;
+		if (!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		const bool blank(line.find_first_not_of(" \t") == std::string::npos);
+		wxString error;
+		if (!blank)
+		{
+			error = ConvertLine(line, lineNumber == 1, catalog, converter);
+			if (!error.IsEmpty())
+			{
+				failedLines = true;
+				std::cerr << name << ":  " << inputName << ":" << lineNumber << ":  "
+					<< error.utf8_str() << std::endl;
+			}
+		}
+
+		// Output for blank and invalid lines keeps its place among the results
+		if (blank || !error.IsEmpty())
+		{
+			Flush(converter);
+			output += '\n';
+		}
+
+		// Reading more would wait, so answer the lines read so far
+		if (in.rdbuf()->in_avail() <= 0)
+		{
+			Flush(converter);
+			WriteOutput(true);
+		}
+	}
+
+	return !in.bad();
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		ConvertLine
+//
+// Description:		Reads one line and adds its value to the block (writing
+//					the block first if the conversion differs).
+//
+// Input Arguments:
+//		line		= const std::string&, without the line break
+//		firstLine	= const bool&
+//		catalog		= const LayeredCatalog&
+//		converter	= Converter&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString ConverterCLI::ConvertLine(const std::string &line, const bool &firstLine,
+	const LayeredCatalog &catalog, Converter &converter)
+{
+	const char delimiter(line.find('\t') == std::string::npos ? ',' : '\t');
+	const char *position(line.data()), *end(line.data() + line.size());
+	unsigned int lines(0);
+	std::vector<std::string> fields;
+	bool endOfRow(false);
+	while (!endOfRow)
+	{
+		fields.push_back(std::string());
+		if (!CatalogImport::ReadField(position, end, delimiter, lines, fields.back(), endOfRow))
+			return _T("Quoted field is not terminated");
+	}
+
+	wxString group(defaultGroup), inUnit(defaultInUnit), outUnit(defaultOutUnit);
+	if (fields.size() == CatalogImport::fieldCount)
+	{
+		group = wxString::FromUTF8(fields[0].c_str());
+		if (firstLine && group.CmpNoCase(_T("group")) == 0)
+			return wxEmptyString;// Header
+
+		inUnit = wxString::FromUTF8(fields[1].c_str());
+		outUnit = wxString::FromUTF8(fields[2].c_str());
+	}
+	else if (fields.size() != 1)
+		return wxString::Format(_T("Expected a single value or %u fields (group, in, out and value)"),
+			CatalogImport::fieldCount);
+	else if (group.IsEmpty() || inUnit.IsEmpty() || outUnit.IsEmpty())
+		return _T("Single values require --group, --from and --to");
+
+	const std::string &text(fields.back());
+	const char *valueEnd;
+	double value;
+	if (text.empty() || !NumberParser::Parse(text.data(), text.data() + text.size(), value, valueEnd) ||
+		valueEnd != text.data() + text.size())
+		return _T("Cannot read value '") + wxString::FromUTF8(text.c_str()) + _T("'");
+
+	if (!block.values.empty() && (block.group.Cmp(group) != 0 ||
+		block.inUnit.Cmp(inUnit) != 0 || block.outUnit.Cmp(outUnit) != 0))
+		Flush(converter);
+
+	if (block.values.empty())
+	{
+		if (catalog.FindGroup(group) == wxNOT_FOUND)
+			return _T("Group '") + group + _T("' not found");
+		else if (!converter.CanConvert(group, inUnit, outUnit))
+			return _T("Cannot convert from '") + inUnit + _T("' to '") + outUnit
+				+ _T("' in group '") + group + _T("'");
+
+		block.group = group;
+		block.inUnit = inUnit;
+		block.outUnit = outUnit;
+	}
+
+	block.values.push_back(value);
+	if (block.values.size() == blockSize)
+		Flush(converter);
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		Flush
+//
+// Description:		Converts the values in the block and adds the results to
+//					the output.  If the engine reports an error, the block's
+//					lines are written empty.
+//
+// Input Arguments:
+//		converter	= Converter&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterCLI::Flush(Converter &converter)
+{
+	if (block.values.empty())
+		return;
+
+	std::vector<double> results(block.values.size());
+	conversionError = false;
+	converter.Convert(block.group, block.inUnit, block.outUnit,
+		block.values.data(), results.data(), results.size());
+
+	if (conversionError)
+	{
+		failedLines = true;
+		output.append(results.size(), '\n');
+	}
+	else
+	{
+		const NumberFormatter::Style style(NumberFormatter::Style::Shortest);
+		const size_t start(output.size());
+		output.resize(start + results.size() * (NumberFormatter::MaxLength(style, precision) + 1));
+
+		size_t used;
+		NumberFormatter::Format(results.data(), results.size(), &output[start],
+			output.size() - start, '\n', used, style, precision);
+		output.resize(start + used);
+	}
+
+	block.values.clear();
+	WriteOutput(false);
+}
+
+//==========================================================================
+// Class:			ConverterCLI
+// Function:		WriteOutput
+//
+// Description:		Writes the output once enough has accumulated (or when
+//					forced).
+//
+// Input Arguments:
+//		force	= const bool&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterCLI::WriteOutput(const bool &force)
+{
+	if (!force && output.size() < 64 * 1024)
+		return;
+
+	out->write(output.data(), output.size());
+	if (force)
+		out->flush();
+	output.clear();
+}
+
+//==========================================================================
+// Class:			None
+// Function:		main
+//
+// Description:		Entry point for the command line converter.  wxWidgets is
+//					initialized without a GUI.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ConverterCLI::ExitCode
+//
+//==========================================================================
+int main(int argc, char *argv[])
+{
+	std::ios::sync_with_stdio(false);
+
+	wxInitializer initializer;
+	if (!initializer.IsOk())
+	{
+		std::cerr << ConverterCLI::name << ":  cannot initialize wxWidgets" << std::endl;
+		return ConverterCLI::exitError;
+	}
+
+	return ConverterCLI().Run(argc, argv);
+}
@@ -0,0 +1,108 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  converterCli.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Command line converter for batch jobs and scripts.  Uses the
+//				 conversion engine without initializing the GUI.
+// History:
+
+#ifndef _CONVERTER_CLI_H_
+#define _CONVERTER_CLI_H_
+
+// Standard C++ headers
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/string.h>
+
+// Local headers
+#include "csvColumnConverter.h"
+#include "arrayConverter.h"
+
+// Local forward declarations
+class LayeredCatalog;
+class Converter;
+
+class ConverterCLI
+{
+public:
+	ConverterCLI();
+
+	// Each input line is either "group,in,out,value" (or tab separated) or a
+	// single value (converted as given by --group, --from and --to).  One
+	// line is written for each input line:  the result, or nothing if the
+	// line could not be converted (the error is written to stderr).  Blank
+	// lines are copied, and a header row starting with "group" is skipped.
+	// With --column, the named columns of a single CSV file are converted in
+	// place instead (see CSVColumnConverter).  A binary array (a .npy file,
+	// or raw values with --raw) is converted as given by --group, --from and
+	// --to (see ArrayConverter).
+	int Run(int argc, char *argv[]);
+
+	enum ExitCode
+	{
+		exitSuccess = 0,
+		exitFailedLines = 1,// Some lines could not be converted
+		exitError = 2// Invalid arguments, or the catalog or an input could not be read
+	};
+
+	static const char *name;
+	static const size_t blockSize;// Values converted together
+
+private:
+	std::vector<wxString> catalogFileNames;
+	std::vector<std::string> inputFileNames;
+	wxString defaultGroup, defaultInUnit, defaultOutUnit;
+	int precision;
+
+	// Single values may be converted with a fitted approximation
+	bool approximate;
+	double approximationMinimum, approximationMaximum, approximationTolerance;
+
+	std::vector<CSVColumnConverter::Column> columns;
+	bool hasHeader;
+	ArrayConverter::Type rawType, outputType;
+	bool inPlace;
+	bool arrays;// The input is a binary array
+
+	std::string outputFileName;
+	std::ostream *out;// stdout unless an output file is named
+
+	bool failedLines;
+	std::atomic<bool> conversionError;// Reported by the engine since the last block
+
+	// Consecutive values with the same conversion are converted together
+	struct Block
+	{
+		wxString group, inUnit, outUnit;
+		std::vector<double> values;
+	};
+
+	Block block;
+	std::string output;// Written to out as it fills
+
+	bool ParseArguments(int argc, char *argv[], bool &help);
+	static void PrintUsage();
+
+	int ConvertInputs();
+	int ConvertColumns(Converter &converter);
+	int ConvertArray(Converter &converter);
+	bool ConvertStream(std::istream &in, const std::string &inputName,
+		const LayeredCatalog &catalog, Converter &converter);
+	wxString ConvertLine(const std::string &line, const bool &firstLine,
+		const LayeredCatalog &catalog, Converter &converter);
+	void Flush(Converter &converter);
+	void WriteOutput(const bool &force);
+};
+
+#endif// _CONVERTER_CLI_H_
@@ -0,0 +1,520 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  csvColumnConverter.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Converts the units of selected columns of a large CSV file.  The
+//				 file is mapped and split into chunks at line breaks, which are
+//				 converted in parallel and written in order.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <ostream>
+
+// Local headers
+#include "csvColumnConverter.h"
+#include "converter.h"
+#include "compiledConversion.h"
+#include "catalogImport.h"
+#include "mappedFile.h"
+#include "parallel.h"
+#include "numberParser.h"
+#include "numberFormatter.h"
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CSVColumnConverter class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const size_t CSVColumnConverter::chunkSize(8 * 1024 * 1024);
+const unsigned int CSVColumnConverter::chunksPerThread(2);
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		CSVColumnConverter
+//
+// Description:		Constructor for CSVColumnConverter class.
+//
+// Input Arguments:
+//		columns		= const std::vector<Column>&
+//		hasHeader	= const bool&, true if the first line is copied without
+//					  conversion (and names the columns)
+//		precision	= const int&, significant digits of the results
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+CSVColumnConverter::CSVColumnConverter(const std::vector<Column> &columns,
+	const bool &hasHeader, const int &precision) : columns(columns),
+	hasHeader(hasHeader), precision(precision), delimiter(',')
+{
+}
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		Convert
+//
+// Description:		Converts the file.  Chunks are converted a window at a
+//					time, and the thread that completes the next chunk to be
+//					written writes it (along with any completed chunks that
+//					follow), so no more than one window of output is held
+//					in memory.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		converter	= Converter&
+//
+// Output Arguments:
+//		out			= std::ostream&
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CSVColumnConverter::Convert(const wxString &fileName, std::ostream &out, Converter &converter)
+{
+	MappedFile file;
+	if (!file.Open(fileName))
+		return _T("Cannot open '") + fileName + _T("'");
+
+	const char *data(file.GetData());
+	const char *end(data + file.GetSize());
+
+	const char *firstLineEnd(data ? static_cast<const char*>(memchr(data, '\n', end - data)) : nullptr);
+	if (!firstLineEnd)
+		firstLineEnd = end;
+	delimiter = std::find(data, firstLineEnd, '\t') == firstLineEnd ? ',' : '\t';
+
+	const char *headerEnd(firstLineEnd);
+	if (headerEnd > data && headerEnd[-1] == '\r')
+		headerEnd--;
+
+	wxString error(ResolveColumns(data, headerEnd, converter));
+	if (!error.IsEmpty())
+		return error;
+
+	const char *body(data);
+	if (hasHeader)
+	{
+		body = firstLineEnd == end ? end : firstLineEnd + 1;
+		out.write(data, body - data);
+	}
+
+	std::vector<Chunk> chunks;
+	for (const char *first = body; first < end; )
+	{
+		const char *last(first + std::min<size_t>(chunkSize, end - first));
+		if (last < end)
+		{
+			const char *lineEnd(static_cast<const char*>(memchr(last, '\n', end - last)));
+			last = lineEnd ? lineEnd + 1 : end;
+		}
+
+		Chunk chunk;
+		chunk.first = first;
+		chunk.last = last;
+		chunk.lineCount = 0;
+		chunk.errorLine = 0;
+		chunk.converted = false;
+		chunks.push_back(chunk);
+
+		first = last;
+	}
+
+	const size_t windowSize(Parallel::ThreadCount() * chunksPerThread);
+	std::mutex writeMutex;
+	std::atomic<bool> failed(false);
+	size_t nextChunk(0);
+	unsigned long long linesWritten(hasHeader ? 1 : 0);
+	for (size_t windowStart = 0; windowStart < chunks.size() && !failed; windowStart += windowSize)
+	{
+		const size_t windowEnd(std::min(chunks.size(), windowStart + windowSize));
+		Parallel::For(windowEnd - windowStart, [&](const size_t &i)
+		{
+			if (failed)
+				return;
+
+			Chunk &chunk(chunks[windowStart + i]);
+			ConvertChunk(chunk);
+
+			std::lock_guard<std::mutex> lock(writeMutex);
+			chunk.converted = true;
+			while (!failed && nextChunk < windowEnd && chunks[nextChunk].converted)
+			{
+				Chunk &next(chunks[nextChunk]);
+				if (!next.error.IsEmpty())
+				{
+					error = next.error + _T(" (line ") + wxString::FromUTF8(
+						std::to_string(linesWritten + next.errorLine).c_str()) + _T(")");
+					failed = true;
+					break;
+				}
+
+				out.write(next.output.data(), next.output.size());
+				linesWritten += next.lineCount;
+				std::string().swap(next.output);
+				nextChunk++;
+			}
+		});
+	}
+
+	if (error.IsEmpty() && !out)
+		return _T("Cannot write the output");
+
+	return error;
+}
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		ResolveColumns
+//
+// Description:		Finds the field index of each column and compiles its
+//					conversion.
+//
+// Input Arguments:
+//		header		= const char*, start of the first line
+//		headerEnd	= const char*, end of the first line (without the break)
+//		converter	= Converter&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString CSVColumnConverter::ResolveColumns(const char *header, const char *headerEnd, Converter &converter)
+{
+	std::vector<wxString> names;
+	if (hasHeader && header)
+	{
+		unsigned int lines(0);
+		bool endOfRow(false);
+		while (!endOfRow)
+		{
+			std::string field;
+			if (!CatalogImport::ReadField(header, headerEnd, delimiter, lines, field, endOfRow))
+				return _T("Quoted field in the header is not terminated");
+			names.push_back(wxString::FromUTF8(field.c_str()));
+		}
+	}
+
+	conversions.clear();
+	fieldOrder.clear();
+	for (unsigned int c = 0; c < columns.size(); c++)
+	{
+		const Column &column(columns[c]);
+		unsigned long number;
+		unsigned int index;
+		if (column.name.ToULong(&number) && number > 0)
+			index = static_cast<unsigned int>(number - 1);
+		else if (!hasHeader)
+			return _T("Column '") + column.name + _T("' must be a number (or the file must have a header)");
+		else
+		{
+			const auto name(std::find(names.begin(), names.end(), column.name));
+			if (name == names.end())
+				return _T("Column '") + column.name + _T("' is not in the header");
+			index = static_cast<unsigned int>(name - names.begin());
+		}
+
+		for (const auto &field : fieldOrder)
+		{
+			if (field.first == index)
+				return _T("Column '") + column.name + _T("' is converted more than once");
+		}
+		fieldOrder.push_back(std::make_pair(index, c));
+
+		if (!converter.CanConvert(column.group, column.inUnit, column.outUnit))
+			return _T("Cannot convert from '") + column.inUnit + _T("' to '") + column.outUnit
+				+ _T("' in group '") + column.group + _T("'");
+
+		const CompiledConversion *conversion;
+		const wxString error(converter.Compile(column.group, column.inUnit, column.outUnit, conversion));
+		if (!error.IsEmpty())
+			return error;
+		conversions.push_back(conversion);
+	}
+
+	std::sort(fieldOrder.begin(), fieldOrder.end());
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		ConvertChunk
+//
+// Description:		Converts the lines in the chunk, reading every value
+//					first so that each column is converted in one call.
+//					Sets the chunk's error (and stops) at the first line that
+//					cannot be read.
+//
+// Input Arguments:
+//		chunk	= Chunk&
+//
+// Output Arguments:
+//		chunk	= Chunk&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CSVColumnConverter::ConvertChunk(Chunk &chunk) const
+{
+	const size_t columnCount(columns.size());
+	std::vector<const char*> lineStarts;
+	std::vector<std::pair<const char*, const char*> > fields;// columnCount per line; NULL for blank lines
+	std::vector<std::vector<double> > values(columnCount);
+
+	for (const char *position = chunk.first; position < chunk.last; )
+	{
+		const char *lineEnd(static_cast<const char*>(memchr(position, '\n', chunk.last - position)));
+		if (!lineEnd)
+			lineEnd = chunk.last;
+		chunk.lineCount++;
+		lineStarts.push_back(position);
+
+		const char *contentEnd(lineEnd);
+		if (contentEnd > position && contentEnd[-1] == '\r')
+			contentEnd--;
+
+		fields.resize(fields.size() + columnCount, std::make_pair(nullptr, nullptr));
+		if (contentEnd > position)
+		{
+			// Chunks are split at any line break, so quoted line breaks are
+			// rejected rather than misread
+			if (delimiter == ',' && memchr(position, '"', contentEnd - position)
+				&& EndsInQuotedField(position, contentEnd))
+			{
+				chunk.errorLine = chunk.lineCount;
+				chunk.error = _T("Quoted field contains a line break (not supported)");
+				return;
+			}
+
+			std::pair<const char*, const char*> *lineFields(&fields[fields.size() - columnCount]);
+			if (!FindFields(position, contentEnd, lineFields))
+			{
+				chunk.errorLine = chunk.lineCount;
+				chunk.error = wxString::Format(_T("Expected at least %u fields"), fieldOrder.back().first + 1);
+				return;
+			}
+
+			for (unsigned int c = 0; c < columnCount; c++)
+			{
+				const char *first(lineFields[c].first), *last(lineFields[c].second);
+				while (first < last && (*first == ' ' || *first == '\t'))
+					first++;
+				while (last > first && (last[-1] == ' ' || last[-1] == '\t'))
+					last--;
+
+				// Quoted numbers are replaced between their quotes
+				const char *parseFirst(first), *parseLast(last);
+				std::string unescaped;
+				if (delimiter == ',' && last - first >= 2 && *first == '"' && last[-1] == '"')
+				{
+					first++;
+					last--;
+					while (first < last && (*first == ' ' || *first == '\t'))
+						first++;
+					while (last > first && (last[-1] == ' ' || last[-1] == '\t'))
+						last--;
+
+					parseFirst = first;
+					parseLast = last;
+					if (std::find(first, last, '"') != last)
+					{
+						for (const char *quote = first; quote < last; quote++)
+						{
+							unescaped += *quote;
+							if (*quote == '"' && quote + 1 < last && quote[1] == '"')
+								quote++;
+						}
+						parseFirst = unescaped.data();
+						parseLast = parseFirst + unescaped.size();
+					}
+				}
+				lineFields[c] = std::make_pair(first, last);
+
+				// Empty fields are read as NaN, and are left empty
+				double value(std::numeric_limits<double>::quiet_NaN());
+				const char *end;
+				if (parseFirst != parseLast && (!NumberParser::Parse(parseFirst, parseLast, value, end) || end != parseLast))
+				{
+					chunk.errorLine = chunk.lineCount;
+					chunk.error = _T("Cannot read value '") + wxString::FromUTF8(std::string(first, last).c_str())
+						+ _T("' in column '") + columns[c].name + _T("'");
+					return;
+				}
+				values[c].push_back(value);
+			}
+		}
+
+		position = lineEnd == chunk.last ? chunk.last : lineEnd + 1;
+	}
+
+	std::vector<std::vector<double> > results(columnCount);
+	for (unsigned int c = 0; c < columnCount; c++)
+	{
+		results[c].resize(values[c].size());
+		conversions[c]->Evaluate(values[c].data(), results[c].data(), values[c].size());
+	}
+
+	const NumberFormatter::Style style(NumberFormatter::Style::Shortest);
+	std::vector<char> number(NumberFormatter::MaxLength(style, precision));
+	chunk.output.reserve((chunk.last - chunk.first) + (chunk.last - chunk.first) / 4);
+
+	size_t row(0);
+	for (size_t line = 0; line < lineStarts.size(); line++)
+	{
+		const char *position(lineStarts[line]);
+		const char *lineEnd(line + 1 < lineStarts.size() ? lineStarts[line + 1] : chunk.last);
+		const std::pair<const char*, const char*> *lineFields(&fields[line * columnCount]);
+		if (lineFields[0].first)
+		{
+			for (const auto &field : fieldOrder)
+			{
+				const unsigned int &c(field.second);
+				if (std::isnan(values[c][row]))
+					continue;
+
+				chunk.output.append(position, lineFields[c].first);
+				char *numberEnd(NumberFormatter::Format(number.data(),
+					number.data() + number.size(), results[c][row], style, precision));
+				chunk.output.append(number.data(), numberEnd);
+				position = lineFields[c].second;
+			}
+			row++;
+		}
+
+		chunk.output.append(position, lineEnd);
+	}
+}
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		FindFields
+//
+// Description:		Finds the converted fields in one line.  Quoted fields
+//					(when separated by commas) may contain commas and
+//					doubled quotes.
+//
+// Input Arguments:
+//		first	= const char*, start of the line
+//		last	= const char*, end of the line (without the break)
+//
+// Output Arguments:
+//		fields	= std::pair<const char*, const char*>*, start and end of each
+//				  converted field, indexed by column
+//
+// Return Value:
+//		bool, false if the line has too few fields
+//
+//==========================================================================
+bool CSVColumnConverter::FindFields(const char *first, const char *last,
+	std::pair<const char*, const char*> *fields) const
+{
+	size_t next(0);
+	const char *position(first);
+	for (unsigned int index = 0; next < fieldOrder.size(); index++)
+	{
+		const char *fieldStart(position);
+		if (delimiter == ',' && position < last && *position == '"')
+		{
+			position++;
+			while (position < last)
+			{
+				if (*position++ != '"')
+					continue;
+				else if (position < last && *position == '"')
+					position++;
+				else
+					break;
+			}
+		}
+
+		const char *fieldEnd(static_cast<const char*>(memchr(position, delimiter, last - position)));
+		if (!fieldEnd)
+			fieldEnd = last;
+
+		if (index == fieldOrder[next].first)
+			fields[fieldOrder[next++].second] = std::make_pair(fieldStart, fieldEnd);
+
+		if (fieldEnd == last)
+			break;
+		position = fieldEnd + 1;
+	}
+
+	return next == fieldOrder.size();
+}
+
+//==========================================================================
+// Class:			CSVColumnConverter
+// Function:		EndsInQuotedField
+//
+// Description:		Checks whether a comma separated line ends inside a
+//					quoted field, that is, whether the field continues past
+//					the line break.  Quotes are only special at the start of
+//					a field, as in FindFields.
+//
+// Input Arguments:
+//		first	= const char*, start of the line
+//		last	= const char*, end of the line (without the break)
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if a quoted field is not terminated
+//
+//==========================================================================
+bool CSVColumnConverter::EndsInQuotedField(const char *first, const char *last) const
+{
+	for (const char *position = first; position < last; position++)
+	{
+		if (*position == '"')
+		{
+			for (position++; ; position++)
+			{
+				if (position == last)
+					return true;
+				else if (*position == '"' && position + 1 < last && position[1] == '"')
+					position++;
+				else if (*position == '"')
+					break;
+			}
+		}
+
+		position = static_cast<const char*>(memchr(position, delimiter, last - position));
+		if (!position)
+			return false;
+	}
+
+	return false;
+}
@@ -0,0 +1,81 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  csvColumnConverter.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Converts the units of selected columns of a large CSV file.  The
+//				 file is mapped and split into chunks at line breaks, which are
+//				 converted in parallel and written in order.
+// History:
+
+#ifndef _CSV_COLUMN_CONVERTER_H_
+#define _CSV_COLUMN_CONVERTER_H_
+
+// Standard C++ headers
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/string.h>
+
+// Local forward declarations
+class Converter;
+class CompiledConversion;
+
+class CSVColumnConverter
+{
+public:
+	struct Column
+	{
+		wxString name;// One-based number or (with a header) name
+		wxString group, inUnit, outUnit;
+	};
+
+	CSVColumnConverter(const std::vector<Column> &columns, const bool &hasHeader, const int &precision);
+
+	// Fields are separated by tabs if the first line contains one, otherwise
+	// by commas.  Quoted fields may not contain line breaks (such lines are
+	// an error), and converted fields must be numbers, optionally quoted (or
+	// empty, which are left empty).  Every other byte is copied unchanged.  Output stops at the first error.  Returns
+	// an error message (empty on success).
+	wxString Convert(const wxString &fileName, std::ostream &out, Converter &converter);
+
+	static const size_t chunkSize;// [bytes] (chunks end at the next line break)
+	static const unsigned int chunksPerThread;// Converted before waiting for the slowest
+
+private:
+	std::vector<Column> columns;
+	const bool hasHeader;
+	const int precision;
+
+	char delimiter;
+	std::vector<const CompiledConversion*> conversions;// Indexed by column
+	std::vector<std::pair<unsigned int, unsigned int> > fieldOrder;// Field index and column, by field
+
+	struct Chunk
+	{
+		const char *first;
+		const char *last;
+		std::string output;
+		unsigned int lineCount;
+		unsigned int errorLine;// Within the chunk, if error is set
+		wxString error;
+		bool converted;
+	};
+
+	wxString ResolveColumns(const char *header, const char *headerEnd, Converter &converter);
+	void ConvertChunk(Chunk &chunk) const;
+	bool FindFields(const char *first, const char *last,
+		std::pair<const char*, const char*> *fields) const;
+	bool EndsInQuotedField(const char *first, const char *last) const;
+};
+
+#endif// _CSV_COLUMN_CONVERTER_H_
@@ -0,0 +1,842 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  compiledConversion.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Conversion expression compiled into a numeric program for fast
+//				 scalar and batch evaluation.
+// History:
+
+// Standard C++ headers
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <algorithm>
+
+// Local headers
+#include "compiledConversion.h"
+#include "expressionTree.h"
+#include "vectorMath.h"
+#include "numberParser.h"
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Compile
+//
+// Description:		Compiles the specified expression into a stack program.
+//					Terms that are affine in the variable (including constants)
+//					are folded at compile time, so a purely affine expression
+//					(the vast majority of conversions) reduces to a single
+//					multiply-add.  Functions of constants are also folded.
+//
+// Input Arguments:
+//		expression	= const wxString&
+//		variable	= const wxString& representing the input value
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, empty for success, error string otherwise
+//
+//==========================================================================
+wxString CompiledConversion::Compile(const wxString &expression, const wxString &variable)
+{
+	this->expression = expression;
+	program.clear();
+	maxDepth = 0;
+	affine = false;
+
+	ExpressionTree tree;
+	std::queue<wxString> postfix;
+	wxString errorString(tree.GetPostfix(expression, postfix));
+	if (!errorString.IsEmpty())
+		return errorString;
+
+	std::vector<Term> stack;
+	unsigned int depth(0);
+	Operation operation(Operation::Add);
+	while (!postfix.empty())
+	{
+		const wxString next(postfix.front());
+		postfix.pop();
+
+		if (next.Cmp(variable) == 0)
+			stack.push_back(Term{ false, 1.0, 0.0 });
+		else if (next.Cmp(ExpressionTree::unaryMinus) == 0 ||
+			(GetOperation(next, operation) && stack.size() < 2))
+		{
+			// The only unary operator we recognize is minus (negation)
+			if (stack.empty() || (next.Cmp(ExpressionTree::unaryMinus) != 0 &&
+				operation != Operation::Subtract))
+				return _T("Attempting to apply operator without two operands!");
+			Negate(stack.back(), depth);
+		}
+		else if (GetFunction(next, operation))
+		{
+			if (stack.empty())
+				return _T("Not enough arguments for '") + next + _T("'!");
+			ApplyFunction(operation, stack.back(), depth);
+		}
+		else if (GetOperation(next, operation))
+		{
+
+			const Term right(stack.back());
+			stack.pop_back();
+			const Term left(stack.back());
+			stack.pop_back();
+
+			Term result{ true, 0.0, 0.0 };
+			if (!Fold(operation, left, right, result))
+			{
+				Emit(operation, left, right, depth);
+				result.general = true;
+			}
+			stack.push_back(result);
+		}
+		else
+		{
+			double value;
+			if (!NumberParser::Parse(next, value))
+				return _T("Unable to evaluate '") + next + _T("'.");
+			stack.push_back(Term{ false, 0.0, value });
+		}
+	}
+
+	if (stack.size() > 1)
+		return _T("Not enough operators!");
+	else if (stack.size() == 0)
+		return _T("My numbers disappeared!");
+
+	if (!stack.back().general)
+	{
+		affine = true;
+		slope = stack.back().slope;
+		intercept = stack.back().intercept;
+		program.clear();
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		GetOperation
+//
+// Description:		Identifies the operation represented by the string.
+//
+// Input Arguments:
+//		s			= const wxString&
+//
+// Output Arguments:
+//		operation	= Operation&
+//
+// Return Value:
+//		bool, true if the string is a recognized operator
+//
+//==========================================================================
+bool CompiledConversion::GetOperation(const wxString &s, Operation &operation)
+{
+	if (s.Cmp(_T("+")) == 0)
+		operation = Operation::Add;
+	else if (s.Cmp(_T("-")) == 0)
+		operation = Operation::Subtract;
+	else if (s.Cmp(_T("*")) == 0)
+		operation = Operation::Multiply;
+	else if (s.Cmp(_T("/")) == 0)
+		operation = Operation::Divide;
+	else if (s.Cmp(_T("^")) == 0 || s.Cmp(_T("pow")) == 0)
+		operation = Operation::Power;
+	else
+		return false;
+
+	return true;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		GetFunction
+//
+// Description:		Identifies the single-argument function represented by
+//					the string.
+//
+// Input Arguments:
+//		s			= const wxString&
+//
+// Output Arguments:
+//		operation	= Operation&
+//
+// Return Value:
+//		bool, true if the string is a recognized function
+//
+//==========================================================================
+bool CompiledConversion::GetFunction(const wxString &s, Operation &operation)
+{
+	if (s.Cmp(_T("sqrt")) == 0)
+		operation = Operation::Sqrt;
+	else if (s.Cmp(_T("ln")) == 0)
+		operation = Operation::Ln;
+	else if (s.Cmp(_T("log10")) == 0)
+		operation = Operation::Log10;
+	else if (s.Cmp(_T("exp")) == 0)
+		operation = Operation::Exp;
+	else
+		return false;
+
+	return true;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Fold
+//
+// Description:		Attempts to combine two terms at compile time.  Succeeds
+//					if the result remains affine in the variable.
+//
+// Input Arguments:
+//		operation	= const Operation&
+//		left		= const Term&
+//		right		= const Term&
+//
+// Output Arguments:
+//		result		= Term&
+//
+// Return Value:
+//		bool, true if the terms were folded
+//
+//==========================================================================
+bool CompiledConversion::Fold(const Operation &operation, const Term &left,
+	const Term &right, Term &result) const
+{
+	if (left.general || right.general)
+		return false;
+
+	result.general = false;
+	switch (operation)
+	{
+	case Operation::Add:
+		result.slope = left.slope + right.slope;
+		result.intercept = left.intercept + right.intercept;
+		return true;
+
+	case Operation::Subtract:
+		result.slope = left.slope - right.slope;
+		result.intercept = left.intercept - right.intercept;
+		return true;
+
+	case Operation::Multiply:
+		if (left.slope == 0.0)
+		{
+			result.slope = left.intercept * right.slope;
+			result.intercept = left.intercept * right.intercept;
+			return true;
+		}
+		else if (right.slope == 0.0)
+		{
+			result.slope = left.slope * right.intercept;
+			result.intercept = left.intercept * right.intercept;
+			return true;
+		}
+		return false;
+
+	case Operation::Divide:
+		if (right.slope != 0.0)
+			return false;
+		result.slope = left.slope / right.intercept;
+		result.intercept = left.intercept / right.intercept;
+		return true;
+
+	case Operation::Power:
+		if (left.slope != 0.0 || right.slope != 0.0)
+			return false;
+		result.slope = 0.0;
+		result.intercept = pow(left.intercept, right.intercept);
+		return true;
+
+	default:
+		break;
+	}
+
+	return false;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Negate
+//
+// Description:		Negates the specified term, folding if possible.
+//
+// Input Arguments:
+//		term	= Term&
+//		depth	= unsigned int& (current run-time stack depth)
+//
+// Output Arguments:
+//		term	= Term&
+//		depth	= unsigned int&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::Negate(Term &term, unsigned int &depth)
+{
+	if (term.general)
+		Emit(Instruction{ OpCode::Negate, Operation::Subtract, 0.0, 0.0, false }, depth);
+	else
+	{
+		term.slope = -term.slope;
+		term.intercept = -term.intercept;
+	}
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		ApplyFunction
+//
+// Description:		Applies the function to the specified term, folding if
+//					the term is constant.
+//
+// Input Arguments:
+//		function	= const Operation&
+//		term		= Term&
+//		depth		= unsigned int& (current run-time stack depth)
+//
+// Output Arguments:
+//		term		= Term&
+//		depth		= unsigned int&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::ApplyFunction(const Operation &function, Term &term, unsigned int &depth)
+{
+	if (!term.general && term.slope == 0.0)
+	{
+		term.intercept = Apply(function, term.intercept);
+		return;
+	}
+
+	if (!term.general)
+		Emit(Instruction{ OpCode::PushAffine, function, term.slope, term.intercept, false }, depth);
+	Emit(Instruction{ OpCode::Function, function, 0.0, 0.0, false }, depth);
+	term.general = true;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Emit
+//
+// Description:		Emits the instructions required to apply the operation to
+//					the specified terms at run time.  Folded (non-general) terms
+//					are not on the run-time stack, so they are either pushed or
+//					applied as immediate operands.
+//
+// Input Arguments:
+//		operation	= const Operation&
+//		left		= const Term&
+//		right		= const Term&
+//		depth		= unsigned int& (current run-time stack depth)
+//
+// Output Arguments:
+//		depth		= unsigned int&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::Emit(const Operation &operation, const Term &left,
+	const Term &right, unsigned int &depth)
+{
+	if (left.general && right.general)
+		Emit(Instruction{ OpCode::Binary, operation, 0.0, 0.0, false }, depth);
+	else if (left.general)
+		Emit(Instruction{ OpCode::BinaryImmediate, operation, right.slope, right.intercept, false }, depth);
+	else if (right.general)
+		Emit(Instruction{ OpCode::BinaryImmediate, operation, left.slope, left.intercept, true }, depth);
+	else
+	{
+		Emit(Instruction{ OpCode::PushAffine, operation, left.slope, left.intercept, false }, depth);
+		Emit(Instruction{ OpCode::BinaryImmediate, operation, right.slope, right.intercept, false }, depth);
+	}
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Emit
+//
+// Description:		Appends the instruction to the program and tracks the
+//					required stack depth.
+//
+// Input Arguments:
+//		instruction	= const Instruction&
+//		depth		= unsigned int&
+//
+// Output Arguments:
+//		depth		= unsigned int&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::Emit(const Instruction &instruction, unsigned int &depth)
+{
+	program.push_back(instruction);
+	if (instruction.code == OpCode::PushAffine)
+	{
+		depth++;
+		if (depth > maxDepth)
+			maxDepth = depth;
+	}
+	else if (instruction.code == OpCode::Binary)
+	{
+		assert(depth > 1);
+		depth--;
+	}
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Evaluate
+//
+// Description:		Evaluates the compiled expression for a single value.
+//
+// Input Arguments:
+//		value	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double CompiledConversion::Evaluate(const double &value) const
+{
+	if (affine)
+		return slope * value + intercept;
+
+	const unsigned int fixedSize(16);
+	double fixedStack[fixedSize];
+	std::vector<double> dynamicStack;
+	double *stack(fixedStack);
+	if (maxDepth > fixedSize)
+	{
+		dynamicStack.resize(maxDepth);
+		stack = dynamicStack.data();
+	}
+
+	int top(-1);
+	for (const auto &instruction : program)
+	{
+		switch (instruction.code)
+		{
+		case OpCode::PushAffine:
+			stack[++top] = instruction.slope * value + instruction.intercept;
+			break;
+
+		case OpCode::Binary:
+			stack[top - 1] = Apply(instruction.operation, stack[top - 1], stack[top]);
+			top--;
+			break;
+
+		case OpCode::BinaryImmediate:
+			if (instruction.immediateIsLeft)
+				stack[top] = Apply(instruction.operation,
+					instruction.slope * value + instruction.intercept, stack[top]);
+			else
+				stack[top] = Apply(instruction.operation,
+					stack[top], instruction.slope * value + instruction.intercept);
+			break;
+
+		case OpCode::Negate:
+			stack[top] = -stack[top];
+			break;
+
+		case OpCode::Function:
+			stack[top] = Apply(instruction.operation, stack[top]);
+			break;
+		}
+	}
+
+	assert(top == 0);
+	return stack[0];
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Evaluate
+//
+// Description:		Evaluates the compiled expression for an array of values.
+//					Results may alias the input array.
+//
+// Input Arguments:
+//		values	= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		results	= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::Evaluate(const double *values, double *results, const size_t &count) const
+{
+	if (affine)
+	{
+		for (size_t i = 0; i < count; i++)
+			results[i] = slope * values[i] + intercept;
+		return;
+	}
+
+	std::vector<double> stack(maxDepth * blockSize);
+	size_t i;
+	for (i = 0; i + blockSize <= count; i += blockSize)
+		EvaluateBlock(values + i, results + i, stack.data());
+
+	if (i == count)
+		return;
+
+	// Pad the final partial block with a valid input so every lane is well-defined
+	double x[blockSize], y[blockSize];
+	const size_t remaining(count - i);
+	for (size_t j = 0; j < blockSize; j++)
+		x[j] = values[i + std::min(j, remaining - 1)];
+
+	EvaluateBlock(x, y, stack.data());
+	for (size_t j = 0; j < remaining; j++)
+		results[i + j] = y[j];
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		EvaluateBlock
+//
+// Description:		Evaluates the program over one block of values.  Each
+//					instruction is applied across the whole block before the
+//					next is considered, so the inner loops have fixed trip
+//					counts and no branches.
+//
+// Input Arguments:
+//		x		= const double* (blockSize values)
+//		stack	= double* (scratch space of maxDepth * blockSize values)
+//
+// Output Arguments:
+//		y		= double* (blockSize values)
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::EvaluateBlock(const double *x, double *y, double *stack) const
+{
+	double *top(stack - blockSize);
+	for (const auto &instruction : program)
+	{
+		switch (instruction.code)
+		{
+		case OpCode::PushAffine:
+			top += blockSize;
+			for (size_t i = 0; i < blockSize; i++)
+				top[i] = instruction.slope * x[i] + instruction.intercept;
+			break;
+
+		case OpCode::Binary:
+			Apply(instruction.operation, top - blockSize, top);
+			top -= blockSize;
+			break;
+
+		case OpCode::BinaryImmediate:
+			ApplyImmediate(instruction, top, x);
+			break;
+
+		case OpCode::Negate:
+			for (size_t i = 0; i < blockSize; i++)
+				top[i] = -top[i];
+			break;
+
+		case OpCode::Function:
+			Apply(instruction.operation, top);
+			break;
+		}
+	}
+
+	assert(top == stack);
+	for (size_t i = 0; i < blockSize; i++)
+		y[i] = stack[i];
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Apply
+//
+// Description:		Applies the specified operation to the specified operands.
+//
+// Input Arguments:
+//		operation	= const Operation&
+//		left		= const double&
+//		right		= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double CompiledConversion::Apply(const Operation &operation, const double &left, const double &right)
+{
+	switch (operation)
+	{
+	case Operation::Add:
+		return left + right;
+
+	case Operation::Subtract:
+		return left - right;
+
+	case Operation::Multiply:
+		return left * right;
+
+	case Operation::Divide:
+		return left / right;
+
+	case Operation::Power:
+		return pow(left, right);
+
+	default:
+		break;
+	}
+
+	assert(false);
+	return 0.0;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Apply
+//
+// Description:		Applies the specified function to the specified value.
+//
+// Input Arguments:
+//		function	= const Operation&
+//		value		= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double CompiledConversion::Apply(const Operation &function, const double &value)
+{
+	switch (function)
+	{
+	case Operation::Sqrt:
+		return sqrt(value);
+
+	case Operation::Ln:
+		return log(value);
+
+	case Operation::Log10:
+		return log10(value);
+
+	case Operation::Exp:
+		return exp(value);
+
+	default:
+		break;
+	}
+
+	assert(false);
+	return 0.0;
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Apply
+//
+// Description:		Applies the specified function across a block in place.
+//
+// Input Arguments:
+//		function	= const Operation&
+//		top			= double* (blockSize values)
+//
+// Output Arguments:
+//		top			= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::Apply(const Operation &function, double *top)
+{
+	switch (function)
+	{
+	case Operation::Sqrt:
+		VectorMath::Sqrt(top, top, blockSize);
+		break;
+
+	case Operation::Ln:
+		VectorMath::Log(top, top, blockSize);
+		break;
+
+	case Operation::Log10:
+		VectorMath::Log10(top, top, blockSize);
+		break;
+
+	case Operation::Exp:
+		VectorMath::Exp(top, top, blockSize);
+		break;
+
+	default:
+		assert(false);
+		break;
+	}
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		Apply
+//
+// Description:		Applies the specified operation across a block, storing
+//					the result in the left operand.
+//
+// Input Arguments:
+//		operation	= const Operation&
+//		left		= double* (blockSize values)
+//		right		= const double* (blockSize values)
+//
+// Output Arguments:
+//		left		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::Apply(const Operation &operation, double *left, const double *right)
+{
+	size_t i;
+	switch (operation)
+	{
+	case Operation::Add:
+		for (i = 0; i < blockSize; i++)
+			left[i] += right[i];
+		break;
+
+	case Operation::Subtract:
+		for (i = 0; i < blockSize; i++)
+			left[i] -= right[i];
+		break;
+
+	case Operation::Multiply:
+		for (i = 0; i < blockSize; i++)
+			left[i] *= right[i];
+		break;
+
+	case Operation::Divide:
+		for (i = 0; i < blockSize; i++)
+			left[i] /= right[i];
+		break;
+
+	case Operation::Power:
+		VectorMath::Pow(left, right, left, blockSize);
+		break;
+
+	default:
+		assert(false);
+		break;
+	}
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		ApplyImmediate
+//
+// Description:		Applies an operation between the top of the stack and an
+//					immediate affine operand, storing the result on the stack.
+//
+// Input Arguments:
+//		instruction	= const Instruction&
+//		top			= double* (blockSize values)
+//		x			= const double* (blockSize values)
+//
+// Output Arguments:
+//		top			= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::ApplyImmediate(const Instruction &instruction, double *top, const double *x)
+{
+	double immediate[blockSize];
+	for (size_t i = 0; i < blockSize; i++)
+		immediate[i] = instruction.slope * x[i] + instruction.intercept;
+
+	if (instruction.immediateIsLeft)
+		ApplyImmediateLeft(instruction.operation, immediate, top);
+	else
+		Apply(instruction.operation, top, immediate);
+}
+
+//==========================================================================
+// Class:			CompiledConversion
+// Function:		ApplyImmediateLeft
+//
+// Description:		Applies the specified operation across a block, storing
+//					the result in the right operand.
+//
+// Input Arguments:
+//		operation	= const Operation&
+//		left		= const double* (blockSize values)
+//		right		= double* (blockSize values)
+//
+// Output Arguments:
+//		right		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CompiledConversion::ApplyImmediateLeft(const Operation &operation, const double *left, double *right)
+{
+	size_t i;
+	switch (operation)
+	{
+	case Operation::Add:
+		for (i = 0; i < blockSize; i++)
+			right[i] = left[i] + right[i];
+		break;
+
+	case Operation::Subtract:
+		for (i = 0; i < blockSize; i++)
+			right[i] = left[i] - right[i];
+		break;
+
+	case Operation::Multiply:
+		for (i = 0; i < blockSize; i++)
+			right[i] = left[i] * right[i];
+		break;
+
+	case Operation::Divide:
+		for (i = 0; i < blockSize; i++)
+			right[i] = left[i] / right[i];
+		break;
+
+	case Operation::Power:
+		VectorMath::Pow(left, right, right, blockSize);
+		break;
+
+	default:
+		assert(false);
+		break;
+	}
+}
@@ -0,0 +1,112 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  compiledConversion.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Conversion expression compiled into a numeric program for fast
+//				 scalar and batch evaluation.
+// History:
+
+#ifndef _COMPILED_CONVERSION_H_
+#define _COMPILED_CONVERSION_H_
+
+// Standard C++ headers
+#include <vector>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+class CompiledConversion
+{
+public:
+	CompiledConversion() = default;
+	~CompiledConversion() = default;
+
+	wxString Compile(const wxString &expression, const wxString &variable = _T("x"));
+
+	double Evaluate(const double &value) const;
+	void Evaluate(const double *values, double *results, const size_t &count) const;
+
+	bool IsAffine() const { return affine; };
+	double GetSlope() const { return slope; };
+	double GetIntercept() const { return intercept; };
+	wxString GetExpression() const { return expression; };
+
+	// Values are evaluated in fixed-size blocks so the inner loops vectorize
+	static constexpr size_t blockSize = 64;
+
+private:
+	wxString expression;
+
+	enum class OpCode
+	{
+		PushAffine,// Push slope * x + intercept
+		Binary,// Apply operation to the top two stack entries
+		BinaryImmediate,// Apply operation to the top entry and slope * x + intercept
+		Negate,
+		Function// Apply a single-argument function to the top entry
+	};
+
+	enum class Operation
+	{
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Power,
+		Sqrt,
+		Ln,
+		Log10,
+		Exp
+	};
+
+	struct Instruction
+	{
+		OpCode code;
+		Operation operation;
+		double slope;
+		double intercept;
+		bool immediateIsLeft;
+	};
+
+	// Compile-time representation of a stack entry; non-general entries
+	// are folded and not yet present on the run-time stack
+	struct Term
+	{
+		bool general;
+		double slope;
+		double intercept;
+	};
+
+	std::vector<Instruction> program;
+	unsigned int maxDepth = 0;
+
+	bool affine = false;
+	double slope = 0.0;
+	double intercept = 0.0;
+
+	static bool GetOperation(const wxString &s, Operation &operation);
+	static bool GetFunction(const wxString &s, Operation &operation);
+	bool Fold(const Operation &operation, const Term &left, const Term &right, Term &result) const;
+	void Negate(Term &term, unsigned int &depth);
+	void ApplyFunction(const Operation &function, Term &term, unsigned int &depth);
+	void Emit(const Operation &operation, const Term &left, const Term &right, unsigned int &depth);
+	void Emit(const Instruction &instruction, unsigned int &depth);
+
+	static double Apply(const Operation &operation, const double &left, const double &right);
+	static double Apply(const Operation &function, const double &value);
+	static void Apply(const Operation &function, double *top);
+	static void Apply(const Operation &operation, double *left, const double *right);
+	static void ApplyImmediate(const Instruction &instruction, double *top, const double *x);
+	static void ApplyImmediateLeft(const Operation &operation, const double *left, double *right);
+
+	void EvaluateBlock(const double *x, double *y, double *stack) const;
+};
+
+#endif// _COMPILED_CONVERSION_H_
@@ -12,11 +12,16 @@
 // Description:  Math helpers.
 // History:
 
+// Standard C++ headers
+#include <string>
+
 // wxWidgets headers
 #include <wx/wx.h>
 
 // Local headers
 #include "convertMath.h"
+#include "numberFormatter.h"
+#include "numberParser.h"
 
 //==========================================================================
 // Namespace:		ConvertMath
@@ -37,40 +42,76 @@
 unsigned int ConvertMath::CountSignificantDigits(const wxString &valueString)
 {
 	double value;
-	if (!valueString.ToDouble(&value))
+	if (!NumberParser::Parse(valueString, value))
 		return 0;
 
-	wxString trimmedValueString = valueString;
-	if (trimmedValueString.Contains(_T("e")))
-		trimmedValueString = trimmedValueString.Mid(0, trimmedValueString.Find(_T("e")));
-	else if (trimmedValueString.Contains(_T("E")))
-		trimmedValueString = trimmedValueString.Mid(0, trimmedValueString.Find(_T("E")));
+	wxString trimmedValueString(valueString);
+	trimmedValueString.Trim().Trim(false);
 
-	int firstDigit, lastDigit;
-	for (firstDigit = 0; firstDigit < (int)trimmedValueString.Len(); firstDigit++)
-	{
-		if (trimmedValueString[firstDigit] != '0' && trimmedValueString[firstDigit] != '.' &&
-			trimmedValueString[firstDigit] != '+' && trimmedValueString[firstDigit] != '-')
-			break;
-	}
+	const std::string text(trimmedValueString.mb_str());
+	return CountSignificantDigits(text.data(), text.data() + text.size());
+}
 
-	for (lastDigit = trimmedValueString.Len() - 1; lastDigit > firstDigit; lastDigit--)
-	{
-		if (trimmedValueString[lastDigit] != '0' && trimmedValueString[lastDigit] != '.' &&
-			trimmedValueString[lastDigit] != '+' && trimmedValueString[lastDigit] != '-')
-			break;
-	}
+//==========================================================================
+// Namespace:		ConvertMath
+// Function:		CountSignificantDigits
+//
+// Description:		Returns the number of significant digits in the number
+//					starting at first.  Leading zeros are never significant;
+//					trailing zeros are significant only when a decimal point
+//					is present (so 1200 has two, 1200. has four and 0.0120 has
+//					three).  Zero is considered to have one significant digit.
+//
+// Input Arguments:
+//		first	= const char*
+//		last	= const char*
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		unsigned int
+//
+//==========================================================================
+unsigned int ConvertMath::CountSignificantDigits(const char *first, const char *last)
+{
+	if (first != last && (*first == '+' || *first == '-'))
+		first++;
 
-	for (int i = firstDigit + 1; i < lastDigit; i++)
+	unsigned int count(0), pendingZeros(0);
+	bool foundDigit(false), afterPoint(false);
+	for (; first != last; first++)
 	{
-		if (trimmedValueString[i] == '.')
+		if (*first == '.' && !afterPoint)
 		{
-			firstDigit++;
+			// Zeros between the last non-zero digit and the point now count
+			afterPoint = true;
+			count += pendingZeros;
+			pendingZeros = 0;
+			continue;
+		}
+		else if (*first < '0' || *first > '9')
 			break;
+
+		foundDigit = true;
+		if (*first != '0')
+		{
+			count += pendingZeros + 1;
+			pendingZeros = 0;
+		}
+		else if (count > 0)
+		{
+			if (afterPoint)
+				count++;
+			else
+				pendingZeros++;
 		}
 	}
 
-	return lastDigit - firstDigit + 1;
+	if (count == 0 && foundDigit)
+		return 1;
+
+	return count;
 }
 
 //==========================================================================
@@ -102,14 +143,11 @@ unsigned int ConvertMath::GetPrecision(const double &value,
 	if (!dropTrailingZeros)
 		return precision;
 
-	const unsigned int sSize(512);
-	char s[sSize];
-	KRLsprintf(s, sSize, "%0.*f", precision, value);
-
-	std::string number(s);
-	for (size_t i = number.size() - 1; i > 0; i--)
+	const wxString number(NumberFormatter::Format(value,
+		NumberFormatter::Style::Fixed, precision));
+	for (size_t i = number.Len() - 1; i > 0; i--)
 	{
-		if (s[i] == '0')
+		if (number[i] == '0')
 			precision--;
 		else
 			break;
@@ -120,40 +158,3 @@ unsigned int ConvertMath::GetPrecision(const double &value,
 
 	return precision;
 }
-
-//==========================================================================
-// Namespace:		ConvertMath
-// Function:		KRLsprintf
-//
-// Description:		Cross-platform friendly sprintf(_s) macro.  Calls sprintf_s
-//					under MSW, sprintf otherwise.
-//
-// Input Arguments:
-//		dest	= char*
-//		size	= const unsigned int&
-//		format	= const char*
-//
-// Output Arguments:
-//		None
-//
-// Return Value:
-//		None
-//
-//==========================================================================
-#ifdef __WXMSW__
-void ConvertMath::KRLsprintf(char *dest, const unsigned int &size, const char *format, ...)
-#else
-void ConvertMath::KRLsprintf(char *dest, const unsigned int &, const char *format, ...)
-#endif
-{
-	va_list list;
-	va_start(list, format);
-
-#ifdef __WXMSW__
-	vsprintf_s(dest, size, format, list);
-#else
-	vsprintf(dest, format, list);
-#endif
-
-	va_end(list);
-}
@@ -21,11 +21,10 @@ class wxString;
 namespace ConvertMath
 {
 	unsigned int CountSignificantDigits(const wxString &valueString);
+	unsigned int CountSignificantDigits(const char *first, const char *last);
 
 	unsigned int GetPrecision(const double &value,
 		const unsigned int &significantDigits = 2, const bool &dropTrailingZeros = true);
-
-	void KRLsprintf(char *dest, const unsigned int &size, const char *format, ...);
 }
 
 #endif// _CONVERT_MATH_H_
\ No newline at end of file
@@ -14,10 +14,12 @@
 // Standard C++ headers
 #include <queue>
 #include <stdexcept>
+#include <algorithm>
 
 // Local headers
 #include "converter.h"
 #include "expressionTree.h"
+#include "messageReporter.h"
 
 //==========================================================================
 // Class:			Converter
@@ -26,7 +28,7 @@
 // Description:		Constructor for Converter class.
 //
 // Input Arguments:
-//		xml	= const XMLConversionFactors&
+//		catalog	= const LayeredCatalog&
 //
 // Output Arguments:
 //		None
@@ -35,9 +37,11 @@
 //		None
 //
 //==========================================================================
-Converter::Converter(const XMLConversionFactors &xml) : xml(xml)
+Converter::Converter(const LayeredCatalog &catalog) : catalog(catalog)
 {
-	setlocale(LC_ALL, "");// Do this to ensure we can convert unicode strings
+	// Do this to ensure we can convert unicode strings (LC_NUMERIC stays "C" so
+	// numbers are always read and written with '.' as the decimal point)
+	setlocale(LC_CTYPE, "");
 }
 
 //==========================================================================
@@ -64,82 +68,291 @@ double Converter::Convert(const wxString &group, const wxString &inUnit,
 {
 	try
 	{
-		return EvaluateConversion(value, GetConversion(group, inUnit, outUnit));
+		return GetConversion(group, inUnit, outUnit).Evaluate(value);
 	}
 	catch (std::exception &e)
 	{
 		wxString message(_T("Error evaluating conversion!\n\n"));
 		message.Append(wxString(e.what(), wxConvUTF8));
-		wxMessageBox(message, _T("Error"), wxICON_ERROR);
+		MessageReporter::Error(message);
 		return value;
 	}
 }
 
 //==========================================================================
 // Class:			Converter
-// Function:		EvaluateConversion
+// Function:		CanConvert
 //
-// Description:		Evaluates the specified conversion string with the specified
-//					input value.
+// Description:		Checks whether a conversion path exists between the
+//					specified units, without searching for it.
 //
 // Input Arguments:
-//		value				= const double&
-//		conversionString	= wxString
+//		group	= const wxString&
+//		inUnit	= const wxString&
+//		outUnit	= const wxString&
 //
 // Output Arguments:
 //		None
 //
 // Return Value:
-//		double
+//		bool
+//
+//==========================================================================
+bool Converter::CanConvert(const wxString &group, const wxString &inUnit,
+	const wxString &outUnit) const
+{
+	const int i(catalog.FindGroup(group));
+	if (i == wxNOT_FOUND)
+		return false;
+
+	const XMLConversionFactors::FactorGroup &factorGroup(catalog.GetGroup(i));
+	const int in(factorGroup.FindUnit(inUnit)), out(factorGroup.FindUnit(outUnit));
+	return in != wxNOT_FOUND && out != wxNOT_FOUND &&
+		factorGroup.GetComponent(in) == factorGroup.GetComponent(out);
+}
+
+//==========================================================================
+// Class:			Converter
+// Function:		Convert
+//
+// Description:		Performs the specified conversion on an array of values.
+//					If an approximation has been compiled for this conversion,
+//					it is used for values within the approximated range.
+//					Results may alias the input array.
+//
+// Input Arguments:
+//		group	= const wxString&
+//		inUnit	= const wxString&
+//		outUnit	= const wxString&
+//		values	= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		results	= double*
+//
+// Return Value:
+//		None
 //
 //==========================================================================
-double Converter::EvaluateConversion(const double &value, wxString conversionString)
+void Converter::Convert(const wxString &group, const wxString &inUnit,
+	const wxString &outUnit, const double *values, double *results, const size_t &count)
 {
-	ExpressionTree tree;
-	double result;
-	conversionString.Replace(_T("x"), wxString::Format(_T("%0.15f"), value));
-	wxString errors = tree.Solve(conversionString, result);
+	Cache<ChebyshevApproximation>::const_iterator it(Find(approximations,
+		GetConversionHash(group, inUnit, outUnit), group, inUnit, outUnit));
+	if (it == approximations.end())
+	{
+		ConvertExact(group, inUnit, outUnit, values, results, count);
+		return;
+	}
+
+	const CompiledConversion &exact(GetConversion(group, inUnit, outUnit));
+	const ChebyshevApproximation &approximation(it->second.second);
 
-	if (!errors.IsEmpty())
+	size_t i;
+	for (i = 0; i < count && approximation.InRange(values[i]); i++)
 	{
-		wxMessageBox(errors, _T("Evaluation Error"), wxICON_ERROR);
-		result = 0.0;
 	}
 
-	return result;
+	if (i == count)
+	{
+		approximation.Evaluate(values, results, count);
+		return;
+	}
+
+	// Out-of-range values (and NaN) are converted exactly.  Each kind is
+	// gathered (before results potentially overwrites values), converted
+	// together and scattered back.
+	std::vector<size_t> inIndices, outIndices;
+	std::vector<double> inValues, outValues;
+	for (i = 0; i < count; i++)
+	{
+		if (approximation.InRange(values[i]))
+		{
+			inIndices.push_back(i);
+			inValues.push_back(values[i]);
+		}
+		else
+		{
+			outIndices.push_back(i);
+			outValues.push_back(values[i]);
+		}
+	}
+
+	approximation.Evaluate(inValues.data(), inValues.data(), inValues.size());
+	exact.Evaluate(outValues.data(), outValues.data(), outValues.size());
+	for (i = 0; i < inIndices.size(); i++)
+		results[inIndices[i]] = inValues[i];
+	for (i = 0; i < outIndices.size(); i++)
+		results[outIndices[i]] = outValues[i];
 }
 
 //==========================================================================
 // Class:			Converter
-// Function:		GetConversion
+// Function:		ConvertExact
 //
-// Description:		Gets the conversion string for the specified group and units.
+// Description:		Performs the specified conversion on an array of values,
+//					always using the exact compiled expression.  Results may
+//					alias the input array.
 //
 // Input Arguments:
 //		group	= const wxString&
 //		inUnit	= const wxString&
 //		outUnit	= const wxString&
+//		values	= const double*
+//		count	= const size_t&
 //
 // Output Arguments:
+//		results	= double*
+//
+// Return Value:
 //		None
 //
+//==========================================================================
+void Converter::ConvertExact(const wxString &group, const wxString &inUnit,
+	const wxString &outUnit, const double *values, double *results, const size_t &count)
+{
+	try
+	{
+		GetConversion(group, inUnit, outUnit).Evaluate(values, results, count);
+	}
+	catch (std::exception &e)
+	{
+		wxString message(_T("Error evaluating conversion!\n\n"));
+		message.Append(wxString(e.what(), wxConvUTF8));
+		MessageReporter::Error(message);
+		if (results != values)
+			std::copy(values, values + count, results);
+	}
+}
+
+//==========================================================================
+// Class:			Converter
+// Function:		Compile
+//
+// Description:		Gets the compiled conversion for the specified group and
+//					units, compiling it if necessary.
+//
+// Input Arguments:
+//		group	= const wxString&
+//		inUnit	= const wxString&
+//		outUnit	= const wxString&
+//
+// Output Arguments:
+//		conversion	= const CompiledConversion*&, NULL on error
+//
 // Return Value:
-//		wxString
+//		wxString, empty for success, error message otherwise
 //
 //==========================================================================
-wxString Converter::GetConversion(const wxString &group, const wxString &inUnit,
-	const wxString &outUnit)
+wxString Converter::Compile(const wxString &group, const wxString &inUnit,
+	const wxString &outUnit, const CompiledConversion *&conversion)
+{
+	conversion = nullptr;
+	try
+	{
+		conversion = &GetConversion(group, inUnit, outUnit);
+	}
+	catch (std::exception &e)
+	{
+		return wxString(e.what(), wxConvUTF8);
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			Converter
+// Function:		CompileApproximation
+//
+// Description:		Fits a piecewise Chebyshev approximation to the specified
+//					conversion over the specified input range.  Once compiled,
+//					the approximation is used by the array form of Convert()
+//					until the cache is cleared.  Intended for conversions that
+//					are not affine (affine conversions are already evaluated
+//					with a single multiply-add).
+//
+// Input Arguments:
+//		group		= const wxString&
+//		inUnit		= const wxString&
+//		outUnit		= const wxString&
+//		minimum		= const double&
+//		maximum		= const double&
+//		tolerance	= const double& (see ChebyshevApproximation::Fit)
+//
+// Output Arguments:
+//		maximumError	= double&
+//
+// Return Value:
+//		bool, true if the approximation was compiled within tolerance
+//
+//==========================================================================
+bool Converter::CompileApproximation(const wxString &group, const wxString &inUnit,
+	const wxString &outUnit, const double &minimum, const double &maximum,
+	const double &tolerance, double &maximumError)
 {
-	std::string code = GetConversionCode(group, inUnit, outUnit);
-	std::map<std::string, wxString>::const_iterator it = conversions.find(code);
+	const size_t hash(GetConversionHash(group, inUnit, outUnit));
+	Cache<ChebyshevApproximation>::iterator it(Find(approximations, hash, group, inUnit, outUnit));
+	if (it != approximations.end())
+		approximations.erase(it);
 
+	try
+	{
+		const CompiledConversion &exact(GetConversion(group, inUnit, outUnit));
+		if (exact.IsAffine())
+		{
+			maximumError = 0.0;
+			return true;
+		}
+
+		ChebyshevApproximation approximation;
+		if (!approximation.Fit(exact, minimum, maximum, tolerance))
+			return false;
+
+		maximumError = approximation.GetMaximumError();
+		ConversionKey key = { group, inUnit, outUnit };
+		approximations.insert(std::make_pair(hash, std::make_pair(key, approximation)));
+	}
+	catch (std::exception &)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			Converter
+// Function:		GetConversion
+//
+// Description:		Gets the compiled conversion for the specified group and units.
+//
+// Input Arguments:
+//		group	= const wxString&
+//		inUnit	= const wxString&
+//		outUnit	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const CompiledConversion&
+//
+//==========================================================================
+const CompiledConversion& Converter::GetConversion(const wxString &group,
+	const wxString &inUnit, const wxString &outUnit)
+{
+	const size_t hash(GetConversionHash(group, inUnit, outUnit));
+	Cache<CompiledConversion>::const_iterator it(Find(conversions, hash, group, inUnit, outUnit));
 	if (it != conversions.end())
-		return it->second;
+		return it->second.second;
 
-	wxString conversionString(CreateConversion(group, inUnit, outUnit));
-	conversions.insert(std::make_pair(code, conversionString));
+	CompiledConversion conversion;
+	wxString errorString(conversion.Compile(CreateConversion(group, inUnit, outUnit)));
+	if (!errorString.IsEmpty())
+		throw std::runtime_error(std::string(errorString.mb_str()));
 
-	return conversionString;
+	ConversionKey key = { group, inUnit, outUnit };
+	return conversions.insert(std::make_pair(hash, std::make_pair(key, conversion)))->second.second;
 }
 
 //==========================================================================
@@ -162,6 +375,30 @@ wxString Converter::GetConversion(const wxString &group, const wxString &inUnit,
 void Converter::ClearCache()
 {
 	conversions.clear();
+	approximations.clear();
+}
+
+//==========================================================================
+// Class:			Converter
+// Function:		ClearCache
+//
+// Description:		Clears the cached conversions for the specified groups
+//					(after those groups were changed).
+//
+// Input Arguments:
+//		groups	= const std::set<wxString>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void Converter::ClearCache(const std::set<wxString> &groups)
+{
+	Erase(conversions, groups);
+	Erase(approximations, groups);
 }
 
 //==========================================================================
@@ -185,17 +422,15 @@ void Converter::ClearCache()
 wxString Converter::CreateConversion(const wxString &group, const wxString &inUnit,
 		const wxString &outUnit) const
 {
-	wxString expression;
-	for (unsigned int i = 0; i < xml.GroupCount(); i++)
-	{
-		if (xml.GetGroup(i).name.Cmp(group) == 0)
-		{
-			expression = FindConversionPath(xml.GetGroup(i), inUnit, outUnit);
-			break;
-		}
-	}
+	const int i(catalog.FindGroup(group));
+	if (i == wxNOT_FOUND)
+		return wxEmptyString;
+
+	const XMLConversionFactors::FactorGroup &factorGroup(catalog.GetGroup(i));
+	if (factorGroup.equiv.empty())// Group could not be read
+		throw std::runtime_error(std::string((_T("Cannot read group '") + group + _T("'")).mb_str()));
 
-	return expression;
+	return FindConversionPath(factorGroup, inUnit, outUnit);
 }
 
 //==========================================================================
@@ -222,7 +457,7 @@ wxString Converter::SolveForA(const wxString &e)
 
 	if (!errorString.IsEmpty())
 	{
-		wxMessageBox(errorString, _T("Error"), wxICON_ERROR);
+		MessageReporter::Error(errorString);
 		return wxEmptyString;
 	}
 
@@ -253,7 +488,7 @@ wxString Converter::SolveForB(const wxString &e)
 
 	if (!errorString.IsEmpty())
 	{
-		wxMessageBox(errorString, _T("Error"), wxICON_ERROR);
+		MessageReporter::Error(errorString);
 		return wxEmptyString;
 	}
 
@@ -282,61 +517,66 @@ wxString Converter::SolveForB(const wxString &e)
 wxString Converter::FindConversionPath(const XMLConversionFactors::FactorGroup &group,
 	const wxString &inUnit, const wxString &outUnit) const
 {
-	ConversionGraph graph(group);
-	std::queue<Converter::ConversionGraph::GraphNode*> q;
-	Converter::ConversionGraph::GraphNode* n;
-	q.push(graph.GetNode(outUnit));
-	wxASSERT(q.front());
-	q.front()->visited = true;
-	std::set<Converter::ConversionGraph::GraphNode*>::iterator i;
-	while (!q.empty())
+	// Units in different components are rejected without a search
+	const int in(group.FindUnit(inUnit)), out(group.FindUnit(outUnit));
+	if (in != wxNOT_FOUND && out != wxNOT_FOUND &&
+		group.GetComponent(in) == group.GetComponent(out))
 	{
-		n = q.front();
-		q.pop();
-		if (n->name.Cmp(inUnit) == 0)
-			return n->path;
+		ConversionGraph graph(group);
+		std::queue<Converter::ConversionGraph::GraphNode*> q;
+		Converter::ConversionGraph::GraphNode* n(graph.GetNode(outUnit));
+		n->visited = true;
+		q.push(n);
 
-		for (i = n->GetNeighbors().begin(); i != n->GetNeighbors().end(); i++)
+		while (!q.empty())
 		{
-			if (!(*i)->visited)
+			n = q.front();
+			q.pop();
+			if (n->name.Cmp(inUnit) == 0)
+				return n->path;
+
+			// Only the group's path tree is in the graph, so the path does not
+			// depend on the order of the equivalences
+			for (const auto &edge : n->GetNeighbors())
 			{
-				(*i)->visited = true;
-				(*i)->path = n->path;
-				for (size_t j = 0; j < group.equiv.size(); j++)
+				Converter::ConversionGraph::GraphNode *next(edge.node);
+				if (!next->visited)
 				{
-					if (group.equiv[j].aUnit.Cmp((*i)->name) == 0 &&
-						group.equiv[j].bUnit.Cmp(n->name) == 0)
+					next->visited = true;
+					next->path = n->path;
+					const XMLConversionFactors::Equivalence &equiv(group.equiv[edge.equivalence]);
+					if (edge.nodeIsA)
 					{
-						(*i)->path.Replace(_T("x"), _T("(") + SolveForB(group.equiv[j].equation) + _T(")"));
-						(*i)->path.Replace(_T("a"), _T("x"));
-						break;
+						ExpressionTree::ReplaceVariable(next->path, _T("x"), _T("(") + (equiv.bSolution.IsEmpty() ?
+							SolveForB(equiv.equation) : equiv.bSolution) + _T(")"));
+						ExpressionTree::ReplaceVariable(next->path, _T("a"), _T("x"));
 					}
-					else if (group.equiv[j].bUnit.Cmp((*i)->name) == 0 &&
-						group.equiv[j].aUnit.Cmp(n->name) == 0)
+					else
 					{
-						(*i)->path.Replace(_T("x"), _T("(") + SolveForA(group.equiv[j].equation) + _T(")"));
-						(*i)->path.Replace(_T("b"), _T("x"));
-						break;
+						ExpressionTree::ReplaceVariable(next->path, _T("x"), _T("(") + (equiv.aSolution.IsEmpty() ?
+							SolveForA(equiv.equation) : equiv.aSolution) + _T(")"));
+						ExpressionTree::ReplaceVariable(next->path, _T("b"), _T("x"));
 					}
-				}
 
-				ExpressionTree::Clean((*i)->path, _T("x"));
-				q.push(*i);
+					ExpressionTree::Clean(next->path, _T("x"));
+					q.push(next);
+				}
 			}
 		}
 	}
 
 	wxString errorMessage(_T("Could not find path from '") + inUnit
-		+ _T("' to '") + outUnit + _T("'.\nCheck that ") + xml.GetFileName()
-		+ _T(" is encoded as ") + xml.xmlEncoding + _T("."));
+		+ _T("' to '") + outUnit + _T("'.\nCheck that the catalogs are encoded as ")
+		+ XMLConversionFactors::xmlEncoding + _T("."));
 	throw std::runtime_error(std::string(errorMessage.mb_str()));
 }
 
 //==========================================================================
 // Class:			Converter
-// Function:		GetConversionCode
+// Function:		GetConversionHash
 //
-// Description:		Generates the conversion code from the group and units.
+// Description:		Hashes the group and unit names (for the conversion and
+//					approximation caches).
 //
 // Input Arguments:
 //		group	= const wxString&
@@ -347,15 +587,17 @@ wxString Converter::FindConversionPath(const XMLConversionFactors::FactorGroup &
 //		None
 //
 // Return Value:
-//		wxString
+//		size_t
 //
 //==========================================================================
-std::string Converter::GetConversionCode(const wxString &group, const wxString &inUnit,
+size_t Converter::GetConversionHash(const wxString &group, const wxString &inUnit,
 	const wxString &outUnit)
 {
-	wxString code(group + _T(":") + inUnit + _T("->") + outUnit);
-	wxASSERT(!std::string(code.mb_str()).empty());
-	return std::string(code.mb_str());
+	// The separators keep ("ab", "c") and ("a", "bc") apart
+	uint64_t hash(StringHash::Hash(group));
+	hash = StringHash::Hash(inUnit, hash * 31 + 1);
+	hash = StringHash::Hash(outUnit, hash * 31 + 2);
+	return static_cast<size_t>(hash);
 }
 
 //==========================================================================
@@ -376,20 +618,22 @@ std::string Converter::GetConversionCode(const wxString &group, const wxString &
 //
 //==========================================================================
 Converter::ConversionGraph::ConversionGraph(const XMLConversionFactors::FactorGroup &group)
+	: group(group)
 {
-	GraphNode *node;
-	wxArrayString unitList = group.GetUnitList();
+	const wxArrayString &unitList(group.GetUnitList());
+	nodes.reserve(unitList.Count());
 	for (size_t i = 0; i < unitList.Count(); i++)
+		nodes.push_back(new GraphNode(unitList[i]));
+
+	for (size_t j = 0; j < group.equiv.size(); j++)
 	{
-		node = GetOrCreateNode(unitList[i]);
+		if (!group.equiv[j].pathEdge)
+			continue;
 
-		for (size_t j = 0; j < group.equiv.size(); j++)
-		{
-			if (group.equiv[j].aUnit.Cmp(node->name) == 0)
-				node->AddNeighbor(GetOrCreateNode(group.equiv[j].bUnit));
-			else if (group.equiv[j].bUnit.Cmp(node->name) == 0)
-				node->AddNeighbor(GetOrCreateNode(group.equiv[j].aUnit));
-		}
+		GraphNode *a(nodes[group.FindUnit(group.equiv[j].aUnit)]);
+		GraphNode *b(nodes[group.FindUnit(group.equiv[j].bUnit)]);
+		a->AddNeighbor(Edge{ b, j, false });
+		b->AddNeighbor(Edge{ a, j, true });
 	}
 }
 
@@ -412,40 +656,8 @@ Converter::ConversionGraph::ConversionGraph(const XMLConversionFactors::FactorGr
 //==========================================================================
 Converter::ConversionGraph::~ConversionGraph()
 {
-	std::set<GraphNode*>::iterator i;
-	for (i = nodes.begin(); i != nodes.end(); i++)
-		delete *i;
-}
-
-//==========================================================================
-// Class:			Converter::ConversionGraph
-// Function:		GetOrCreateNode
-//
-// Description:		Finds node with matching name.  Creates a new node if no
-//					match is found.
-//
-// Input Arguments:
-//		name	= const wxString&
-//
-// Output Arguments:
-//		None
-//
-// Return Value:
-//		Converter::ConversionGraph::GraphNode*
-//
-//==========================================================================
-Converter::ConversionGraph::GraphNode*
-	Converter::ConversionGraph::GetOrCreateNode(const wxString &name)
-{
-	GraphNode *node = GetNode(name);
-
-	if (!node)
-	{
-		node = new GraphNode(name);
-		nodes.insert(node);
-	}
-
-	return node;
+	for (auto &node : nodes)
+		delete node;
 }
 
 //==========================================================================
@@ -461,20 +673,17 @@ Converter::ConversionGraph::GraphNode*
 //		None
 //
 // Return Value:
-//		Converter::ConversionGraph::GraphNode*
+//		Converter::ConversionGraph::GraphNode*, NULL if the unit is not in the group
 //
 //==========================================================================
 Converter::ConversionGraph::GraphNode*
 	Converter::ConversionGraph::GetNode(const wxString &name) const
 {
-	std::set<GraphNode*>::iterator i;
-	for (i = nodes.begin(); i != nodes.end(); i++)
-	{
-		if ((*i)->name.Cmp(name) == 0)
-			return *i;
-	}
+	const int id(group.FindUnit(name));
+	if (id == wxNOT_FOUND)
+		return NULL;
 
-	return NULL;
+	return nodes[id];
 }
 
 //==========================================================================
@@ -16,34 +16,74 @@
 #define _CONVERTER_H_
 
 // Standard C++ headers
-#include <map>
-#include <string>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 // Local headers
 #include "xmlConversionFactors.h"
+#include "layeredCatalog.h"
+#include "compiledConversion.h"
+#include "chebyshevApproximation.h"
 
 class Converter
 {
 public:
-	Converter(const XMLConversionFactors &xml);
+	Converter(const LayeredCatalog &catalog);
 	~Converter() = default;
 
+	bool CanConvert(const wxString &group, const wxString &inUnit,
+		const wxString &outUnit) const;// Constant time
 	double Convert(const wxString &group, const wxString &inUnit,
 		const wxString &outUnit, const double &value);
+	void Convert(const wxString &group, const wxString &inUnit,
+		const wxString &outUnit, const double *values, double *results, const size_t &count);
+	void ConvertExact(const wxString &group, const wxString &inUnit,
+		const wxString &outUnit, const double *values, double *results, const size_t &count);
+
+	// Compiles the conversion (if it is not already cached) for use outside
+	// the converter, e.g. from several threads at once.  The conversion is
+	// valid until the cache is cleared.  Returns an error message (empty on
+	// success).
+	wxString Compile(const wxString &group, const wxString &inUnit,
+		const wxString &outUnit, const CompiledConversion *&conversion);
+
+	bool CompileApproximation(const wxString &group, const wxString &inUnit,
+		const wxString &outUnit, const double &minimum, const double &maximum,
+		const double &tolerance, double &maximumError);
 	void ClearCache();
+	void ClearCache(const std::set<wxString> &groups);
 
 private:
-	const XMLConversionFactors &xml;
+	const LayeredCatalog &catalog;
+
+	// Cached entries are found by a hash of the group and unit names and then
+	// compared, so no key needs to be built for a lookup
+	struct ConversionKey
+	{
+		wxString group;
+		wxString inUnit;
+		wxString outUnit;
+	};
 
-	std::map<std::string, wxString> conversions;
+	template <typename T>
+	using Cache = std::unordered_multimap<size_t, std::pair<ConversionKey, T> >;
 
-	static double EvaluateConversion(const double &value, wxString conversionString);
-	wxString GetConversion(const wxString &group, const wxString &inUnit,
+	Cache<CompiledConversion> conversions;
+	Cache<ChebyshevApproximation> approximations;
+
+	const CompiledConversion& GetConversion(const wxString &group, const wxString &inUnit,
 		const wxString &outUnit);
-	static std::string GetConversionCode(const wxString &group, const wxString &inUnit,
+	static size_t GetConversionHash(const wxString &group, const wxString &inUnit,
 		const wxString &outUnit);
 
+	template <typename T>
+	static typename Cache<T>::iterator Find(Cache<T> &cache, const size_t &hash,
+		const wxString &group, const wxString &inUnit, const wxString &outUnit);
+	template <typename T>
+	static void Erase(Cache<T> &cache, const std::set<wxString> &groups);
+
 	wxString CreateConversion(const wxString &group, const wxString &inUnit,
 		const wxString &outUnit) const;
 	wxString FindConversionPath(const XMLConversionFactors::FactorGroup &group,
@@ -58,6 +98,15 @@ private:
 		ConversionGraph(const XMLConversionFactors::FactorGroup &group);
 		~ConversionGraph();
 
+		class GraphNode;
+
+		struct Edge
+		{
+			GraphNode *node;
+			size_t equivalence;// Index in the group's equiv
+			bool nodeIsA;// True if node is the equivalence's a unit
+		};
+
 		class GraphNode
 		{
 		public:
@@ -65,20 +114,86 @@ private:
 			wxString name;
 			wxString path;
 			bool visited;
-			void AddNeighbor(GraphNode *n) { neighbors.insert(n); };
-			std::set<GraphNode*>& GetNeighbors() { return neighbors; };
+			void AddNeighbor(const Edge &e) { neighbors.push_back(e); };
+			const std::vector<Edge>& GetNeighbors() const { return neighbors; };
 
 		private:
-			std::set<GraphNode*> neighbors;
+			std::vector<Edge> neighbors;
 		};
 
-		GraphNode* GetOrCreateNode(const wxString &name);
 		GraphNode* GetNode(const wxString &name) const;
-		std::set<GraphNode*> GetNodes() const { return nodes; };
 
 	private:
-		std::set<GraphNode*> nodes;
+		const XMLConversionFactors::FactorGroup &group;
+
+		// Indexed by unit ID
+		std::vector<GraphNode*> nodes;
 	};
 };
 
+//==========================================================================
+// Class:			Converter
+// Function:		Find
+//
+// Description:		Finds the cached entry for the specified group and units.
+//
+// Input Arguments:
+//		cache	= Cache<T>&
+//		hash	= const size_t& (from GetConversionHash())
+//		group	= const wxString&
+//		inUnit	= const wxString&
+//		outUnit	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		typename Cache<T>::iterator, cache.end() if not found
+//
+//==========================================================================
+template <typename T>
+typename Converter::Cache<T>::iterator Converter::Find(Cache<T> &cache,
+	const size_t &hash, const wxString &group, const wxString &inUnit, const wxString &outUnit)
+{
+	auto range(cache.equal_range(hash));
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		const ConversionKey &key(it->second.first);
+		if (key.group.Cmp(group) == 0 && key.inUnit.Cmp(inUnit) == 0 &&
+			key.outUnit.Cmp(outUnit) == 0)
+			return it;
+	}
+
+	return cache.end();
+}
+
+//==========================================================================
+// Class:			Converter
+// Function:		Erase
+//
+// Description:		Removes the cached entries for the specified groups.
+//
+// Input Arguments:
+//		cache	= Cache<T>&
+//		groups	= const std::set<wxString>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+template <typename T>
+void Converter::Erase(Cache<T> &cache, const std::set<wxString> &groups)
+{
+	for (auto it = cache.begin(); it != cache.end();)
+	{
+		if (groups.find(it->second.first.group) != groups.end())
+			it = cache.erase(it);
+		else
+			++it;
+	}
+}
+
 #endif// _CONVERTER_H_
\ No newline at end of file
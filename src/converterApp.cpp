@@ -15,6 +15,7 @@
 // Local headers
 #include "converterApp.h"
 #include "mainFrame.h"
+#include "messageReporter.h"
 
 // Implement the application (have wxWidgets set up the appropriate entry points, etc.)
 IMPLEMENT_APP(ConverterApp);
@@ -62,6 +63,15 @@ bool ConverterApp::OnInit()
 	SetAppName(name);
 	SetVendorName(creator);
 
+	// Messages from the conversion engine are shown in message boxes
+	MessageReporter::SetHandler([](const MessageReporter::Severity &severity, const wxString &message)
+	{
+		if (severity == MessageReporter::severityError)
+			wxMessageBox(message, _T("Error"), wxICON_ERROR);
+		else
+			wxMessageBox(message, _T("Warning"), wxICON_WARNING);
+	});
+
 	// Create the MainFrame object - this is the parent for all other objects
 	mainFrame = new MainFrame();
 
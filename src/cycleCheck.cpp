@@ -0,0 +1,408 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  cycleCheck.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Checks that redundant equivalences in a group agree (that every
+//				 cycle in the group's graph composes to the identity) and chooses
+//				 the spanning tree that conversion paths are built from.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+// Local headers
+#include "cycleCheck.h"
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CycleCheck class.  Each cycle is checked
+//					at more than one value, so offsets (as in temperature
+//					conversions) are checked as well as factors.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const double CycleCheck::tolerance(1.0e-6);
+const unsigned int CycleCheck::maxReported(3);
+const double CycleCheck::probes[] = { 1.0, 37.5 };
+const unsigned int CycleCheck::probeCount(sizeof(probes) / sizeof(probes[0]));
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		CycleCheck
+//
+// Description:		Constructor for the CycleCheck class.
+//
+// Input Arguments:
+//		group	= XMLConversionFactors::FactorGroup&, with units indexed and
+//				  equations solved
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+CycleCheck::CycleCheck(XMLConversionFactors::FactorGroup &group) : group(group)
+{
+}
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		Check
+//
+// Description:		Checks each fundamental cycle of a spanning tree (each
+//					equivalence outside the tree closes one, and together they
+//					form a cycle basis).  If any cycle is inconsistent, each
+//					equivalence is scored by the worst inconsistent cycle it is
+//					part of, and the tree is rebuilt preferring low scores, so
+//					conversions avoid the equivalences most likely to be wrong.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, description of the worst inconsistent cycles (empty if
+//		there are none)
+//
+//==========================================================================
+wxString CycleCheck::Check()
+{
+	Compile();
+
+	// First tree prefers equivalences that can be evaluated, then file order
+	std::vector<size_t> order(group.equiv.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [this](const size_t &a, const size_t &b)
+	{
+		return usable[a] && !usable[b];
+	});
+	BuildTree(order);
+
+	std::vector<Cycle> cycles;
+	for (size_t i = 0; i < group.equiv.size(); i++)
+	{
+		if (inTree[i] || !usable[i])
+			continue;
+
+		const double error(GetError(i));
+		if (error > tolerance)
+			cycles.push_back(Cycle{ i, error });
+	}
+
+	if (cycles.empty())
+	{
+		for (size_t i = 0; i < group.equiv.size(); i++)
+			group.equiv[i].pathEdge = inTree[i];
+		return wxEmptyString;
+	}
+
+	std::vector<double> score(group.equiv.size(), 0.0);
+	std::vector<unsigned int> units;
+	std::vector<size_t> equivalences;
+	for (const auto &cycle : cycles)
+	{
+		GetTreePath(aUnits[cycle.equivalence], bUnits[cycle.equivalence], units, equivalences);
+		equivalences.push_back(cycle.equivalence);
+		for (const auto &e : equivalences)
+			score[e] = std::max(score[e], cycle.error);
+	}
+
+	// Descriptions are taken from the first tree, which defines the cycles
+	std::stable_sort(cycles.begin(), cycles.end(), [](const Cycle &a, const Cycle &b)
+	{
+		return a.error > b.error;
+	});
+
+	wxString report(wxString::Format(_T("%u inconsistent cycle(s) in group '"),
+		static_cast<unsigned int>(cycles.size())) + group.name + _T("'"));
+	for (size_t i = 0; i < cycles.size() && i < maxReported; i++)
+		report += _T("\n  ") + DescribeCycle(cycles[i]);
+
+	std::stable_sort(order.begin(), order.end(), [this, &score](const size_t &a, const size_t &b)
+	{
+		if (usable[a] != usable[b])
+			return static_cast<bool>(usable[a]);
+		return score[a] < score[b];
+	});
+	BuildTree(order);
+
+	for (size_t i = 0; i < group.equiv.size(); i++)
+		group.equiv[i].pathEdge = inTree[i];
+
+	return report;
+}
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		Compile
+//
+// Description:		Compiles both solutions of each equivalence.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CycleCheck::Compile()
+{
+	const size_t count(group.equiv.size());
+	aUnits.resize(count);
+	bUnits.resize(count);
+	aConversions.resize(count);
+	bConversions.resize(count);
+	usable.assign(count, false);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const XMLConversionFactors::Equivalence &equiv(group.equiv[i]);
+		aUnits[i] = group.FindUnit(equiv.aUnit);
+		bUnits[i] = group.FindUnit(equiv.bUnit);
+		usable[i] = !equiv.aSolution.IsEmpty() && !equiv.bSolution.IsEmpty() &&
+			aConversions[i].Compile(equiv.aSolution, _T("b")).IsEmpty() &&
+			bConversions[i].Compile(equiv.bSolution, _T("a")).IsEmpty();
+	}
+}
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		BuildTree
+//
+// Description:		Builds a spanning forest from the equivalences, taking
+//					them in the specified order, and evaluates each probe value
+//					(given in the units of each tree's root) at every unit.
+//
+// Input Arguments:
+//		order	= const std::vector<size_t>&, equivalence indices
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CycleCheck::BuildTree(const std::vector<size_t> &order)
+{
+	const unsigned int unitCount(group.GetUnitList().Count());
+	std::vector<unsigned int> representative(unitCount);
+	for (unsigned int i = 0; i < unitCount; i++)
+		representative[i] = i;
+
+	auto find = [&representative](unsigned int i)
+	{
+		while (representative[i] != i)
+		{
+			representative[i] = representative[representative[i]];
+			i = representative[i];
+		}
+		return i;
+	};
+
+	std::vector<std::vector<size_t> > edges(unitCount);
+	inTree.assign(group.equiv.size(), false);
+	for (const auto &i : order)
+	{
+		const unsigned int a(find(aUnits[i])), b(find(bUnits[i]));
+		if (a == b)
+			continue;
+
+		representative[a] = b;
+		inTree[i] = true;
+		edges[aUnits[i]].push_back(i);
+		edges[bUnits[i]].push_back(i);
+	}
+
+	const size_t noEquivalence(group.equiv.size());
+	parent.assign(unitCount, 0);
+	parentEquivalence.assign(unitCount, noEquivalence);
+	depth.assign(unitCount, 0);
+	values.assign(unitCount * probeCount, std::numeric_limits<double>::quiet_NaN());
+
+	std::vector<bool> visited(unitCount, false);
+	std::queue<unsigned int> q;
+	unsigned int root, j;
+	for (root = 0; root < unitCount; root++)
+	{
+		if (visited[root])
+			continue;
+
+		visited[root] = true;
+		parent[root] = root;
+		for (j = 0; j < probeCount; j++)
+			values[root * probeCount + j] = probes[j];
+		q.push(root);
+
+		while (!q.empty())
+		{
+			const unsigned int n(q.front());
+			q.pop();
+			for (const auto &e : edges[n])
+			{
+				const bool childIsA(aUnits[e] != n);
+				const unsigned int child(childIsA ? aUnits[e] : bUnits[e]);
+				if (visited[child])
+					continue;
+
+				visited[child] = true;
+				parent[child] = n;
+				parentEquivalence[child] = e;
+				depth[child] = depth[n] + 1;
+				if (usable[e])
+				{
+					const CompiledConversion &conversion(childIsA ? aConversions[e] : bConversions[e]);
+					for (j = 0; j < probeCount; j++)
+						values[child * probeCount + j] = conversion.Evaluate(values[n * probeCount + j]);
+				}
+
+				q.push(child);
+			}
+		}
+	}
+}
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		GetError
+//
+// Description:		Returns the relative error of the cycle closed by the
+//					specified equivalence:  the difference between the a value
+//					given by the tree and the a value given by the equivalence.
+//					Probes that are out of the equations' domain are skipped.
+//
+// Input Arguments:
+//		equivalence	= const size_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+double CycleCheck::GetError(const size_t &equivalence) const
+{
+	double error(0.0);
+	for (unsigned int j = 0; j < probeCount; j++)
+	{
+		const double expected(values[aUnits[equivalence] * probeCount + j]);
+		const double actual(aConversions[equivalence].Evaluate(
+			values[bUnits[equivalence] * probeCount + j]));
+		if (!std::isfinite(expected) || !std::isfinite(actual))
+			continue;
+
+		const double scale(std::max(std::abs(expected), std::abs(actual)));
+		if (scale > 0.0)
+			error = std::max(error, std::abs(actual - expected) / scale);
+	}
+
+	return error;
+}
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		GetTreePath
+//
+// Description:		Finds the path through the tree between two units.
+//
+// Input Arguments:
+//		from	= const unsigned int&, unit ID
+//		to		= const unsigned int&, unit ID
+//
+// Output Arguments:
+//		units			= std::vector<unsigned int>&, from, ..., to
+//		equivalences	= std::vector<size_t>&, one per step
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CycleCheck::GetTreePath(const unsigned int &from, const unsigned int &to,
+	std::vector<unsigned int> &units, std::vector<size_t> &equivalences) const
+{
+	std::vector<unsigned int> toSide;
+	std::vector<size_t> toEquivalences;
+	units.clear();
+	equivalences.clear();
+
+	unsigned int a(from), b(to);
+	while (a != b)
+	{
+		if (depth[a] >= depth[b])
+		{
+			units.push_back(a);
+			equivalences.push_back(parentEquivalence[a]);
+			a = parent[a];
+		}
+		else
+		{
+			toSide.push_back(b);
+			toEquivalences.push_back(parentEquivalence[b]);
+			b = parent[b];
+		}
+	}
+
+	units.push_back(a);
+	units.insert(units.end(), toSide.rbegin(), toSide.rend());
+	equivalences.insert(equivalences.end(), toEquivalences.rbegin(), toEquivalences.rend());
+}
+
+//==========================================================================
+// Class:			CycleCheck
+// Function:		DescribeCycle
+//
+// Description:		Lists the units around the specified cycle.
+//
+// Input Arguments:
+//		cycle	= const Cycle&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString
+//
+//==========================================================================
+wxString CycleCheck::DescribeCycle(const Cycle &cycle) const
+{
+	std::vector<unsigned int> units;
+	std::vector<size_t> equivalences;
+	GetTreePath(aUnits[cycle.equivalence], bUnits[cycle.equivalence], units, equivalences);
+	units.push_back(aUnits[cycle.equivalence]);
+
+	const wxArrayString &unitList(group.GetUnitList());
+	wxString description;
+	for (size_t i = 0; i < units.size(); i++)
+		description += (i == 0 ? wxString() : wxString(_T(" -> "))) + _T("'") + unitList[units[i]] + _T("'");
+
+	return description + wxString::Format(_T(" (relative error %g)"), cycle.error);
+}
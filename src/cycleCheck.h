@@ -0,0 +1,78 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  cycleCheck.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Checks that redundant equivalences in a group agree (that every
+//				 cycle in the group's graph composes to the identity) and chooses
+//				 the spanning tree that conversion paths are built from.
+// History:
+
+#ifndef _CYCLE_CHECK_H_
+#define _CYCLE_CHECK_H_
+
+// Standard C++ headers
+#include <vector>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Local headers
+#include "xmlConversionFactors.h"
+#include "compiledConversion.h"
+
+class CycleCheck
+{
+public:
+	CycleCheck(XMLConversionFactors::FactorGroup &group);
+	~CycleCheck() = default;
+
+	// Checks each cycle in a basis of the group's graph and sets each
+	// equivalence's pathEdge flag.  Returns a description of the worst
+	// cycles that are not consistent (empty if all are).
+	wxString Check();
+
+	static const double tolerance;// Relative
+	static const unsigned int maxReported;// Per group
+
+private:
+	XMLConversionFactors::FactorGroup &group;
+
+	static const double probes[];
+	static const unsigned int probeCount;
+
+	// Indexed by equivalence
+	std::vector<unsigned int> aUnits, bUnits;
+	std::vector<CompiledConversion> aConversions;// a in terms of b
+	std::vector<CompiledConversion> bConversions;// b in terms of a
+	std::vector<bool> usable;// Both solutions compiled
+	std::vector<bool> inTree;
+
+	// Indexed by unit ID
+	std::vector<unsigned int> parent;
+	std::vector<size_t> parentEquivalence;
+	std::vector<unsigned int> depth;
+	std::vector<double> values;// probeCount values per unit
+
+	// A cycle is closed by one equivalence that is not in the tree
+	struct Cycle
+	{
+		size_t equivalence;
+		double error;
+	};
+
+	void Compile();
+	void BuildTree(const std::vector<size_t> &order);
+	double GetError(const size_t &equivalence) const;
+	void GetTreePath(const unsigned int &from, const unsigned int &to,
+		std::vector<unsigned int> &units, std::vector<size_t> &equivalences) const;
+	wxString DescribeCycle(const Cycle &cycle) const;
+};
+
+#endif// _CYCLE_CHECK_H_
@@ -0,0 +1,876 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  converterDaemon.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Long-lived conversion server.  Loads the catalog once and
+//				 answers requests (see daemonProtocol.h) over a Unix domain
+//				 socket, so clients share its compiled conversions.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// wxWidgets headers
+#include <wx/init.h>
+
+// Platform headers
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Local headers
+#include "converterDaemon.h"
+#include "layeredCatalog.h"
+#include "converter.h"
+#include "compiledConversion.h"
+#include "messageReporter.h"
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Constant Definitions
+//
+// Description:		Constants for the ConverterDaemon class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const char *ConverterDaemon::name("converter-daemon");
+const size_t ConverterDaemon::readSize(256 * 1024);
+const size_t ConverterDaemon::maxPendingOutput(16 * 1024 * 1024);
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		ConverterDaemon
+//
+// Description:		Constructor for ConverterDaemon class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+ConverterDaemon::ConverterDaemon() : epollDescriptor(-1), listenDescriptor(-1),
+	signalDescriptor(-1)
+{
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		~ConverterDaemon
+//
+// Description:		Destructor for ConverterDaemon class.  Closes every
+//					connection and removes the socket.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+ConverterDaemon::~ConverterDaemon()
+{
+	while (!connections.empty())
+		Close(connections.begin()->first);
+
+	if (listenDescriptor >= 0)
+	{
+		::close(listenDescriptor);
+		unlink(socketPath.c_str());
+	}
+
+	if (signalDescriptor >= 0)
+		::close(signalDescriptor);
+	if (epollDescriptor >= 0)
+		::close(epollDescriptor);
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Run
+//
+// Description:		Loads the catalog and serves requests until stopped.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ExitCode
+//
+//==========================================================================
+int ConverterDaemon::Run(int argc, char *argv[])
+{
+	bool help;
+	if (!ParseArguments(argc, argv, help))
+		return exitError;
+	else if (help)
+	{
+		PrintUsage();
+		return exitSuccess;
+	}
+
+	MessageReporter::SetHandler([](const MessageReporter::Severity &severity, const wxString &message)
+	{
+		// Written at once, as messages may come from several threads
+		std::cerr << std::string(name) + (severity == MessageReporter::severityError ? ":  error:  " : ":  warning:  ")
+			+ message.utf8_str().data() + "\n" << std::flush;
+	});
+
+	catalog.reset(new LayeredCatalog(catalogFileNames));
+	if (!catalog->Load())
+		return exitError;
+	converter.reset(new Converter(*catalog));
+
+	if (!Listen())
+		return exitError;
+
+	std::cerr << name << ":  listening on " << socketPath << std::endl;
+	return Serve() ? exitSuccess : exitError;
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		ParseArguments
+//
+// Description:		Reads the options.  Options taking a value accept it as
+//					the next argument or (for the long form) after '='.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		help	= bool&, true if usage was requested
+//
+// Return Value:
+//		bool, false if the arguments are invalid (the error has been written)
+//
+//==========================================================================
+bool ConverterDaemon::ParseArguments(int argc, char *argv[], bool &help)
+{
+	help = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument(argv[i]);
+		std::string option(argument), value;
+		bool hasValue(false);
+		const size_t equals(argument.find('='));
+		if (argument.compare(0, 2, "--") == 0 && equals != std::string::npos)
+		{
+			option = argument.substr(0, equals);
+			value = argument.substr(equals + 1);
+			hasValue = true;
+		}
+
+		auto readValue = [&]()
+		{
+			if (!hasValue && i + 1 < argc)
+			{
+				value = argv[++i];
+				hasValue = true;
+			}
+
+			if (!hasValue)
+				std::cerr << name << ":  '" << option << "' requires a value" << std::endl;
+			return hasValue;
+		};
+
+		if (option == "-h" || option == "--help")
+			help = true;
+		else if (option == "-c" || option == "--catalog")
+		{
+			if (!readValue())
+				return false;
+			catalogFileNames.push_back(wxString::FromUTF8(value.c_str()));
+		}
+		else if (option == "-s" || option == "--socket")
+		{
+			if (!readValue())
+				return false;
+			socketPath = value;
+		}
+		else
+		{
+			std::cerr << name << ":  unknown argument '" << argument << "' (see --help)" << std::endl;
+			return false;
+		}
+	}
+
+	if (catalogFileNames.empty())
+		catalogFileNames = LayeredCatalog::GetSharedFileNames();
+	if (socketPath.empty())
+		socketPath = GetDefaultSocketPath();
+
+	return true;
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		PrintUsage
+//
+// Description:		Writes the command line help to stdout.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::PrintUsage()
+{
+	std::cout << "Usage:  " << name << " [options]\n"
+		"Loads the catalog once and answers conversion requests on a Unix domain\n"
+		"socket until interrupted.  See daemonProtocol.h for the framing.\n\n"
+		"Options:\n"
+		"  -c, --catalog FILE   Catalog to use; repeat to layer catalogs, each taking\n"
+		"                       precedence over those before it.  By default, the\n"
+		"                       application's catalog and $" << LayeredCatalog::siteCatalogVariable.utf8_str() << "\n"
+		"  -s, --socket PATH    Socket to listen on (by default, " << GetDefaultSocketPath() << ")\n"
+		"  -h, --help           Show this message\n";
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		GetDefaultSocketPath
+//
+// Description:		Returns the socket used when none is specified.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string ConverterDaemon::GetDefaultSocketPath()
+{
+	const char *runtimeDirectory(std::getenv("XDG_RUNTIME_DIR"));
+	if (runtimeDirectory && runtimeDirectory[0] != '\0')
+		return std::string(runtimeDirectory) + "/converter-daemon.sock";
+	return "/tmp/converter-daemon-" + std::to_string(getuid()) + ".sock";
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Listen
+//
+// Description:		Creates the socket (only its owner may connect) and the
+//					event loop, which also receives SIGINT and SIGTERM.  A
+//					socket left by a daemon that is no longer running is
+//					replaced.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise (the error has been written)
+//
+//==========================================================================
+bool ConverterDaemon::Listen()
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path))
+	{
+		std::cerr << name << ":  socket path '" << socketPath << "' is too long" << std::endl;
+		return false;
+	}
+	strcpy(address.sun_path, socketPath.c_str());
+
+	const int descriptor(socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+	if (descriptor < 0)
+	{
+		std::cerr << name << ":  cannot create socket:  " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	const mode_t mask(umask(S_IRWXG | S_IRWXO));
+	int result(bind(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+	if (result != 0 && errno == EADDRINUSE)
+	{
+		const int probe(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+		const bool running(probe >= 0 &&
+			connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+		if (probe >= 0)
+			::close(probe);
+
+		if (running)
+			errno = EADDRINUSE;
+		else if (unlink(socketPath.c_str()) == 0)
+			result = bind(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+	}
+	umask(mask);
+
+	if (result != 0 || listen(descriptor, SOMAXCONN) != 0)
+	{
+		std::cerr << name << ":  cannot listen on '" << socketPath << "':  " << strerror(errno) << std::endl;
+		::close(descriptor);
+		return false;
+	}
+	listenDescriptor = descriptor;
+
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	sigprocmask(SIG_BLOCK, &signals, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	signalDescriptor = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+	epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+	if (signalDescriptor < 0 || epollDescriptor < 0)
+	{
+		std::cerr << name << ":  cannot create event loop:  " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = listenDescriptor;
+	epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, listenDescriptor, &event);
+	event.data.fd = signalDescriptor;
+	epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, signalDescriptor, &event);
+
+	return true;
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Serve
+//
+// Description:		Runs the event loop until a signal is received.  Each
+//					ready connection is read once per pass (so one busy
+//					client cannot starve the others), every complete frame
+//					read so far is answered, and as much output is sent as
+//					the socket will take.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false if the event loop failed
+//
+//==========================================================================
+bool ConverterDaemon::Serve()
+{
+	std::vector<epoll_event> events(64);
+	while (true)
+	{
+		const int count(epoll_wait(epollDescriptor, events.data(), events.size(), -1));
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			std::cerr << name << ":  event loop failed:  " << strerror(errno) << std::endl;
+			return false;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			const int descriptor(events[i].data.fd);
+			if (descriptor == signalDescriptor)
+			{
+				std::cerr << name << ":  stopping" << std::endl;
+				return true;
+			}
+			else if (descriptor == listenDescriptor)
+			{
+				Accept();
+				continue;
+			}
+
+			// May have been closed while handling an earlier event
+			auto connection(connections.find(descriptor));
+			if (connection == connections.end())
+				continue;
+
+			bool open(true);
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				open = Read(connection->second);
+			if (open)
+				open = Write(connection->second) && UpdateEvents(connection->second);
+
+			if (!open)
+				Close(descriptor);
+		}
+	}
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Accept
+//
+// Description:		Accepts the waiting connections.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::Accept()
+{
+	while (true)
+	{
+		const int descriptor(accept4(listenDescriptor, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC));
+		if (descriptor < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+				std::cerr << name << ":  cannot accept connection:  " << strerror(errno) << std::endl;
+			return;
+		}
+
+		Connection &connection(connections[descriptor]);
+		connection.descriptor = descriptor;
+		connection.outputSent = 0;
+		connection.reading = true;
+		connection.events = EPOLLIN;
+
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = connection.events;
+		event.data.fd = descriptor;
+		if (epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) != 0)
+		{
+			connections.erase(descriptor);
+			::close(descriptor);
+		}
+	}
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Read
+//
+// Description:		Reads what is available (up to readSize) and answers
+//					the complete frames.
+//
+// Input Arguments:
+//		connection	= Connection&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false if the connection failed
+//
+//==========================================================================
+bool ConverterDaemon::Read(Connection &connection)
+{
+	if (!connection.reading)
+		return true;
+
+	const size_t start(connection.input.size());
+	connection.input.resize(start + readSize);
+	const ssize_t count(recv(connection.descriptor, connection.input.data() + start, readSize, 0));
+	connection.input.resize(start + std::max<ssize_t>(count, 0));
+	if (count < 0)
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+	else if (count == 0)
+		connection.reading = false;// Responses are still sent
+
+	HandleFrames(connection);
+	return true;
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Write
+//
+// Description:		Sends as much of the pending output as the socket will
+//					take.
+//
+// Input Arguments:
+//		connection	= Connection&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false if the connection failed
+//
+//==========================================================================
+bool ConverterDaemon::Write(Connection &connection)
+{
+	while (connection.outputSent < connection.output.size())
+	{
+		const ssize_t count(send(connection.descriptor, connection.output.data() + connection.outputSent,
+			connection.output.size() - connection.outputSent, MSG_NOSIGNAL));
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+
+		connection.outputSent += count;
+	}
+
+	if (connection.outputSent == connection.output.size())
+	{
+		connection.output.clear();
+		connection.outputSent = 0;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		UpdateEvents
+//
+// Description:		Waits for the connection to become writable while there
+//					is output pending, and stops reading while too much is
+//					pending (until the client reads its responses).
+//
+// Input Arguments:
+//		connection	= Connection&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false if the connection is finished (the client has stopped
+//		sending and every response was sent) or failed
+//
+//==========================================================================
+bool ConverterDaemon::UpdateEvents(Connection &connection)
+{
+	const size_t pending(connection.output.size() - connection.outputSent);
+	if (!connection.reading && pending == 0)
+		return false;
+
+	uint32_t events(0);
+	if (connection.reading && pending < maxPendingOutput)
+		events |= EPOLLIN;
+	if (pending > 0)
+		events |= EPOLLOUT;
+
+	if (events == connection.events)
+		return true;
+
+	epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = events;
+	event.data.fd = connection.descriptor;
+	connection.events = events;
+	return epoll_ctl(epollDescriptor, EPOLL_CTL_MOD, connection.descriptor, &event) == 0;
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Close
+//
+// Description:		Closes the connection.
+//
+// Input Arguments:
+//		descriptor	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::Close(const int &descriptor)
+{
+	epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, descriptor, NULL);
+	::close(descriptor);
+	connections.erase(descriptor);
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		HandleFrames
+//
+// Description:		Answers each complete frame in the input, in order, and
+//					keeps any partial frame for the next read.
+//
+// Input Arguments:
+//		connection	= Connection&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::HandleFrames(Connection &connection)
+{
+	using namespace DaemonProtocol;
+
+	size_t position(0);
+	while (connection.input.size() - position >= sizeof(FrameHeader))
+	{
+		FrameHeader header;
+		memcpy(&header, connection.input.data() + position, sizeof(header));
+		if (header.size > maxPayloadSize)
+		{
+			// The rest of the input cannot be framed
+			AppendError(connection.output, header, wxString::Format(
+				_T("Frame payload of %u bytes is larger than the limit (%u bytes)"),
+				header.size, maxPayloadSize));
+			connection.reading = false;
+			connection.input.clear();
+			return;
+		}
+		else if (connection.input.size() - position - sizeof(header) < header.size)
+			break;
+
+		const char *payload(connection.input.data() + position + sizeof(header));
+		if (header.type == frameResolve)
+			Resolve(header, payload, connection.output);
+		else if (header.type == frameConvert)
+			Convert(header, payload, connection.output);
+		else
+			AppendError(connection.output, header, wxString::Format(_T("Unknown frame type %u"), header.type));
+
+		position += sizeof(header) + header.size;
+	}
+
+	connection.input.erase(connection.input.begin(), connection.input.begin() + position);
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Resolve
+//
+// Description:		Answers a resolve request with the pair's ID, compiling
+//					its conversion the first time it is requested.
+//
+// Input Arguments:
+//		header	= const DaemonProtocol::FrameHeader&
+//		payload	= const char*
+//
+// Output Arguments:
+//		output	= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::Resolve(const DaemonProtocol::FrameHeader &header, const char *payload, std::string &output)
+{
+	const std::string key(payload, header.size);
+	auto pair(pairIds.find(key));
+	if (pair == pairIds.end())
+	{
+		std::vector<wxString> names;
+		size_t start(0), end;
+		while (names.size() < 3 && (end = key.find('\0', start)) != std::string::npos)
+		{
+			names.push_back(wxString::FromUTF8(key.substr(start, end - start).c_str()));
+			start = end + 1;
+		}
+
+		if (names.size() != 3 || start != key.size())
+		{
+			AppendError(output, header, _T("Resolve requires the group, input unit and output unit, each terminated by '\\0'"));
+			return;
+		}
+		else if (!converter->CanConvert(names[0], names[1], names[2]))
+		{
+			AppendError(output, header, _T("Cannot convert from '") + names[1] + _T("' to '")
+				+ names[2] + _T("' in group '") + names[0] + _T("'"));
+			return;
+		}
+
+		const CompiledConversion *conversion;
+		const wxString error(converter->Compile(names[0], names[1], names[2], conversion));
+		if (!error.IsEmpty())
+		{
+			AppendError(output, header, error);
+			return;
+		}
+
+		pairs.push_back(conversion);
+		pair = pairIds.insert(std::make_pair(key, static_cast<uint32_t>(pairs.size() - 1))).first;
+	}
+
+	AppendFrame(output, DaemonProtocol::frameResolved, header.tag, pair->second, NULL, 0);
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		Convert
+//
+// Description:		Answers a convert request with the results.
+//
+// Input Arguments:
+//		header	= const DaemonProtocol::FrameHeader&
+//		payload	= const char*
+//
+// Output Arguments:
+//		output	= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::Convert(const DaemonProtocol::FrameHeader &header, const char *payload, std::string &output)
+{
+	if (header.pairId >= pairs.size())
+	{
+		AppendError(output, header, wxString::Format(_T("Unknown pair ID %u"), header.pairId));
+		return;
+	}
+	else if (header.size % sizeof(double) != 0)
+	{
+		AppendError(output, header, _T("Payload is not a whole number of values"));
+		return;
+	}
+
+	// The payload is not necessarily aligned
+	const size_t count(header.size / sizeof(double));
+	values.resize(count);
+	results.resize(count);
+	memcpy(values.data(), payload, header.size);
+	pairs[header.pairId]->Evaluate(values.data(), results.data(), count);
+
+	AppendFrame(output, DaemonProtocol::frameValues, header.tag, header.pairId, results.data(), header.size);
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		AppendFrame
+//
+// Description:		Adds a frame to the output.
+//
+// Input Arguments:
+//		type	= const DaemonProtocol::FrameType&
+//		tag		= const uint32_t&
+//		pairId	= const uint32_t&
+//		payload	= const void*
+//		size	= const size_t& [bytes]
+//
+// Output Arguments:
+//		output	= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::AppendFrame(std::string &output, const DaemonProtocol::FrameType &type,
+	const uint32_t &tag, const uint32_t &pairId, const void *payload, const size_t &size)
+{
+	DaemonProtocol::FrameHeader header;
+	header.size = static_cast<uint32_t>(size);
+	header.type = static_cast<uint16_t>(type);
+	header.reserved = 0;
+	header.tag = tag;
+	header.pairId = pairId;
+
+	output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (size > 0)
+		output.append(static_cast<const char*>(payload), size);
+}
+
+//==========================================================================
+// Class:			ConverterDaemon
+// Function:		AppendError
+//
+// Description:		Adds an error frame answering the request to the output.
+//
+// Input Arguments:
+//		request	= const DaemonProtocol::FrameHeader&
+//		message	= const wxString&
+//
+// Output Arguments:
+//		output	= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ConverterDaemon::AppendError(std::string &output, const DaemonProtocol::FrameHeader &request,
+	const wxString &message)
+{
+	const std::string text(message.utf8_str());
+	AppendFrame(output, DaemonProtocol::frameError, request.tag, request.pairId, text.data(), text.size());
+}
+
+//==========================================================================
+// Class:			None
+// Function:		main
+//
+// Description:		Entry point for the conversion daemon.  wxWidgets is
+//					initialized without a GUI.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ConverterDaemon::ExitCode
+//
+//==========================================================================
+int main(int argc, char *argv[])
+{
+	wxInitializer initializer;
+	if (!initializer.IsOk())
+	{
+		std::cerr << ConverterDaemon::name << ":  cannot initialize wxWidgets" << std::endl;
+		return ConverterDaemon::exitError;
+	}
+
+	return ConverterDaemon().Run(argc, argv);
+}
@@ -0,0 +1,110 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  converterDaemon.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Long-lived conversion server.  Loads the catalog once and
+//				 answers requests (see daemonProtocol.h) over a Unix domain
+//				 socket, so clients share its compiled conversions.
+// History:
+
+#ifndef _CONVERTER_DAEMON_H_
+#define _CONVERTER_DAEMON_H_
+
+// Standard C++ headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/string.h>
+
+// Local headers
+#include "daemonProtocol.h"
+
+// Local forward declarations
+class LayeredCatalog;
+class Converter;
+class CompiledConversion;
+
+class ConverterDaemon
+{
+public:
+	ConverterDaemon();
+	~ConverterDaemon();
+
+	// Serves until SIGINT or SIGTERM
+	int Run(int argc, char *argv[]);
+
+	enum ExitCode
+	{
+		exitSuccess = 0,
+		exitError = 1// Invalid arguments, or the catalog or socket could not be opened
+	};
+
+	// $XDG_RUNTIME_DIR/converter-daemon.sock, or if it is not set,
+	// /tmp/converter-daemon-<uid>.sock
+	static std::string GetDefaultSocketPath();
+
+	static const char *name;
+	static const size_t readSize;// [bytes] Read from a connection at once
+	static const size_t maxPendingOutput;// [bytes] Before reading stops
+
+private:
+	std::vector<wxString> catalogFileNames;
+	std::string socketPath;
+
+	int epollDescriptor;
+	int listenDescriptor;
+	int signalDescriptor;
+
+	struct Connection
+	{
+		int descriptor;
+		std::vector<char> input;// Frames not yet handled
+		std::string output;// Responses not yet sent
+		size_t outputSent;
+		bool reading;// False once the client has finished sending
+		uint32_t events;// Registered with epoll
+	};
+
+	std::unordered_map<int, Connection> connections;
+
+	std::unique_ptr<LayeredCatalog> catalog;
+	std::unique_ptr<Converter> converter;
+
+	// Pair IDs index the conversions (kept by the converter)
+	std::vector<const CompiledConversion*> pairs;
+	std::unordered_map<std::string, uint32_t> pairIds;// By resolve payload
+
+	std::vector<double> values, results;
+
+	bool ParseArguments(int argc, char *argv[], bool &help);
+	static void PrintUsage();
+
+	bool Listen();
+	bool Serve();
+	void Accept();
+	bool Read(Connection &connection);
+	bool Write(Connection &connection);
+	bool UpdateEvents(Connection &connection);
+	void Close(const int &descriptor);
+
+	void HandleFrames(Connection &connection);
+	void Resolve(const DaemonProtocol::FrameHeader &header, const char *payload, std::string &output);
+	void Convert(const DaemonProtocol::FrameHeader &header, const char *payload, std::string &output);
+	static void AppendFrame(std::string &output, const DaemonProtocol::FrameType &type,
+		const uint32_t &tag, const uint32_t &pairId, const void *payload, const size_t &size);
+	static void AppendError(std::string &output, const DaemonProtocol::FrameHeader &request,
+		const wxString &message);
+};
+
+#endif// _CONVERTER_DAEMON_H_
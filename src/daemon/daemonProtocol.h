@@ -0,0 +1,61 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  daemonProtocol.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Framing of the requests and responses exchanged with
+//				 converter-daemon over its Unix domain socket.
+// History:
+
+#ifndef _DAEMON_PROTOCOL_H_
+#define _DAEMON_PROTOCOL_H_
+
+// Standard C++ headers
+#include <cstdint>
+
+// Each frame is a header followed by size bytes of payload.  Client and
+// daemon are on the same machine, so values are in its byte order.  A client
+// may write any number of frames at once; the daemon answers each request
+// with one response, in the order the requests were received.
+//
+// frameResolve:  payload is the group, input unit and output unit, each
+//	terminated by '\0' (UTF-8).  Answered by frameResolved, with the pair's
+//	ID in pairId and no payload.  IDs stay valid while the daemon runs.
+// frameConvert:  pairId is from frameResolved, payload is the values
+//	(double).  Answered by frameValues with the results (one for each value).
+// frameError:  answers any request that fails; payload is the message
+//	(UTF-8, not terminated).  A frame larger than maxPayloadSize is answered
+//	with an error, after which the daemon closes the connection.
+namespace DaemonProtocol
+{
+	struct FrameHeader
+	{
+		uint32_t size;// [bytes] Of the payload
+		uint16_t type;// FrameType
+		uint16_t reserved;// Zero
+		uint32_t tag;// Chosen by the client and returned with the response
+		uint32_t pairId;
+	};
+
+	static_assert(sizeof(FrameHeader) == 16, "Frame header must not be padded");
+
+	enum FrameType
+	{
+		frameResolve = 0x01,
+		frameConvert = 0x02,
+
+		frameResolved = 0x81,
+		frameValues = 0x82,
+		frameError = 0xFF
+	};
+
+	const uint32_t maxPayloadSize(64 * 1024 * 1024);// [bytes]
+}
+
+#endif// _DAEMON_PROTOCOL_H_
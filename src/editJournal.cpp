@@ -0,0 +1,459 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  editJournal.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Append-only log of edits to the conversion catalog.  Each append
+//				 is flushed to disk before returning, so saved edits survive a
+//				 crash without the catalog itself being rewritten.
+// History:
+
+// Standard C++ headers
+#include <cstdlib>
+
+// wxWidgets headers
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+// Platform headers
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Local headers
+#include "editJournal.h"
+#include "mappedFile.h"
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Constant Definitions
+//
+// Description:		Constants for the EditJournal class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const std::string EditJournal::magic("CNVJOURNAL1");
+const std::string EditJournal::batchMarker("BATCH");
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Append
+//
+// Description:		Appends the records to the journal (creating it if
+//					necessary) and flushes it to disk.  More than one record
+//					is preceded by a marker giving the count, so that Read()
+//					can tell whether all of them were written.  Whatever an
+//					interrupted append left after the last complete append
+//					is removed first; otherwise the new records would be
+//					joined to a partial line, or counted in a partial batch.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		sourceHash	= const uint64_t&
+//		sourceSize	= const uint64_t&
+//		records		= const std::vector<Record>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool EditJournal::Append(const wxString &fileName, const uint64_t &sourceHash,
+	const uint64_t &sourceSize, const std::vector<Record> &records)
+{
+	bool create(true);
+	if (::wxFileExists(fileName))
+	{
+		uint64_t hash, size, fileSize(0);
+		std::vector<Record> existing;
+		size_t validLength(0);
+		{
+			MappedFile file;
+			if (file.Open(fileName))
+			{
+				fileSize = file.GetSize();
+				create = !Parse(file.GetData(), file.GetSize(), hash, size, existing, validLength);
+			}
+		}
+
+		if (!create && validLength < fileSize && !Truncate(fileName, validLength))
+			return false;
+	}
+
+	std::string data;
+	if (create)
+	{
+		Record header;
+		header.push_back(magic);
+		header.push_back(std::to_string(sourceHash));
+		header.push_back(std::to_string(sourceSize));
+		data = Encode(header);
+	}
+
+	if (records.size() > 1)
+	{
+		Record batch;
+		batch.push_back(batchMarker);
+		batch.push_back(std::to_string(records.size()));
+		data += Encode(batch);
+	}
+
+	for (const auto &record : records)
+		data += Encode(record);
+
+	return WriteAndSync(fileName, data, !create);
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Read
+//
+// Description:		Reads the journal.  Records from an incomplete batch
+//					(an interrupted append) are ignored.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		sourceHash	= uint64_t&
+//		sourceSize	= uint64_t&
+//		records		= std::vector<Record>&
+//
+// Return Value:
+//		bool, true for success, false if the journal is missing or invalid
+//
+//==========================================================================
+bool EditJournal::Read(const wxString &fileName, uint64_t &sourceHash,
+	uint64_t &sourceSize, std::vector<Record> &records)
+{
+	MappedFile file;
+	size_t validLength;
+	records.clear();
+	return ::wxFileExists(fileName) && file.Open(fileName) &&
+		Parse(file.GetData(), file.GetSize(), sourceHash, sourceSize, records, validLength);
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Parse
+//
+// Description:		Reads the journal's contents.  Records from an incomplete
+//					batch, and a final partial line, are ignored.
+//
+// Input Arguments:
+//		data		= const char*
+//		size		= const size_t&
+//
+// Output Arguments:
+//		sourceHash	= uint64_t&
+//		sourceSize	= uint64_t&
+//		records		= std::vector<Record>&
+//		validLength	= size_t&, [bytes] through the last complete append
+//
+// Return Value:
+//		bool, true for success, false if the journal is invalid
+//
+//==========================================================================
+bool EditJournal::Parse(const char *data, const size_t &size, uint64_t &sourceHash,
+	uint64_t &sourceSize, std::vector<Record> &records, size_t &validLength)
+{
+	const char *position(data);
+	const char *end(data + size);
+	validLength = 0;
+	bool haveHeader(false);
+	size_t batchStart(0), batchSize(0);
+	Record record;
+	while (position < end)
+	{
+		const char *lineEnd(position);
+		while (lineEnd < end && *lineEnd != '\n')
+			++lineEnd;
+
+		if (lineEnd == end)// Interrupted append
+			break;
+
+		if (!Decode(position, lineEnd, record))
+			return false;
+		position = lineEnd + 1;
+
+		if (haveHeader && record.size() == 2 && record[0] == batchMarker)
+		{
+			batchStart = records.size();
+			batchSize = std::strtoull(record[1].c_str(), NULL, 10);
+			continue;
+		}
+		else if (haveHeader)
+		{
+			records.push_back(record);
+			if (records.size() >= batchStart + batchSize)
+				validLength = position - data;
+			continue;
+		}
+
+		if (record.size() != 3 || record[0] != magic)
+			return false;
+
+		sourceHash = std::strtoull(record[1].c_str(), NULL, 10);
+		sourceSize = std::strtoull(record[2].c_str(), NULL, 10);
+		haveHeader = true;
+		validLength = position - data;
+	}
+
+	if (records.size() < batchStart + batchSize)
+		records.resize(batchStart);
+
+	return haveHeader;
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Sync
+//
+// Description:		Flushes the specified file to disk.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool EditJournal::Sync(const wxString &fileName)
+{
+	return WriteAndSync(fileName, std::string(), true);
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		SyncDirectory
+//
+// Description:		Flushes the directory containing the specified file to
+//					disk.  On Windows, renames are recorded by the file
+//					system's own journal and nothing is done.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool EditJournal::SyncDirectory(const wxString &fileName)
+{
+#ifdef __WXMSW__
+	(void)fileName;
+	return true;
+#else
+	wxFileName file(fileName);
+	file.MakeAbsolute();
+	const int descriptor(::open(file.GetPath().fn_str(), O_RDONLY | O_DIRECTORY));
+	if (descriptor < 0)
+		return false;
+
+	const bool ok(fsync(descriptor) == 0);
+	::close(descriptor);
+	return ok;
+#endif
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Truncate
+//
+// Description:		Shortens the specified file.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		length		= const uint64_t&, [bytes]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool EditJournal::Truncate(const wxString &fileName, const uint64_t &length)
+{
+#ifdef __WXMSW__
+	HANDLE file(CreateFileW(fileName.wc_str(), GENERIC_WRITE, 0, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER position;
+	position.QuadPart = static_cast<LONGLONG>(length);
+	const bool ok(SetFilePointerEx(file, position, NULL, FILE_BEGIN) && SetEndOfFile(file));
+	CloseHandle(file);
+	return ok;
+#else
+	return ::truncate(fileName.fn_str(), static_cast<off_t>(length)) == 0;
+#endif
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Encode
+//
+// Description:		Formats a record as one line.  Fields are separated by
+//					tabs; backslashes, tabs and line breaks within fields are
+//					escaped.
+//
+// Input Arguments:
+//		record	= const Record&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string EditJournal::Encode(const Record &record)
+{
+	std::string line;
+	for (size_t i = 0; i < record.size(); i++)
+	{
+		if (i > 0)
+			line += '\t';
+
+		for (const auto &c : record[i])
+		{
+			if (c == '\\')
+				line += "\\\\";
+			else if (c == '\t')
+				line += "\\t";
+			else if (c == '\n')
+				line += "\\n";
+			else if (c == '\r')
+				line += "\\r";
+			else
+				line += c;
+		}
+	}
+
+	return line + '\n';
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		Decode
+//
+// Description:		Splits a line (without its line break) into fields.
+//
+// Input Arguments:
+//		first	= const char*
+//		last	= const char*
+//
+// Output Arguments:
+//		record	= Record&
+//
+// Return Value:
+//		bool, false if the line contains an invalid escape sequence
+//
+//==========================================================================
+bool EditJournal::Decode(const char *first, const char *last, Record &record)
+{
+	record.assign(1, std::string());
+	for (const char *c = first; c < last; ++c)
+	{
+		if (*c == '\t')
+			record.push_back(std::string());
+		else if (*c != '\\')
+			record.back() += *c;
+		else if (++c == last)
+			return false;
+		else if (*c == '\\')
+			record.back() += '\\';
+		else if (*c == 't')
+			record.back() += '\t';
+		else if (*c == 'n')
+			record.back() += '\n';
+		else if (*c == 'r')
+			record.back() += '\r';
+		else
+			return false;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			EditJournal
+// Function:		WriteAndSync
+//
+// Description:		Writes the data to the file and flushes the file to disk.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		data		= const std::string&
+//		append		= const bool&, false to replace any existing contents
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool EditJournal::WriteAndSync(const wxString &fileName, const std::string &data, const bool &append)
+{
+#ifdef __WXMSW__
+	HANDLE file(CreateFileW(fileName.wc_str(), append ? FILE_APPEND_DATA : GENERIC_WRITE,
+		0, NULL, append ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL));
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD written;
+	bool ok(data.empty() || (WriteFile(file, data.data(), static_cast<DWORD>(data.size()),
+		&written, NULL) && written == data.size()));
+	ok = FlushFileBuffers(file) && ok;
+	CloseHandle(file);
+	return ok;
+#else
+	const int descriptor(::open(fileName.fn_str(),
+		O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644));
+	if (descriptor < 0)
+		return false;
+
+	bool ok(true);
+	size_t done(0);
+	while (ok && done < data.size())
+	{
+		const ssize_t written(::write(descriptor, data.data() + done, data.size() - done));
+		if (written < 0)
+			ok = false;
+		else
+			done += written;
+	}
+
+	ok = fsync(descriptor) == 0 && ok;
+	::close(descriptor);
+	return ok;
+#endif
+}
@@ -0,0 +1,65 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  editJournal.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Append-only log of edits to the conversion catalog.  Each append
+//				 is flushed to disk before returning, so saved edits survive a
+//				 crash without the catalog itself being rewritten.
+// History:
+
+#ifndef _EDIT_JOURNAL_H_
+#define _EDIT_JOURNAL_H_
+
+// Standard C++ headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// wxWidgets forward declarations
+class wxString;
+
+class EditJournal
+{
+public:
+	// One line per record; fields are UTF-8 and may contain any character
+	typedef std::vector<std::string> Record;
+
+	// The header identifies the catalog (by hash and size) the records apply
+	// to; it is only written when the journal is created (or replaced, if it
+	// is invalid).  Records appended together are read back together or (if
+	// the append was interrupted) not at all; the remains of an interrupted
+	// append are removed by the next one.
+	static bool Append(const wxString &fileName, const uint64_t &sourceHash,
+		const uint64_t &sourceSize, const std::vector<Record> &records);
+
+	// A final record that was not completely written is ignored
+	static bool Read(const wxString &fileName, uint64_t &sourceHash,
+		uint64_t &sourceSize, std::vector<Record> &records);
+
+	// Flushes a file that was written by other means to disk
+	static bool Sync(const wxString &fileName);
+
+	// Flushes the directory containing the file, so that a rename (or the
+	// creation of the file) is on disk
+	static bool SyncDirectory(const wxString &fileName);
+
+private:
+	static const std::string magic;
+	static const std::string batchMarker;// Followed by the record count
+
+	static std::string Encode(const Record &record);
+	static bool Decode(const char *first, const char *last, Record &record);
+	static bool Parse(const char *data, const size_t &size, uint64_t &sourceHash,
+		uint64_t &sourceSize, std::vector<Record> &records, size_t &validLength);
+	static bool Truncate(const wxString &fileName, const uint64_t &length);
+	static bool WriteAndSync(const wxString &fileName, const std::string &data, const bool &append);
+};
+
+#endif// _EDIT_JOURNAL_H_
@@ -0,0 +1,252 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogEmbedder.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Build tool that loads a catalog and writes it as the source of
+//				 the embedded catalog (see embeddedCatalog.h), with every
+//				 equation already solved and checked.
+// History:
+
+// Standard C++ headers
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// wxWidgets headers
+#include <wx/init.h>
+
+// Local headers
+#include "catalogEmbedder.h"
+#include "xmlConversionFactors.h"
+#include "embeddedCatalog.h"
+#include "messageReporter.h"
+
+// The engine this tool is linked with is built with EMBEDDED_CATALOG, but the
+// embedded catalog is what this tool generates, so it provides an empty one
+const EmbeddedCatalog::Equivalence EmbeddedCatalog::equivalences[1] = {};
+const EmbeddedCatalog::Group EmbeddedCatalog::groups[1] = {};
+const unsigned int EmbeddedCatalog::groupCount(0);
+
+//==========================================================================
+// Class:			CatalogEmbedder
+// Function:		Constant Definitions
+//
+// Description:		Constants for the CatalogEmbedder class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const char *CatalogEmbedder::name("catalog-embedder");
+
+//==========================================================================
+// Class:			CatalogEmbedder
+// Function:		Run
+//
+// Description:		Loads the catalog (which solves and checks every group)
+//					and writes the source file.  The output is written to a
+//					temporary file and renamed, so a failed run does not
+//					leave a partial source file behind.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ExitCode
+//
+//==========================================================================
+int CatalogEmbedder::Run(int argc, char *argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage:  " << name << " <catalog XML> <output file>" << std::endl;
+		return exitError;
+	}
+
+	MessageReporter::SetHandler([](const MessageReporter::Severity &severity, const wxString &message)
+	{
+		std::cerr << std::string(name) + (severity == MessageReporter::severityError ? ":  error:  " : ":  warning:  ")
+			+ message.utf8_str().data() + "\n" << std::flush;
+	});
+
+	const wxString inputName(wxString::FromUTF8(argv[1]));
+	if (!wxFileExists(inputName))
+	{
+		std::cerr << name << ":  cannot open '" << argv[1] << "'" << std::endl;
+		return exitError;
+	}
+
+	XMLConversionFactors catalog(inputName);
+	if (!catalog.Load())
+		return exitError;
+	else if (catalog.GroupCount() == 0)
+	{
+		std::cerr << name << ":  no groups found" << std::endl;
+		return exitError;
+	}
+
+	const std::string outputName(argv[2]);
+	const std::string temporaryName(outputName + ".tmp");
+	bool written(false);
+	std::ofstream out(temporaryName.c_str(), std::ios::binary);
+	if (out.is_open())
+	{
+		Write(catalog, outputName.substr(outputName.find_last_of("/\\") + 1), out);
+		out.close();
+		written = !out.fail();
+	}
+
+	if (!written || std::rename(temporaryName.c_str(), outputName.c_str()) != 0)
+	{
+		std::remove(temporaryName.c_str());
+		std::cerr << name << ":  cannot write '" << outputName << "'" << std::endl;
+		return exitError;
+	}
+
+	return exitSuccess;
+}
+
+//==========================================================================
+// Class:			CatalogEmbedder
+// Function:		Write
+//
+// Description:		Writes the catalog's tables.  The solutions and path
+//					flags are written with the equations, so loading the
+//					embedded catalog does not need to solve or check them.
+//
+// Input Arguments:
+//		catalog		= const XMLConversionFactors&
+//		outputName	= const std::string&, file name (without directory)
+//
+// Output Arguments:
+//		out			= std::ostream&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void CatalogEmbedder::Write(const XMLConversionFactors &catalog, const std::string &outputName,
+	std::ostream &out)
+{
+	out << "// File:  " << outputName << "\n"
+		<< "// Auth:  " << name << "\n"
+		<< "// Desc:  Automatically generated file containing the default conversion catalog.\n"
+		<< "\n"
+		<< "// Local headers\n"
+		<< "#include \"embeddedCatalog.h\"\n"
+		<< "\n"
+		<< "const EmbeddedCatalog::Equivalence EmbeddedCatalog::equivalences[] = {\n";
+
+	for (unsigned int i = 0; i < catalog.GroupCount(); i++)
+	{
+		for (const auto &e : catalog.GetGroup(i).equiv)
+			out << "\t{ " << Literal(e.aUnit) << ", " << Literal(e.bUnit) << ", " << Literal(e.equation)
+				<< ",\n\t\t" << Literal(e.aSolution) << ", " << Literal(e.bSolution) << ", "
+				<< (e.pathEdge ? "true" : "false") << " },\n";
+	}
+
+	out << "};\n"
+		<< "\n"
+		<< "const EmbeddedCatalog::Group EmbeddedCatalog::groups[] = {\n";
+
+	unsigned int firstEquivalence(0);
+	for (unsigned int i = 0; i < catalog.GroupCount(); i++)
+	{
+		const XMLConversionFactors::FactorGroup &group(catalog.GetGroup(i));
+		out << "\t{ " << Literal(group.name) << ", " << (group.display ? "true" : "false") << ", "
+			<< firstEquivalence << ", " << group.equiv.size() << " },\n";
+		firstEquivalence += group.equiv.size();
+	}
+
+	out << "};\n"
+		<< "\n"
+		<< "const unsigned int EmbeddedCatalog::groupCount = " << catalog.GroupCount() << ";\n";
+}
+
+//==========================================================================
+// Class:			CatalogEmbedder
+// Function:		Literal
+//
+// Description:		Formats the string as a C string literal (UTF-8).
+//
+// Input Arguments:
+//		s	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string CatalogEmbedder::Literal(const wxString &s)
+{
+	const std::string text(s.utf8_str().data());
+	std::string result("\"");
+	for (const char &c : text)
+	{
+		const unsigned char byte(static_cast<unsigned char>(c));
+		if (c == '\\' || c == '"' || c == '?')// '?' to avoid trigraphs
+		{
+			result += '\\';
+			result += c;
+		}
+		else if (byte < 32 || byte > 126)
+		{
+			char escape[5];
+			snprintf(escape, sizeof(escape), "\\%03o", byte);
+			result += escape;
+		}
+		else
+			result += c;
+	}
+
+	return result + "\"";
+}
+
+//==========================================================================
+// Class:			None
+// Function:		main
+//
+// Description:		Entry point for the catalog embedder.  wxWidgets is
+//					initialized without a GUI.
+//
+// Input Arguments:
+//		argc	= int
+//		argv	= char*[]
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, CatalogEmbedder::ExitCode
+//
+//==========================================================================
+int main(int argc, char *argv[])
+{
+	wxInitializer initializer;
+	if (!initializer.IsOk())
+	{
+		std::cerr << CatalogEmbedder::name << ":  cannot initialize wxWidgets" << std::endl;
+		return CatalogEmbedder::exitError;
+	}
+
+	return CatalogEmbedder().Run(argc, argv);
+}
@@ -0,0 +1,53 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  catalogEmbedder.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Build tool that loads a catalog and writes it as the source of
+//				 the embedded catalog (see embeddedCatalog.h), with every
+//				 equation already solved and checked.
+// History:
+
+#ifndef _CATALOG_EMBEDDER_H_
+#define _CATALOG_EMBEDDER_H_
+
+// Standard C++ headers
+#include <ostream>
+#include <string>
+
+// wxWidgets headers
+#include <wx/string.h>
+
+// Local forward declarations
+class XMLConversionFactors;
+
+class CatalogEmbedder
+{
+public:
+	// Usage:  catalog-embedder <catalog XML> <output file>
+	int Run(int argc, char *argv[]);
+
+	enum ExitCode
+	{
+		exitSuccess = 0,
+		exitError = 1// Invalid arguments, or the catalog could not be read or written
+	};
+
+	static const char *name;
+
+private:
+	static void Write(const XMLConversionFactors &catalog, const std::string &outputName,
+		std::ostream &out);
+
+	// A C string literal.  Bytes outside printable ASCII are written as octal
+	// escapes, so the output does not depend on the compiler's character set.
+	static std::string Literal(const wxString &s);
+};
+
+#endif// _CATALOG_EMBEDDER_H_
@@ -0,0 +1,49 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  embeddedCatalog.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Default conversion catalog, compiled into the executable.  The
+//				 tables are generated from conversions.xml by catalog-embedder
+//				 (src/embed) and are only available when EMBEDDED_CATALOG is
+//				 defined.
+// History:
+
+#ifndef _EMBEDDED_CATALOG_H_
+#define _EMBEDDED_CATALOG_H_
+
+namespace EmbeddedCatalog
+{
+	// All strings are UTF-8
+	struct Equivalence
+	{
+		const char *aUnit;
+		const char *bUnit;
+		const char *equation;
+
+		// Solved and checked when the tables were generated
+		const char *aSolution;// Empty if the equation could not be solved for a
+		const char *bSolution;
+		bool pathEdge;
+	};
+
+	struct Group
+	{
+		const char *name;
+		bool display;
+		unsigned int firstEquivalence;
+		unsigned int equivalenceCount;
+	};
+
+	extern const Equivalence equivalences[];
+	extern const Group groups[];
+	extern const unsigned int groupCount;
+}
+
+#endif// _EMBEDDED_CATALOG_H_
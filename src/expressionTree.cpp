@@ -12,12 +12,17 @@
 // Description:  Handles user-specified mathematical operations on datasets.
 // History:
 
+// Standard C++ headers
+#include <cmath>
+
 // wxWidgets headers
 #include <wx/wx.h>
 
 // Local headers
 #include "expressionTree.h"
 #include "convertMath.h"
+#include "numberFormatter.h"
+#include "numberParser.h"
 
 //==========================================================================
 // Class:			ExpressionTree
@@ -36,6 +41,8 @@
 //
 //==========================================================================
 const unsigned int ExpressionTree::printfPrecision = 15;
+const wxString ExpressionTree::unaryMinus = _T("~");
+const std::vector<wxString> ExpressionTree::functions = { _T("sqrt"), _T("log10"), _T("ln"), _T("exp"), _T("pow") };
 
 //==========================================================================
 // Class:			ExpressionTree
@@ -69,6 +76,39 @@ wxString ExpressionTree::Solve(wxString expression, double &result)
 	return errorString;
 }
 
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		GetPostfix
+//
+// Description:		Parses the expression and returns the Reverse Polish Notation
+//					queue without evaluating it.  Used by objects that compile
+//					the expression into another form.
+//
+// Input Arguments:
+//		expression	= const wxString& containing the expression to parse
+//
+// Output Arguments:
+//		postfix		= std::queue<wxString>& containing the parsed terms
+//
+// Return Value:
+//		wxString, empty for success, error string if unsuccessful
+//
+//==========================================================================
+wxString ExpressionTree::GetPostfix(const wxString &expression, std::queue<wxString> &postfix)
+{
+	if (!ParenthesesBalanced(expression))
+		return _T("Imbalanced parentheses!");
+
+	wxString errorString(ParseExpression(expression));
+	if (!errorString.IsEmpty())
+		return errorString;
+
+	postfix = outputQueue;
+	outputQueue = std::queue<wxString>();
+
+	return wxEmptyString;
+}
+
 //==========================================================================
 // Class:			ExpressionTree
 // Function:		ParenthesesBalanced
@@ -176,8 +216,22 @@ wxString ExpressionTree::ParseNext(const wxString &expression, bool &lastWasOper
 	bool thisWasOperator(false);
 	if (NextIsNumber(expression, &advance, lastWasOperator))
 		outputQueue.push(expression.Mid(0, advance));
+	else if (NextIsFunction(expression, &advance))
+	{
+		if (!lastWasOperator)
+			ProcessOperator(operatorStack, _T("*"));
+		operatorStack.push(expression.Mid(0, advance));
+		thisWasOperator = true;
+	}
 	else if (NextIsVariable(expression, &advance))
 		outputQueue.push(expression.Mid(0, advance));
+	else if (expression[0] == '-' && lastWasOperator)
+	{
+		// Prefix operator - has no left operand, so nothing is popped
+		operatorStack.push(unaryMinus);
+		advance = 1;
+		thisWasOperator = true;
+	}
 	else if (NextIsOperator(expression, &advance))
 	{
 		ProcessOperator(operatorStack, expression.Mid(0, advance));
@@ -196,6 +250,13 @@ wxString ExpressionTree::ParseNext(const wxString &expression, bool &lastWasOper
 		ProcessCloseParenthese(operatorStack);
 		advance = 1;
 	}
+	else if (expression[0] == ',')
+	{
+		if (!ProcessArgumentSeparator(operatorStack))
+			return _T("Unexpected ',' outside of function arguments.");
+		advance = 1;
+		thisWasOperator = true;
+	}
 	else
 		return _T("Unrecognized character:  '") + expression.Mid(0, 1) + _T("'.");
 	lastWasOperator = thisWasOperator;
@@ -226,8 +287,9 @@ void ExpressionTree::ProcessOperator(std::stack<wxString> &operatorStack, const
 	// Handle operator precedence
 	while (!operatorStack.empty())
 	{
-		if ((!NextIsOperator(operatorStack.top()) ||
-			!OperatorShift(operatorStack.top(), s)))
+		if ((!NextIsOperator(operatorStack.top()) &&
+			operatorStack.top().Cmp(unaryMinus) != 0) ||
+			!OperatorShift(operatorStack.top(), s))
 			break;
 		PopStackToQueue(operatorStack);
 	}
@@ -239,7 +301,8 @@ void ExpressionTree::ProcessOperator(std::stack<wxString> &operatorStack, const
 // Function:		ProcessCloseParenthese
 //
 // Description:		Adjusts the stacks in response to encountering a close
-//					parenthese.
+//					parenthese.  If the parentheses enclosed function arguments,
+//					the function is moved to the queue, too.
 //
 // Input Arguments:
 //		operatorStack	= std::stack<wxString>&
@@ -268,6 +331,38 @@ void ExpressionTree::ProcessCloseParenthese(std::stack<wxString> &operatorStack)
 	}
 
 	operatorStack.pop();
+
+	if (!operatorStack.empty() && IsFunction(operatorStack.top()))
+		PopStackToQueue(operatorStack);
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		ProcessArgumentSeparator
+//
+// Description:		Adjusts the stacks in response to encountering a comma
+//					between function arguments.
+//
+// Input Arguments:
+//		operatorStack	= std::stack<wxString>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false if the comma is not within parentheses
+//
+//==========================================================================
+bool ExpressionTree::ProcessArgumentSeparator(std::stack<wxString> &operatorStack)
+{
+	while (!operatorStack.empty())
+	{
+		if (operatorStack.top().Cmp(_T("(")) == 0)
+			return true;
+		PopStackToQueue(operatorStack);
+	}
+
+	return false;
 }
 
 //==========================================================================
@@ -461,6 +556,90 @@ bool ExpressionTree::NextIsOperator(const wxString &s, unsigned int *stop)
 	return false;
 }
 
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		NextIsFunction
+//
+// Description:		Determines if the next portion of the expression is a
+//					function call (a function name followed by a parenthese).
+//
+// Input Arguments:
+//		s		= const wxString& containing the expression
+//
+// Output Arguments:
+//		stop	= unsigned int* (optional) indicating length of the function name
+//
+// Return Value:
+//		bool, true if a function is next in the expression
+//
+//==========================================================================
+bool ExpressionTree::NextIsFunction(const wxString &s, unsigned int *stop)
+{
+	for (const auto &function : functions)
+	{
+		if (s.StartsWith(function) &&
+			s.Mid(function.Len()).Trim(false).StartsWith(_T("(")))
+		{
+			if (stop)
+				*stop = function.Len();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		IsFunction
+//
+// Description:		Determines if the string is the name of a supported function.
+//
+// Input Arguments:
+//		s	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if s is a function name
+//
+//==========================================================================
+bool ExpressionTree::IsFunction(const wxString &s)
+{
+	for (const auto &function : functions)
+	{
+		if (s.Cmp(function) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		GetArgumentCount
+//
+// Description:		Returns the number of arguments expected by the function.
+//
+// Input Arguments:
+//		function	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		unsigned int
+//
+//==========================================================================
+unsigned int ExpressionTree::GetArgumentCount(const wxString &function)
+{
+	if (function.Cmp(_T("pow")) == 0)
+		return 2;
+
+	return 1;
+}
+
 //==========================================================================
 // Class:			ExpressionTree
 // Function:		OperatorShift
@@ -527,8 +706,10 @@ unsigned int ExpressionTree::GetPrecedence(const wxString &s) const
 		s[0] == '/' ||
 		s[0] == '%')
 		return 3;
-	else if (s[0] == '^')
+	else if (s.Cmp(unaryMinus) == 0)
 		return 4;
+	else if (s[0] == '^')
+		return 5;
 
 	return 0;
 }
@@ -623,6 +804,40 @@ double ExpressionTree::ApplyOperation(const wxString &operation,
 	return 0.0;
 }
 
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		ApplyFunction
+//
+// Description:		Applies the specified function to the specified arguments.
+//
+// Input Arguments:
+//		function	= const wxString& describing the function to apply
+//		arguments	= const double* in the order they appear in the expression
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double containing the result of the function
+//
+//==========================================================================
+double ExpressionTree::ApplyFunction(const wxString &function, const double *arguments) const
+{
+	if (function.Cmp(_T("sqrt")) == 0)
+		return sqrt(arguments[0]);
+	else if (function.Cmp(_T("log10")) == 0)
+		return log10(arguments[0]);
+	else if (function.Cmp(_T("ln")) == 0)
+		return log(arguments[0]);
+	else if (function.Cmp(_T("exp")) == 0)
+		return exp(arguments[0]);
+	else if (function.Cmp(_T("pow")) == 0)
+		return pow(arguments[0], arguments[1]);
+
+	assert(false);
+	return 0.0;
+}
+
 //==========================================================================
 // Class:			ExpressionTree
 // Function:		EvaluateOperator
@@ -680,12 +895,52 @@ bool ExpressionTree::EvaluateUnaryOperator(const wxString &operation, std::stack
 		errorString = _T("Attempting to apply operator without two operands!");
 		return false;
 	}
+	else if (stack.empty())
+	{
+		errorString = _T("Attempting to apply operator without an operand!");
+		return false;
+	}
 
 	stack.push(ApplyOperation(_T("*"), -1.0, PopFromStack(stack)));
 
 	return true;
 }
 
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		EvaluateFunction
+//
+// Description:		Evaluates the function specified.
+//
+// Input Arguments:
+//		function	= const wxString& describing the function to apply
+//		stack		= std::stack<double>&
+//
+// Output Arguments:
+//		errorString		= wxString&
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool ExpressionTree::EvaluateFunction(const wxString &function, std::stack<double> &stack,
+	wxString &errorString) const
+{
+	const unsigned int count(GetArgumentCount(function));
+	if (stack.size() < count)
+	{
+		errorString = _T("Not enough arguments for '") + function + _T("'!");
+		return false;
+	}
+
+	double arguments[2];
+	for (unsigned int i = count; i > 0; i--)
+		arguments[i - 1] = PopFromStack(stack);
+	stack.push(ApplyFunction(function, arguments));
+
+	return true;
+}
+
 //==========================================================================
 // Class:			ExpressionTree
 // Function:		EvaluateNumber
@@ -708,7 +963,7 @@ bool ExpressionTree::EvaluateNumber(const wxString &number, std::stack<double> &
 {
 	double value;
 
-	if (!number.ToDouble(&value))
+	if (!NumberParser::Parse(number, value))
 	{
 		errorString = _T("Could not convert ") + number + _T(" to a number.");
 		return false;
@@ -742,8 +997,12 @@ bool ExpressionTree::EvaluateNext(const wxString &next, std::stack<double> &stac
 {
 	if (NextIsNumber(next))
 		return EvaluateNumber(next, stack, errorString);
+	else if (next.Cmp(unaryMinus) == 0)
+		return EvaluateUnaryOperator(_T("-"), stack, errorString);
 	else if(NextIsOperator(next))
 		return EvaluateOperator(next, stack, errorString);
+	else if (IsFunction(next))
+		return EvaluateFunction(next, stack, errorString);
 	else
 		errorString = _T("Unable to evaluate '") + next + _T("'.");
 
@@ -893,7 +1152,7 @@ size_t ExpressionTree::FindEndOfNextTerm(const wxString &s, const unsigned int &
 //==========================================================================
 wxString ExpressionTree::SolveForString(wxString expression, const wxString &x, wxString &result)
 {
-	assert(expression.Contains(x));
+	assert(ContainsVariable(expression, x));
 
 	wxString lhs, rhs;
 	if (!SeparateSides(expression, lhs, rhs))
@@ -908,7 +1167,7 @@ wxString ExpressionTree::SolveForString(wxString expression, const wxString &x,
 	wxArrayString lhTerms, rhTerms;
 	wxString errorString;
 	bool changed(true);
-	while ((lhs.Cmp(x) != 0 || rhs.Contains(x)) && changed)
+	while ((lhs.Cmp(x) != 0 || ContainsVariable(rhs, x)) && changed)
 	{
 		changed = false;
 
@@ -917,7 +1176,7 @@ wxString ExpressionTree::SolveForString(wxString expression, const wxString &x,
 
 		for (size_t i = 0; i < rhTerms.Count(); i++)
 		{
-			if (rhTerms[i].Contains(x))
+			if (ContainsVariable(rhTerms[i], x))
 			{
 				lhTerms.Add(InvertTerm(rhTerms[i]));
 				rhTerms.RemoveAt(i);
@@ -930,7 +1189,7 @@ wxString ExpressionTree::SolveForString(wxString expression, const wxString &x,
 
 		for (size_t i = 0; i < lhTerms.Count(); i++)
 		{
-			if (!lhTerms[i].Contains(x))
+			if (!ContainsVariable(lhTerms[i], x))
 			{
 				rhTerms.Add(InvertTerm(lhTerms[i]));
 				lhTerms.RemoveAt(i);
@@ -950,11 +1209,17 @@ wxString ExpressionTree::SolveForString(wxString expression, const wxString &x,
 		else if (lhTerms[0].Cmp(x) != 0)
 		{
 			changed = Clean(lhTerms[0], x) || changed;
-			if (lhTerms[0][0] == '(' && lhTerms[0].Last() == ')')
+			if (EnclosedInParentheses(lhTerms[0]))
 			{
 				lhTerms[0] = lhTerms[0].Mid(1, lhTerms[0].Len() - 2);
 				changed = true;
 			}
+			else if (VariableIsNested(lhTerms[0], x) ||
+				FindAtTopLevel(lhTerms[0], _T("^")) != static_cast<size_t>(wxNOT_FOUND))
+			{
+				errorString = IsolateFactor(lhTerms[0], rhTerms, x);
+				changed = true;
+			}
 			else
 			{
 				assert(lhTerms.Count() == 1 &&
@@ -997,7 +1262,7 @@ wxString ExpressionTree::SolveForString(wxString expression, const wxString &x,
 //==========================================================================
 bool ExpressionTree::Clean(wxString &term, const wxString &x)
 {
-	int xLocation = term.Find(x);
+	int xLocation = FindVariable(term, x);
 
 	if (xLocation > 0)
 	{
@@ -1033,11 +1298,11 @@ bool ExpressionTree::Clean(wxString &term, const wxString &x)
 wxString ExpressionTree::CrossMultiplySimplify(wxString &lhs, wxArrayString &rhs, const wxString &x) const
 {
 	// FIXME:  Would be good to add parentheses checks here!
-	if (!lhs.Contains(x))
+	if (!ContainsVariable(lhs, x))
 		return _T("Left-hand side must contain '") + x + _T("'.");
 
 	wxString start, end;
-	int xLocation = lhs.Find(x);
+	int xLocation = FindVariable(lhs, x);
 	start = lhs.Mid(0, xLocation);
 	if (lhs.Last() == x)
 		end = wxEmptyString;
@@ -1092,6 +1357,308 @@ wxString ExpressionTree::CrossMultiplySimplify(wxString &lhs, wxArrayString &rhs
 	return wxEmptyString;
 }
 
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		IsolateFactor
+//
+// Description:		Handles a left-hand side term where x appears within
+//					parentheses, a function or a power.  Factors that do not
+//					contain x are moved to the right-hand side, then one level
+//					of nesting is removed from the factor that does (by applying
+//					the inverse function to the right-hand side).  The caller
+//					repeats until x is isolated.
+//
+// Input Arguments:
+//		lhs	= wxString&
+//		rhs	= wxArrayString&
+//		x	= const wxString& to solve for
+//
+// Output Arguments:
+//		lhs	= wxString&
+//		rhs	= wxArrayString&
+//
+// Return Value:
+//		wxString, empty for success, error string otherwise
+//
+//==========================================================================
+wxString ExpressionTree::IsolateFactor(wxString &lhs, wxArrayString &rhs, const wxString &x) const
+{
+	wxString right(AssembleTerms(rhs));
+	if (lhs[0] == '-')
+	{
+		right = _T("-(") + right + _T(")");
+		lhs = lhs.Mid(1);
+	}
+	else if (lhs[0] == '+')
+		lhs = lhs.Mid(1);
+
+	wxString factor;
+	bool found(false), inDenominator(false);
+	wxChar operation('*');
+	size_t start(0), end;
+	do
+	{
+		end = FindAtTopLevel(lhs, _T("*/"), start);
+		wxString next;
+		if (end == static_cast<size_t>(wxNOT_FOUND))
+			next = lhs.Mid(start);
+		else
+			next = lhs.Mid(start, end - start);
+
+		if (ContainsVariable(next, x))
+		{
+			if (found)
+				return _T("Expression is too complicated!");
+			found = true;
+			factor = next;
+			inDenominator = operation == '/';
+		}
+		else if (operation == '*')
+			right = _T("(") + right + _T(")/(") + next + _T(")");
+		else
+			right = _T("(") + right + _T(")*(") + next + _T(")");
+
+		if (end != static_cast<size_t>(wxNOT_FOUND))
+		{
+			operation = lhs[end];
+			start = end + 1;
+		}
+	} while (end != static_cast<size_t>(wxNOT_FOUND));
+
+	if (!found)
+		return _T("Left-hand side must contain '") + x + _T("'.");
+
+	if (inDenominator)
+		right = _T("1/(") + right + _T(")");
+
+	wxString errorString;
+	const size_t power(FindAtTopLevel(factor, _T("^")));
+	lhs = factor;
+	if (power != static_cast<size_t>(wxNOT_FOUND))
+		errorString = InvertPower(factor.Mid(0, power), factor.Mid(power + 1), lhs, right, x);
+	else if (EnclosedInParentheses(factor))
+		lhs = factor.Mid(1, factor.Len() - 2);
+	else if (factor.Cmp(x) != 0)
+		errorString = InvertFunction(lhs, right, x);
+
+	rhs.Clear();
+	rhs.Add(right);
+
+	return errorString;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		InvertFunction
+//
+// Description:		Replaces a left-hand side of the form f(...) with its
+//					arguments by applying the inverse of f to the right-hand side.
+//
+// Input Arguments:
+//		lhs	= wxString& containing the function call
+//		rhs	= wxString&
+//		x	= const wxString& to solve for
+//
+// Output Arguments:
+//		lhs	= wxString&
+//		rhs	= wxString&
+//
+// Return Value:
+//		wxString, empty for success, error string otherwise
+//
+//==========================================================================
+wxString ExpressionTree::InvertFunction(wxString &lhs, wxString &rhs, const wxString &x) const
+{
+	unsigned int length;
+	if (!NextIsFunction(lhs, &length))
+		return _T("Could not extract '") + x + _T("' from left-hand side!");
+
+	const wxString function(lhs.Mid(0, length));
+	wxString arguments(lhs.Mid(length));
+	arguments.Trim(false);
+	if (!EnclosedInParentheses(arguments))
+		return _T("Could not extract '") + x + _T("' from left-hand side!");
+	arguments = arguments.Mid(1, arguments.Len() - 2);
+
+	if (function.Cmp(_T("pow")) == 0)
+	{
+		const size_t comma(FindAtTopLevel(arguments, _T(",")));
+		if (comma == static_cast<size_t>(wxNOT_FOUND))
+			return _T("Not enough arguments for '") + function + _T("'!");
+		return InvertPower(arguments.Mid(0, comma), arguments.Mid(comma + 1), lhs, rhs, x);
+	}
+
+	lhs = arguments;
+	if (function.Cmp(_T("sqrt")) == 0)
+		rhs = _T("(") + rhs + _T(")^2");
+	else if (function.Cmp(_T("log10")) == 0)
+		rhs = _T("10^(") + rhs + _T(")");
+	else if (function.Cmp(_T("ln")) == 0)
+		rhs = _T("exp(") + rhs + _T(")");
+	else if (function.Cmp(_T("exp")) == 0)
+		rhs = _T("ln(") + rhs + _T(")");
+	else
+		assert(false);
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		InvertPower
+//
+// Description:		Replaces a left-hand side of the form base^exponent with
+//					whichever of the two contains x.  Powers of x are inverted
+//					with a root, exponentials with a logarithm.
+//
+// Input Arguments:
+//		base		= const wxString&
+//		exponent	= const wxString&
+//		lhs			= wxString&
+//		rhs			= wxString&
+//		x			= const wxString& to solve for
+//
+// Output Arguments:
+//		lhs	= wxString&
+//		rhs	= wxString&
+//
+// Return Value:
+//		wxString, empty for success, error string otherwise
+//
+//==========================================================================
+wxString ExpressionTree::InvertPower(const wxString &base, const wxString &exponent,
+	wxString &lhs, wxString &rhs, const wxString &x) const
+{
+	const bool inBase(ContainsVariable(base, x));
+	const bool inExponent(ContainsVariable(exponent, x));
+	if (inBase && inExponent)
+		return _T("Expression is too complicated!");
+
+	if (inBase)
+	{
+		if (exponent.Cmp(_T("2")) == 0)
+			rhs = _T("sqrt(") + rhs + _T(")");
+		else
+			rhs = _T("(") + rhs + _T(")^(1/(") + exponent + _T("))");
+		lhs = base;
+	}
+	else
+	{
+		if (base.Cmp(_T("10")) == 0)
+			rhs = _T("log10(") + rhs + _T(")");
+		else
+			rhs = _T("ln(") + rhs + _T(")/ln(") + base + _T(")");
+		lhs = exponent;
+	}
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		VariableIsNested
+//
+// Description:		Determines if x appears within parentheses in the term.
+//
+// Input Arguments:
+//		term	= const wxString&
+//		x		= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if any occurrence of x is enclosed in parentheses
+//
+//==========================================================================
+bool ExpressionTree::VariableIsNested(const wxString &term, const wxString &x)
+{
+	int location = FindVariable(term, x);
+	while (location != wxNOT_FOUND)
+	{
+		int depth(0);
+		for (int i = 0; i < location; i++)
+		{
+			if (term[i] == '(')
+				depth++;
+			else if (term[i] == ')')
+				depth--;
+		}
+
+		if (depth > 0)
+			return true;
+		location = FindVariable(term, x, location + 1);
+	}
+
+	return false;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		EnclosedInParentheses
+//
+// Description:		Determines if the entire string is enclosed in one pair of
+//					parentheses (i.e. "(a)*(b)" is not, but "((a)*(b))" is).
+//
+// Input Arguments:
+//		s	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool ExpressionTree::EnclosedInParentheses(const wxString &s)
+{
+	if (s.Len() < 2 || s[0] != '(' || s.Last() != ')')
+		return false;
+
+	return FindAtTopLevel(s, _T(")")) == s.Len() - 1;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		FindAtTopLevel
+//
+// Description:		Finds the first of the specified characters that is not
+//					enclosed in parentheses.  A closing parenthese is reported
+//					where it returns to the top level.
+//
+// Input Arguments:
+//		s			= const wxString&
+//		characters	= const wxString& containing the characters to search for
+//		start		= const size_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		size_t, location of the character or wxNOT_FOUND
+//
+//==========================================================================
+size_t ExpressionTree::FindAtTopLevel(const wxString &s, const wxString &characters, const size_t &start)
+{
+	unsigned int depth(0);
+	for (size_t i = start; i < s.Len(); i++)
+	{
+		if (s[i] == '(')
+			depth++;
+		else if (s[i] == ')')
+		{
+			if (depth > 0)
+				depth--;
+			if (depth == 0 && characters.Find(s[i]) != wxNOT_FOUND)
+				return i;
+		}
+		else if (depth == 0 && characters.Find(s[i]) != wxNOT_FOUND)
+			return i;
+	}
+
+	return static_cast<size_t>(wxNOT_FOUND);
+}
+
 //==========================================================================
 // Class:			ExpressionTree
 // Function:		AssembleTerms
@@ -1141,15 +1708,15 @@ wxString ExpressionTree::AssembleTerms(const wxArrayString &terms) const
 //==========================================================================
 bool ExpressionTree::CombinedTerm(const wxString &term) const
 {
-	wxString variables;
-	for (size_t i = 0; i < term.Len(); i++)
+	const wxString variables[] = { _T("a"), _T("b"), _T("x") };
+	unsigned int count(0);
+	for (const auto &variable : variables)
 	{
-		if ((term[i] == 'a' || term[i] == 'b' || term[i] == 'x') &&
-			!variables.Contains(term.Mid(i, 1)))
-			variables.Append(term.Mid(i, 1));
+		if (ContainsVariable(term, variable))
+			count++;
 	}
 
-	return variables.Len() > 1;
+	return count > 1;
 }
 
 //==========================================================================
@@ -1244,9 +1811,8 @@ wxString ExpressionTree::EvaluateExpression(wxString &results)
 		return "Not enough operators!";
 
 	if (useDoubleStack.top())
-		results = wxString::Format("%0.*f",
-			ConvertMath::GetPrecision(doubleStack.top(), printfPrecision),
-			doubleStack.top());
+		results = NumberFormatter::Format(doubleStack.top(), NumberFormatter::Style::Fixed,
+			ConvertMath::GetPrecision(doubleStack.top(), printfPrecision));
 	else
 		results = stringStack.top();
 
@@ -1319,6 +1885,91 @@ bool ExpressionTree::NextIsVariable(const wxString &s, unsigned int *stop)
 
 	return false;
 }
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		FindVariable
+//
+// Description:		Finds the next occurrence of the specified variable.  Letters
+//					that are part of a longer name (i.e. the 'x' in "exp") are
+//					not variables.
+//
+// Input Arguments:
+//		s		= const wxString&
+//		x		= const wxString& variable name
+//		start	= const size_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, location of the variable or wxNOT_FOUND
+//
+//==========================================================================
+int ExpressionTree::FindVariable(const wxString &s, const wxString &x, const size_t &start)
+{
+	int location = s.find(x, start);
+	while (location != wxNOT_FOUND)
+	{
+		const size_t after(location + x.Len());
+		if ((location == 0 || !wxIsalpha(s[location - 1])) &&
+			(after >= s.Len() || !wxIsalpha(s[after])))
+			return location;
+		location = s.find(x, location + 1);
+	}
+
+	return wxNOT_FOUND;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		ContainsVariable
+//
+// Description:		Determines if the string contains the specified variable.
+//
+// Input Arguments:
+//		s	= const wxString&
+//		x	= const wxString& variable name
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool ExpressionTree::ContainsVariable(const wxString &s, const wxString &x)
+{
+	return FindVariable(s, x) != wxNOT_FOUND;
+}
+
+//==========================================================================
+// Class:			ExpressionTree
+// Function:		ReplaceVariable
+//
+// Description:		Replaces all occurrences of the specified variable.
+//
+// Input Arguments:
+//		s			= wxString&
+//		x			= const wxString& variable name
+//		replacement	= const wxString&
+//
+// Output Arguments:
+//		s			= wxString&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void ExpressionTree::ReplaceVariable(wxString &s, const wxString &x, const wxString &replacement)
+{
+	int location = FindVariable(s, x);
+	while (location != wxNOT_FOUND)
+	{
+		s = s.Mid(0, location) + replacement + s.Mid(location + x.Len());
+		location = FindVariable(s, x, location + replacement.Len());
+	}
+}
 /*
 //==========================================================================
 // Class:			ExpressionTree
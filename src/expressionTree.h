@@ -19,6 +19,7 @@
 #include <queue>
 #include <stack>
 #include <string>
+#include <vector>
 
 // wxWidgets headers
 #include <wx/wx.h>
@@ -29,11 +30,24 @@ public:
 	// Main solver method
 	wxString Solve(wxString expression, double &result);
 	wxString SolveForString(wxString expression, const wxString &x, wxString &result);
+	wxString GetPostfix(const wxString &expression, std::queue<wxString> &postfix);
 
 	static bool Clean(wxString &term, const wxString &x);
 
+	// Token used in the postfix queue to represent negation
+	static const wxString unaryMinus;
+
+	static bool IsFunction(const wxString &s);
+	static unsigned int GetArgumentCount(const wxString &function);
+
+	// Variable helpers that ignore letters belonging to function names
+	static int FindVariable(const wxString &s, const wxString &x, const size_t &start = 0);
+	static bool ContainsVariable(const wxString &s, const wxString &x);
+	static void ReplaceVariable(wxString &s, const wxString &x, const wxString &replacement);
+
 private:
 	static const unsigned int printfPrecision;
+	static const std::vector<wxString> functions;
 
 	std::queue<wxString> outputQueue;
 
@@ -44,10 +58,12 @@ private:
 
 	void ProcessOperator(std::stack<wxString> &operatorStack, const wxString &s);
 	void ProcessCloseParenthese(std::stack<wxString> &operatorStack);
+	bool ProcessArgumentSeparator(std::stack<wxString> &operatorStack);
 
 	static bool NextIsNumber(const wxString &s, unsigned int *stop = NULL, const bool &lastWasOperator = true);
 	static bool NextIsOperator(const wxString &s, unsigned int *stop = NULL);
 	static bool NextIsVariable(const wxString &s, unsigned int *stop = NULL);
+	static bool NextIsFunction(const wxString &s, unsigned int *stop = NULL);
 
 	static size_t FindEndOfNextTerm(const wxString &s, const unsigned int &start);
 
@@ -60,11 +76,13 @@ private:
 
 	double PopFromStack(std::stack<double> &stack) const;
 	double ApplyOperation(const wxString &operation, const double &first, const double &second) const;
+	double ApplyFunction(const wxString &function, const double *arguments) const;
 
 	bool EvaluateNext(const wxString &next, std::stack<double> &stack, wxString &errorString) const;
 	bool EvaluateNumber(const wxString &number, std::stack<double> &stack, wxString &errorString) const;
 	bool EvaluateOperator(const wxString &operation, std::stack<double> &stack, wxString &errorString) const;
 	bool EvaluateUnaryOperator(const wxString &operation, std::stack<double> &stack, wxString &errorString) const;
+	bool EvaluateFunction(const wxString &function, std::stack<double> &stack, wxString &errorString) const;
 
 	bool ParenthesesBalanced(const wxString &expression) const;
 
@@ -75,6 +93,14 @@ private:
 	wxString InvertTerm(const wxString &term) const;
 	wxString AssembleTerms(const wxArrayString &terms) const;
 	wxString CrossMultiplySimplify(wxString &lhs, wxArrayString &rhs, const wxString &x) const;
+	wxString IsolateFactor(wxString &lhs, wxArrayString &rhs, const wxString &x) const;
+	wxString InvertFunction(wxString &lhs, wxString &rhs, const wxString &x) const;
+	wxString InvertPower(const wxString &base, const wxString &exponent,
+		wxString &lhs, wxString &rhs, const wxString &x) const;
+
+	static bool VariableIsNested(const wxString &term, const wxString &x);
+	static bool EnclosedInParentheses(const wxString &s);
+	static size_t FindAtTopLevel(const wxString &s, const wxString &characters, const size_t &start = 0);
 };
 
 #endif// _EXPRESSION_TREE_H_
\ No newline at end of file
@@ -0,0 +1,660 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  layeredCatalog.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Combines several catalogs (e.g. system, site and user) into one,
+//				 with each catalog taking precedence over those before it.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+// Local headers
+#include "layeredCatalog.h"
+#include "parallel.h"
+#include "messageReporter.h"
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		Constant Definitions
+//
+// Description:		Constants for the LayeredCatalog class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+const wxString LayeredCatalog::siteCatalogVariable(_T("CONVERTER_SITE_CATALOG"));
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		LayeredCatalog
+//
+// Description:		Constructor for LayeredCatalog class.
+//
+// Input Arguments:
+//		fileNames	= const std::vector<wxString>&, base catalog first
+//		lazy		= const bool&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+LayeredCatalog::LayeredCatalog(const std::vector<wxString> &fileNames, const bool &lazy)
+{
+	for (unsigned int i = 0; i < fileNames.size(); i++)
+		layers.push_back(std::make_unique<XMLConversionFactors>(fileNames[i], lazy, i > 0));
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GetSharedFileNames
+//
+// Description:		Lists the catalogs beneath the user's own:  the catalog
+//					installed with the application (a catalog generated in
+//					another format is used if there is no XML) and the
+//					site-wide catalog, if the environment variable names one.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::vector<wxString>, lowest precedence first
+//
+//==========================================================================
+std::vector<wxString> LayeredCatalog::GetSharedFileNames()
+{
+	std::vector<wxString> fileNames(1, _T("conversions.xml"));
+	if (!::wxFileExists(fileNames.front()))
+	{
+		if (::wxFileExists(_T("conversions.jsonl")))
+			fileNames.front() = _T("conversions.jsonl");
+		else if (::wxFileExists(_T("conversions.ccol")))
+			fileNames.front() = _T("conversions.ccol");
+	}
+
+	wxString siteFileName;
+	if (wxGetEnv(siteCatalogVariable, &siteFileName) && !siteFileName.IsEmpty())
+		fileNames.push_back(siteFileName);
+
+	return fileNames;
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		Load
+//
+// Description:		Loads every layer (each from its own cache, where it is
+//					current) and merges them.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool LayeredCatalog::Load()
+{
+	// Every layer is loaded, so that all of the errors are reported
+	bool loaded(true);
+	for (auto &layer : layers)
+		loaded = layer->Load() && loaded;
+
+	// Nothing is kept from before
+	entries.clear();
+	entryIndex.clear();
+	combinedGroups.clear();
+	if (!loaded)
+		return false;
+
+	const wxString warnings(Merge());
+	if (!warnings.IsEmpty())
+		MessageReporter::Warning(_T("Warning combining catalogs:  ") + warnings + _T("."));
+
+	return true;
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		Save
+//
+// Description:		Saves the edits (all of which are in the last layer).
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void LayeredCatalog::Save()
+{
+	layers.back()->Save();
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		Merge
+//
+// Description:		Builds the merged index.  Groups keep the order of the
+//					earliest layer that has them; a group first found in a
+//					later layer is placed alphabetically, as
+//					XMLConversionFactors::AddGroup() would place it.
+//					A combined group is kept from the last merge if it has
+//					the same layers and did not change; the others are built
+//					(in parallel) unless the layers are lazy.
+//
+// Input Arguments:
+//		changedGroups	= const std::set<wxString>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings for the combined groups that were built
+//
+//==========================================================================
+wxString LayeredCatalog::Merge(const std::set<wxString> &changedGroups)
+{
+	std::vector<Entry> found;
+	std::vector<unsigned int> order;// Indices in found
+	std::unordered_map<wxString, unsigned int, StringHash> lowerCaseIndex;// Into found
+	for (unsigned int layer = 0; layer < layers.size(); layer++)
+	{
+		for (unsigned int group = 0; group < layers[layer]->GroupCount(); group++)
+		{
+			const wxString &name(layers[layer]->GetGroupName(group));
+			const auto inserted(lowerCaseIndex.insert(std::make_pair(name.Lower(), found.size())));
+			if (!inserted.second)
+			{
+				found[inserted.first->second].sources.push_back(std::make_pair(layer, group));
+				continue;
+			}
+
+			if (layer == 0)
+				order.push_back(found.size());
+			else
+			{
+				order.insert(std::find_if(order.begin(), order.end(), [this, &found, &name](const unsigned int &i)
+				{
+					return name.CmpNoCase(layers[found[i].sources.front().first]->GetGroupName(
+						found[i].sources.front().second)) < 0;
+				}), found.size());
+			}
+
+			Entry entry;
+			entry.sources.push_back(std::make_pair(layer, group));
+			found.push_back(entry);
+		}
+	}
+
+	std::unordered_map<wxString, std::shared_ptr<Combined>, StringHash> previousGroups;
+	previousGroups.swap(combinedGroups);
+	for (const auto &name : changedGroups)
+		previousGroups.erase(name.Lower());
+
+	entries.clear();
+	entries.reserve(found.size());
+	entryIndex.clear();
+	entryIndex.reserve(found.size());
+	std::vector<unsigned int> built;// Indices in entries
+	for (const auto &i : order)
+	{
+		Entry &entry(found[i]);
+		if (entry.sources.size() > 1)
+		{
+			std::vector<unsigned int> sourceLayers;
+			for (const auto &source : entry.sources)
+				sourceLayers.push_back(source.first);
+
+			const wxString name(layers[entry.sources.front().first]->GetGroupName(
+				entry.sources.front().second).Lower());
+			const auto previous(previousGroups.find(name));
+			if (previous != previousGroups.end() && previous->second->layers == sourceLayers)
+				entry.combined = previous->second;
+			else
+			{
+				entry.combined = std::make_shared<Combined>();
+				entry.combined->layers = sourceLayers;
+				built.push_back(entries.size());
+			}
+			combinedGroups.insert(std::make_pair(name, entry.combined));
+		}
+
+		entries.push_back(std::move(entry));
+		entryIndex.insert(std::make_pair(GetGroupName(entries.size() - 1).Lower(), entries.size() - 1));
+
+		// The display flag may have been edited
+		if (entries.back().combined)
+			entries.back().combined->group.display = GroupIsDisplayed(entries.size() - 1);
+	}
+
+	if (layers.front()->IsLazy())
+		return wxEmptyString;
+
+	std::vector<wxString> warnings(built.size());
+	Parallel::For(built.size(), [this, &built, &warnings](const size_t &i)
+	{
+		warnings[i] = Build(entries[built[i]]);
+	});
+
+	wxString report;
+	for (const auto &warning : warnings)
+	{
+		if (!warning.IsEmpty())
+			report += (report.IsEmpty() ? wxString() : wxString(_T("\n"))) + warning;
+	}
+
+	return report;
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		Combine
+//
+// Description:		Combines the sources of a group found in several layers.
+//					Solutions are copied along with the relations, so only the
+//					combined graph is checked.
+//
+// Input Arguments:
+//		entry	= const Entry&
+//
+// Output Arguments:
+//		group	= XMLConversionFactors::FactorGroup&
+//
+// Return Value:
+//		wxString, warnings (empty if there are none)
+//
+//==========================================================================
+wxString LayeredCatalog::Combine(const Entry &entry, XMLConversionFactors::FactorGroup &group) const
+{
+	unsigned int last, displayed;
+	group.name = GetLastSource(entry, last).GetGroupName(last);
+	group.display = GetDisplaySource(entry, displayed).GroupIsDisplayed(displayed);
+
+	// Position of the relation between each pair of units (in either order)
+	std::map<std::pair<wxString, wxString>, size_t> positions;
+	for (const auto &source : entry.sources)
+	{
+		std::vector<std::pair<std::pair<wxString, wxString>, size_t> > added;
+		for (const auto &e : layers[source.first]->GetGroup(source.second).equiv)
+		{
+			const std::pair<wxString, wxString> units(e.aUnit.Cmp(e.bUnit) < 0 ?
+				std::make_pair(e.aUnit, e.bUnit) : std::make_pair(e.bUnit, e.aUnit));
+			const std::map<std::pair<wxString, wxString>, size_t>::const_iterator replaced(positions.find(units));
+			if (replaced != positions.end())
+			{
+				group.equiv[replaced->second] = e;
+				continue;
+			}
+
+			added.push_back(std::make_pair(units, group.equiv.size()));
+			group.equiv.push_back(e);
+		}
+
+		// Relations within one layer do not replace each other
+		positions.insert(added.begin(), added.end());
+	}
+
+	group.IndexUnits();
+	return XMLConversionFactors::CheckGroup(group);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GetLastSource
+//
+// Description:		Gets the last layer that has the entry's group.
+//
+// Input Arguments:
+//		entry	= const Entry&
+//
+// Output Arguments:
+//		group	= unsigned int&, index of the group in the layer
+//
+// Return Value:
+//		const XMLConversionFactors&
+//
+//==========================================================================
+const XMLConversionFactors& LayeredCatalog::GetLastSource(const Entry &entry, unsigned int &group) const
+{
+	group = entry.sources.back().second;
+	return *layers[entry.sources.back().first];
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GetDisplaySource
+//
+// Description:		Gets the last layer that sets the display flag of the
+//					entry's group, so that adding to a group in a later layer
+//					does not show a group hidden beneath it.  If no layer
+//					sets it, the last layer is used (where it defaults to
+//					shown).
+//
+// Input Arguments:
+//		entry	= const Entry&
+//
+// Output Arguments:
+//		group	= unsigned int&, index of the group in the layer
+//
+// Return Value:
+//		const XMLConversionFactors&
+//
+//==========================================================================
+const XMLConversionFactors& LayeredCatalog::GetDisplaySource(const Entry &entry, unsigned int &group) const
+{
+	for (auto source = entry.sources.rbegin(); source != entry.sources.rend(); ++source)
+	{
+		if (layers[source->first]->GroupSetsDisplay(source->second))
+		{
+			group = source->second;
+			return *layers[source->first];
+		}
+	}
+
+	return GetLastSource(entry, group);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		Build
+//
+// Description:		Combines the entry's group, unless it has already been
+//					combined.
+//
+// Input Arguments:
+//		entry	= const Entry& (with more than one source)
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings (empty if there are none, or if the group had
+//		already been combined)
+//
+//==========================================================================
+wxString LayeredCatalog::Build(const Entry &entry) const
+{
+	wxString warnings;
+	std::call_once(entry.combined->built, [this, &entry, &warnings]()
+	{
+		warnings = Combine(entry, entry.combined->group);
+	});
+
+	return warnings;
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GetGroupName
+//
+// Description:		Gets the name of the specified group.
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const wxString&
+//
+//==========================================================================
+const wxString& LayeredCatalog::GetGroupName(const unsigned int &i) const
+{
+	unsigned int group;
+	const XMLConversionFactors &layer(GetLastSource(entries[i], group));
+	return layer.GetGroupName(group);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GroupIsDisplayed
+//
+// Description:		Checks whether the specified group is displayed (as set
+//					by the last layer that sets it).
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool LayeredCatalog::GroupIsDisplayed(const unsigned int &i) const
+{
+	unsigned int group;
+	const XMLConversionFactors &layer(GetDisplaySource(entries[i], group));
+	return layer.GroupIsDisplayed(group);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GetGroup
+//
+// Description:		Returns the specified group:  the combined copy (built
+//					if necessary), or the group in its only layer (read there
+//					if necessary).
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const XMLConversionFactors::FactorGroup&
+//
+//==========================================================================
+const XMLConversionFactors::FactorGroup& LayeredCatalog::GetGroup(const unsigned int &i) const
+{
+	if (entries[i].combined)
+	{
+		const wxString warnings(Build(entries[i]));
+		if (!warnings.IsEmpty())
+			MessageReporter::Warning(_T("Warning combining catalogs:  ") + warnings + _T("."));
+		return entries[i].combined->group;
+	}
+
+	unsigned int group;
+	const XMLConversionFactors &layer(GetLastSource(entries[i], group));
+	return layer.GetGroup(group);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		GetGroup
+//
+// Description:		Gets the group by name.
+//
+// Input Arguments:
+//		name	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const XMLConversionFactors::FactorGroup&
+//
+//==========================================================================
+const XMLConversionFactors::FactorGroup& LayeredCatalog::GetGroup(const wxString &name) const
+{
+	const int i(FindGroup(name));
+	if (i == wxNOT_FOUND)
+		throw std::runtime_error("Group not found");
+
+	return GetGroup(i);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		FindGroup
+//
+// Description:		Finds the index of the group with the specified name
+//					(without regard to case, as groups are merged).
+//
+// Input Arguments:
+//		name	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, index of the group or wxNOT_FOUND
+//
+//==========================================================================
+int LayeredCatalog::FindGroup(const wxString &name) const
+{
+	std::unordered_map<wxString, unsigned int, StringHash>::const_iterator it(entryIndex.find(name.Lower()));
+	if (it == entryIndex.end())
+		return wxNOT_FOUND;
+
+	return static_cast<int>(it->second);
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		AddGroup
+//
+// Description:		Adds an empty group to the last layer.
+//
+// Input Arguments:
+//		name	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void LayeredCatalog::AddGroup(const wxString &name)
+{
+	if (FindGroup(name) != wxNOT_FOUND)
+		throw std::runtime_error(std::string((_T("Group '") + name + _T("' already exists")).mb_str()));
+
+	layers.back()->AddGroup(name);
+	Merge();
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		AddEquivalences
+//
+// Description:		Adds (or changes) equivalences in the last layer.  A
+//					relation between units related in an earlier layer is
+//					added to the last layer, where it takes precedence.
+//					Groups are named as the catalog already names them, so
+//					that the last layer does not add a group that differs
+//					only in case.
+//
+// Input Arguments:
+//		equivalences	= const std::vector<std::pair<wxString, XMLConversionFactors::Equivalence> >&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings for the changed groups
+//
+//==========================================================================
+wxString LayeredCatalog::AddEquivalences(const std::vector<std::pair<wxString,
+	XMLConversionFactors::Equivalence> > &equivalences)
+{
+	std::vector<std::pair<wxString, XMLConversionFactors::Equivalence> > named(equivalences);
+	std::set<wxString> changedGroups;
+	for (auto &equivalence : named)
+	{
+		const int i(FindGroup(equivalence.first));
+		if (i != wxNOT_FOUND)
+			equivalence.first = GetGroupName(i);
+		changedGroups.insert(equivalence.first);
+	}
+
+	wxString warnings(layers.back()->AddEquivalences(named));
+
+	const wxString combined(Merge(changedGroups));
+	if (!combined.IsEmpty())
+		warnings += (warnings.IsEmpty() ? wxString() : wxString(_T("\n"))) + combined;
+
+	// In lazy mode, the changed groups are combined now so that their
+	// warnings are returned too
+	for (const auto &name : changedGroups)
+	{
+		const int i(FindGroup(name));
+		const wxString groupWarnings(i == wxNOT_FOUND || !entries[i].combined ? wxString() : Build(entries[i]));
+		if (!groupWarnings.IsEmpty())
+			warnings += (warnings.IsEmpty() ? wxString() : wxString(_T("\n"))) + groupWarnings;
+	}
+
+	return warnings;
+}
+
+//==========================================================================
+// Class:			LayeredCatalog
+// Function:		SetGroupVisibility
+//
+// Description:		Shows or hides a group.  Nothing is added to the last
+//					layer if the group is already shown (or hidden).
+//
+// Input Arguments:
+//		name	= const wxString&
+//		visible	= const bool&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void LayeredCatalog::SetGroupVisibility(const wxString &name, const bool &visible)
+{
+	const int i(FindGroup(name));
+	if (i == wxNOT_FOUND)
+		throw std::runtime_error(std::string((_T("Could not find group '") + name + _T("'")).mb_str()));
+
+	if (GroupIsDisplayed(i) == visible)
+		return;
+
+	// As the layers name it, which may differ in case
+	const wxString groupName(GetGroupName(i));
+	XMLConversionFactors &lastLayer(*layers.back());
+	if (entries[i].sources.back().first != layers.size() - 1)
+		lastLayer.AddGroup(groupName);
+
+	lastLayer.SetGroupVisibility(groupName, visible);
+	Merge();
+}
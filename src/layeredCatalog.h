@@ -0,0 +1,109 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  layeredCatalog.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Combines several catalogs (e.g. system, site and user) into one,
+//				 with each catalog taking precedence over those before it.
+// History:
+
+#ifndef _LAYERED_CATALOG_H_
+#define _LAYERED_CATALOG_H_
+
+// Standard C++ headers
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Local headers
+#include "xmlConversionFactors.h"
+#include "stringHash.h"
+
+class LayeredCatalog
+{
+public:
+	// The first file is the base catalog and the rest are overlays, each
+	// taking precedence over the files before it.  Only the last file is
+	// edited; the others are only read.
+	LayeredCatalog(const std::vector<wxString> &fileNames, const bool &lazy = false);
+
+	// The catalogs shared by all users:  the catalog installed with the
+	// application (conversions.xml in the working directory, or if there is
+	// none, conversions.jsonl or conversions.ccol) and the site-wide catalog
+	// named by the environment variable (if it is set)
+	static std::vector<wxString> GetSharedFileNames();
+	static const wxString siteCatalogVariable;
+
+	// Loads and merges every layer; fails if any layer fails
+	bool Load();
+	void Save();
+
+	// Rebuilds the merged index; must be called after a layer is loaded or
+	// swapped by other means, with the names of the groups that changed.  A
+	// group found in one layer is used from that layer.  A group found in
+	// several layers (names are compared without regard to case) is combined
+	// into a copy:  the name comes from the last layer, the display flag
+	// from the last layer that sets it, and a relation between two units
+	// replaces any relation between the same units in earlier layers.
+	// Combined groups are kept from the last merge unless they changed.  In
+	// lazy mode, they are only built when first used (and their warnings
+	// reported then); otherwise, returns the warnings for those built.
+	wxString Merge(const std::set<wxString> &changedGroups = std::set<wxString>());
+
+	unsigned int LayerCount() const { return layers.size(); };
+	XMLConversionFactors& GetLayer(const unsigned int &i) { return *layers[i]; };
+
+	// As for XMLConversionFactors, over the merged groups
+	unsigned int GroupCount() const { return entries.size(); };
+	const wxString& GetGroupName(const unsigned int &i) const;
+	bool GroupIsDisplayed(const unsigned int &i) const;
+	const XMLConversionFactors::FactorGroup& GetGroup(const unsigned int &i) const;
+	const XMLConversionFactors::FactorGroup& GetGroup(const wxString &name) const;// Throws if not found
+	int FindGroup(const wxString &name) const;// Ignoring case; wxNOT_FOUND if not found
+
+	// Edits are made to the last layer (which is given the group first, if
+	// it is only in earlier layers) and merged.  These throw as for
+	// XMLConversionFactors; AddGroup() also throws if any layer has the group.
+	void AddGroup(const wxString &name);
+	wxString AddEquivalences(const std::vector<std::pair<wxString, XMLConversionFactors::Equivalence> > &equivalences);
+	void SetGroupVisibility(const wxString &name, const bool &visible);
+
+private:
+	std::vector<std::unique_ptr<XMLConversionFactors> > layers;
+
+	struct Combined
+	{
+		std::vector<unsigned int> layers;// Of the sources
+		std::once_flag built;
+		XMLConversionFactors::FactorGroup group;
+	};
+
+	struct Entry
+	{
+		std::vector<std::pair<unsigned int, unsigned int> > sources;// Layer and group, earliest layer first
+		std::shared_ptr<Combined> combined;// NULL if there is one source
+	};
+
+	std::vector<Entry> entries;
+	std::unordered_map<wxString, unsigned int, StringHash> entryIndex;// By name in lower case
+	std::unordered_map<wxString, std::shared_ptr<Combined>, StringHash> combinedGroups;// By name in lower case
+
+	const XMLConversionFactors& GetLastSource(const Entry &entry, unsigned int &group) const;
+	const XMLConversionFactors& GetDisplaySource(const Entry &entry, unsigned int &group) const;
+	wxString Build(const Entry &entry) const;
+	wxString Combine(const Entry &entry, XMLConversionFactors::FactorGroup &group) const;
+};
+
+#endif// _LAYERED_CATALOG_H_
@@ -13,18 +13,25 @@
 // History:
 
 // Standard C++ headers
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 // wxWidgets headers
 #include <wx/notebook.h>
 #include <wx/clipbrd.h>
 #include <wx/fileconf.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
 
 // Local headers
 #include "mainFrame.h"
 #include "converterApp.h"
 #include "convertMath.h"
+#include "numberFormatter.h"
+#include "numberParser.h"
 #include "optionsDialog.h"
+#include "catalogImport.h"
 
 // *nix Icons
 #ifdef __WXGTK__
@@ -54,15 +61,51 @@
 //==========================================================================
 MainFrame::MainFrame() : wxFrame(NULL, wxID_ANY, wxEmptyString, wxDefaultPosition,
 								 wxDefaultSize, wxDEFAULT_FRAME_STYLE),
-								 xml(_T("conversions.xml")), converter(xml),
-								 configFileName(_T("converterConfig.rc"))
+								 catalog(GetCatalogFileNames()), converter(catalog),
+								 configFileName(_T("converterConfig.rc")),
+								 significantDigits(0), minimumSignificantDigits(3)
 {
 	CreateControls();
 	SetProperties();
 
-	// Error messages handled by xml object
-	if (xml.Load())
+	// Error messages handled by the catalog
+	if (catalog.Load())
 		EnforcePageConfiguration(false);
+
+	for (unsigned int i = 0; i < catalog.LayerCount(); i++)
+	{
+		watchers.push_back(std::make_unique<CatalogWatcher>(catalog.GetLayer(i),
+			[this](const std::set<wxString> &groups)
+		{
+			OnCatalogReloaded(groups);
+		}));
+	}
+}
+
+//==========================================================================
+// Class:			MainFrame
+// Function:		GetCatalogFileNames
+//
+// Description:		Lists the catalog layers:  the shared catalogs (see
+//					LayeredCatalog::GetSharedFileNames()) and the user's own
+//					catalog, which holds the user's edits.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::vector<wxString>, lowest precedence first
+//
+//==========================================================================
+std::vector<wxString> MainFrame::GetCatalogFileNames()
+{
+	std::vector<wxString> fileNames(LayeredCatalog::GetSharedFileNames());
+	fileNames.push_back(wxFileName(wxStandardPaths::Get().GetUserDataDir(), _T("conversions.xml")).GetFullPath());
+
+	return fileNames;
 }
 
 //==========================================================================
@@ -87,6 +130,7 @@ BEGIN_EVENT_TABLE(MainFrame, wxFrame)
 	EVT_LISTBOX(wxID_ANY,				MainFrame::OnSelectionChangeEvent)
 	EVT_BUTTON(idClipboard,				MainFrame::OnClipboardButton)
 	EVT_BUTTON(idOptions,				MainFrame::OnOptionsButton)
+	EVT_BUTTON(idImport,				MainFrame::OnImportButton)
 	EVT_BUTTON(idSwap,					MainFrame::OnSwapButton)
 	EVT_CLOSE(							MainFrame::OnClose)
 	EVT_SIZE(							MainFrame::OnSize)
@@ -136,7 +180,10 @@ void MainFrame::CreateControls()
 	inUnits = new wxStaticText(mainPanel, wxID_ANY, wxEmptyString);
 	lowerSizer->Add(input, wxSizerFlags().Expand());
 	lowerSizer->Add(inUnits, wxSizerFlags().Align(wxALIGN_CENTER_VERTICAL).Proportion(0));
-	lowerSizer->Add(new wxButton(mainPanel, idOptions, _T("Options")), wxSizerFlags().Expand());
+	wxSizer *catalogButtonSizer = new wxBoxSizer(wxHORIZONTAL);
+	catalogButtonSizer->Add(new wxButton(mainPanel, idOptions, _T("Options")), wxSizerFlags().Expand());
+	catalogButtonSizer->Add(new wxButton(mainPanel, idImport, _T("Import")), wxSizerFlags().Expand());
+	lowerSizer->Add(catalogButtonSizer, wxSizerFlags().Expand());
 
 	lowerSizer->Add(new wxStaticText(mainPanel, wxID_ANY, _T("Output:")), wxSizerFlags().Align(wxALIGN_CENTER_VERTICAL));
 	output = new wxTextCtrl(mainPanel, wxID_ANY, _T("1"), wxDefaultPosition, wxSize(textBoxWidth, -1), wxTE_READONLY);
@@ -207,8 +254,12 @@ void MainFrame::EnforcePageConfiguration(const bool &saveConfig)
 		SaveConfiguration();
 	notebook->DeleteAllPages();
 
-	for (unsigned int i = 0; i < xml.GroupCount(); i++)
-		AddNotebookPage(xml.GetGroup(i));
+	// Hidden groups do not need to be read
+	for (unsigned int i = 0; i < catalog.GroupCount(); i++)
+	{
+		if (catalog.GroupIsDisplayed(i))
+			AddNotebookPage(catalog.GetGroup(i));
+	}
 
 	// This hack makes the notebook's multiple tabs proper (not sure why it's needed)
 	SetSize(GetSize() + wxSize(1, 0));
@@ -299,15 +350,97 @@ void MainFrame::OnTabChangeEvent(wxNotebookEvent& WXUNUSED(event))
 //==========================================================================
 void MainFrame::OnOptionsButton(wxCommandEvent& WXUNUSED(event))
 {
-	OptionsDialog dialog(this, xml);
+	for (auto &watcher : watchers)
+		watcher->Pause();
+
+	OptionsDialog dialog(this, catalog);
+	if (dialog.ShowModal() == wxID_OK && catalog.Load())
+	{
+		converter.ClearCache();
+		EnforcePageConfiguration();
+	}
+
+	for (auto &watcher : watchers)
+		watcher->Resume();
+}
+
+//==========================================================================
+// Class:			MainFrame
+// Function:		OnImportButton
+//
+// Description:		Handles import button click events.  The imported rows
+//					are applied to the loaded catalog, so it is not reloaded.
+//
+// Input Arguments:
+//		event	= wxCommandEvent&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MainFrame::OnImportButton(wxCommandEvent& WXUNUSED(event))
+{
+	wxFileDialog dialog(this, _T("Import Conversions"), wxEmptyString, wxEmptyString,
+		_T("Comma or tab separated files (*.csv;*.tsv;*.txt)|*.csv;*.tsv;*.txt|All files (*.*)|*.*"),
+		wxFD_OPEN | wxFD_FILE_MUST_EXIST);
 	if (dialog.ShowModal() != wxID_OK)
 		return;
 
-	if (xml.Load())
+	for (auto &watcher : watchers)
+		watcher->Pause();
+
+	wxString warnings;
+	const wxString error(CatalogImport::Import(catalog, dialog.GetPath(), warnings));
+	if (!error.IsEmpty())
+		wxMessageBox(error, _T("Error"), wxICON_ERROR, this);
+	else
 	{
+		catalog.Save();
+		if (!warnings.IsEmpty())
+			wxMessageBox(warnings, _T("Warning"), wxICON_WARNING, this);
+
 		converter.ClearCache();
 		EnforcePageConfiguration();
 	}
+
+	for (auto &watcher : watchers)
+		watcher->Resume();
+}
+
+//==========================================================================
+// Class:			MainFrame
+// Function:		OnCatalogReloaded
+//
+// Description:		Updates the display after the catalog was changed outside
+//					the application (and reloaded by the watcher).  The layers
+//					are merged again (combining only the changed groups
+//					again), and only the cached conversions of the changed
+//					groups are discarded.
+//
+// Input Arguments:
+//		groups	= const std::set<wxString>&, names of the changed groups
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MainFrame::OnCatalogReloaded(const std::set<wxString> &groups)
+{
+	const wxString warnings(catalog.Merge(groups));
+	if (!warnings.IsEmpty())
+		wxMessageBox(_T("Warning combining catalogs:  ") + warnings + _T("."), _T("Warning"), wxICON_WARNING, this);
+
+	if (groups.empty())
+		return;
+
+	converter.ClearCache(groups);
+	EnforcePageConfiguration();
 }
 
 //==========================================================================
@@ -469,24 +602,28 @@ void MainFrame::UpdateConversion()
 	outUnit = box->GetString(box->GetSelection());
 
 	double inValue;
-	if (!input->GetValue().ToDouble(&inValue))
+	if (!NumberParser::Parse(input->GetValue(), inValue))
 		return;
 
 	inUnits->SetLabel(inUnit);
 	outUnits->SetLabel(outUnit);
 
 	double outValue = converter.Convert(groupName, inUnit, outUnit, inValue);
-	int orderOfMagnitude(static_cast<int>(floor(log10(outValue))));
 
-	if (orderOfMagnitude < -3 ||// Value is very small
-		orderOfMagnitude > 6)// Value is very large
-		output->ChangeValue(wxString::Format(_T("%e"), outValue));
-		/*output->ChangeValue(wxString::Format(_T("%0.*e"),
-		ConvertMath::CountSignificantDigits(input->GetValue()) - 1, outValue));*/// FIXME:  Fix precision
+	// The output carries the precision of the input unless overridden
+	unsigned int digits(significantDigits);
+	if (digits == 0)
+		digits = std::max(ConvertMath::CountSignificantDigits(input->GetValue()),
+			minimumSignificantDigits);
+
+	const double magnitude(fabs(outValue));
+	if (magnitude != 0.0 && (magnitude < 1.0e-3 ||// Value is very small
+		magnitude >= 1.0e7))// Value is very large
+		output->ChangeValue(NumberFormatter::FormatSignificant(outValue, digits,
+			NumberFormatter::Style::Scientific));
 	else
-		output->ChangeValue(wxString::Format(_T("%f"), outValue));
-		/*output->ChangeValue(wxString::Format(_T("%0.*f"),
-		std::max<int>(0, ConvertMath::CountSignificantDigits(input->GetValue()) - orderOfMagnitude - 1), outValue));*/
+		output->ChangeValue(NumberFormatter::FormatSignificant(outValue, digits,
+			NumberFormatter::Style::Fixed));
 }
 
 //==========================================================================
@@ -586,7 +723,7 @@ void MainFrame::AddNotebookPage(const XMLConversionFactors::FactorGroup &group)
 	if (!group.display)
 		return;
 
-	wxArrayString unitList = group.GetUnitList();
+	const wxArrayString &unitList(group.GetUnitList());
 
 	wxPanel *panel = new wxPanel(notebook);
 	wxSizer *mainSizer = new wxBoxSizer(wxHORIZONTAL);
@@ -659,6 +796,12 @@ void MainFrame::LoadConfiguration()
 
 	input->ChangeValue(config->Read(_T("/Other/InputValue"), _T("1")));
 
+	long digits;
+	if (config->Read(_T("/Other/SignificantDigits"), &digits) && digits >= 0)
+		significantDigits = digits;
+	if (config->Read(_T("/Other/MinimumSignificantDigits"), &digits) && digits >= 0)
+		minimumSignificantDigits = digits;
+
 	delete config;
 }
 
@@ -710,6 +853,8 @@ void MainFrame::SaveConfiguration()
 	config->Write(_T("/Window/YPosition"), GetPosition().y);
 
 	config->Write(_T("/Other/InputValue"), input->GetValue());
+	config->Write(_T("/Other/SignificantDigits"), static_cast<long>(significantDigits));
+	config->Write(_T("/Other/MinimumSignificantDigits"), static_cast<long>(minimumSignificantDigits));
 
 	delete config;
 
@@ -15,12 +15,17 @@
 #ifndef _MAIN_FRAME_H_
 #define _MAIN_FRAME_H_
 
+// Standard C++ headers
+#include <memory>
+#include <vector>
+
 // wxWidgets headers
 #include <wx/wx.h>
 
 // Local headers
-#include "xmlConversionFactors.h"
+#include "layeredCatalog.h"
 #include "converter.h"
+#include "catalogWatcher.h"
 
 // wxWidgets forward declarations
 class wxNotebook;
@@ -55,13 +60,16 @@ private:
 		idOutput,
 		idOptions,
 		idClipboard,
-		idSwap
+		idSwap,
+		idImport
 	};
 
 	void OnTextChangeEvent(wxCommandEvent& event);
 	void OnSelectionChangeEvent(wxCommandEvent& event);
 	void OnTabChangeEvent(wxNotebookEvent& event);
 	void OnOptionsButton(wxCommandEvent& event);
+	void OnImportButton(wxCommandEvent& event);
+	void OnCatalogReloaded(const std::set<wxString> &groups);
 	void OnClipboardButton(wxCommandEvent& event);
 	void OnSwapButton(wxCommandEvent& event);
 	void OnClose(wxCloseEvent& event);
@@ -69,13 +77,20 @@ private:
 
 	void UpdateConversion();
 
-	XMLConversionFactors xml;
+	LayeredCatalog catalog;
 	Converter converter;
+	std::vector<std::unique_ptr<CatalogWatcher> > watchers;// One for each layer
+	static std::vector<wxString> GetCatalogFileNames();
 
 	const wxString configFileName;
 	void LoadConfiguration();
 	void SaveConfiguration();
 
+	// Output precision; zero means count the digits of the input (but never
+	// show fewer than minimumSignificantDigits)
+	unsigned int significantDigits;
+	unsigned int minimumSignificantDigits;
+
 	DECLARE_EVENT_TABLE();
 };
 
@@ -0,0 +1,233 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  mappedFile.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Memory mapping of a file (read-only unless requested).
+// History:
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Platform headers
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Local headers
+#include "mappedFile.h"
+
+//==========================================================================
+// Class:			MappedFile
+// Function:		~MappedFile
+//
+// Description:		Destructor for MappedFile class.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+//==========================================================================
+// Class:			MappedFile
+// Function:		Open
+//
+// Description:		Maps the entire file.  Empty files are opened
+//					successfully with no data.
+//
+// Input Arguments:
+//		fileName	= const wxString&
+//		writable	= const bool&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool MappedFile::Open(const wxString &fileName, const bool &writable)
+{
+	Close();
+
+#ifdef __WXMSW__
+	file = CreateFileW(fileName.wc_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+		FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		Close();
+		return false;
+	}
+
+	size = static_cast<size_t>(fileSize.QuadPart);
+	if (size > 0)
+	{
+		mapping = CreateFileMappingW(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+		if (!mapping)
+		{
+			Close();
+			return false;
+		}
+
+		data = static_cast<const char*>(MapViewOfFile(mapping,
+			writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+		if (!data)
+		{
+			Close();
+			return false;
+		}
+	}
+#else
+	descriptor = ::open(fileName.fn_str(), writable ? O_RDWR : O_RDONLY);
+	if (descriptor < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(descriptor, &status) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	size = static_cast<size_t>(status.st_size);
+	if (size > 0)
+	{
+		void *address(mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+			MAP_SHARED, descriptor, 0));
+		if (address == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		data = static_cast<const char*>(address);
+	}
+#endif
+
+	this->writable = writable;
+	open = true;
+	return true;
+}
+
+//==========================================================================
+// Class:			MappedFile
+// Function:		Flush
+//
+// Description:		Writes the changes made through a writable mapping to
+//					disk and waits for them to finish.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool MappedFile::Flush()
+{
+	if (!writable || !data)
+		return true;
+
+#ifdef __WXMSW__
+	return FlushViewOfFile(data, 0) && FlushFileBuffers(file);
+#else
+	return msync(const_cast<char*>(data), size, MS_SYNC) == 0;
+#endif
+}
+
+//==========================================================================
+// Class:			MappedFile
+// Function:		AdviseSequential
+//
+// Description:		Asks the system to read ahead and to drop pages that have
+//					been passed (where supported).
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MappedFile::AdviseSequential()
+{
+#ifndef __WXMSW__
+	if (data)
+		madvise(const_cast<char*>(data), size, MADV_SEQUENTIAL);
+#endif
+}
+
+//==========================================================================
+// Class:			MappedFile
+// Function:		Close
+//
+// Description:		Unmaps and closes the file.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MappedFile::Close()
+{
+#ifdef __WXMSW__
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file)
+		CloseHandle(file);
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (data)
+		munmap(const_cast<char*>(data), size);
+	if (descriptor >= 0)
+		::close(descriptor);
+	descriptor = -1;
+#endif
+
+	data = nullptr;
+	size = 0;
+	writable = false;
+	open = false;
+}
@@ -0,0 +1,62 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  mappedFile.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Memory mapping of a file (read-only unless requested).
+// History:
+
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+// Standard C++ headers
+#include <cstddef>
+
+// wxWidgets forward declarations
+class wxString;
+
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Changes made through a writable mapping are written to the file
+	bool Open(const wxString &fileName, const bool &writable = false);
+	void Close();
+
+	// Writes changes to disk now, rather than as the system chooses
+	bool Flush();
+
+	// Hints that the data will be read in order, once
+	void AdviseSequential();
+
+	bool IsOpen() const { return open; };
+	const char* GetData() const { return data; };
+	char* GetWritableData() const { return writable ? const_cast<char*>(data) : nullptr; };
+	size_t GetSize() const { return size; };
+
+private:
+	bool open = false;
+	bool writable = false;
+	const char *data = nullptr;
+	size_t size = 0;
+
+#ifdef __WXMSW__
+	void *file = nullptr;
+	void *mapping = nullptr;
+#else
+	int descriptor = -1;
+#endif
+};
+
+#endif// _MAPPED_FILE_H_
@@ -0,0 +1,151 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  messageReporter.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Reports errors and warnings from the conversion engine, so that
+//				 the engine does not depend on the GUI.
+// History:
+
+// Standard C++ headers
+#include <iostream>
+#include <mutex>
+
+// Local headers
+#include "messageReporter.h"
+
+//==========================================================================
+// Class:			None
+// Function:		GetHandler
+//
+// Description:		Returns the handler (created on first use, so that it can
+//					be set before main() runs) and the lock protecting it.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		mutex	= std::recursive_mutex*&
+//
+// Return Value:
+//		MessageReporter::Handler&
+//
+//==========================================================================
+static MessageReporter::Handler& GetHandler(std::recursive_mutex *&mutex)
+{
+	static std::recursive_mutex handlerMutex;
+	static MessageReporter::Handler handler;
+	mutex = &handlerMutex;
+	return handler;
+}
+
+//==========================================================================
+// Class:			MessageReporter
+// Function:		SetHandler
+//
+// Description:		Sets the function to which messages are passed.
+//
+// Input Arguments:
+//		handler	= const Handler&, empty to write to stderr
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MessageReporter::SetHandler(const Handler &handler)
+{
+	std::recursive_mutex *mutex;
+	Handler &current(GetHandler(mutex));
+	std::lock_guard<std::recursive_mutex> lock(*mutex);
+	current = handler;
+}
+
+//==========================================================================
+// Class:			MessageReporter
+// Function:		Error
+//
+// Description:		Reports an error.
+//
+// Input Arguments:
+//		message	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MessageReporter::Error(const wxString &message)
+{
+	Report(severityError, message);
+}
+
+//==========================================================================
+// Class:			MessageReporter
+// Function:		Warning
+//
+// Description:		Reports a warning.
+//
+// Input Arguments:
+//		message	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MessageReporter::Warning(const wxString &message)
+{
+	Report(severityWarning, message);
+}
+
+//==========================================================================
+// Class:			MessageReporter
+// Function:		Report
+//
+// Description:		Passes the message to the handler, or writes it to stderr.
+//					The handler is copied under the lock and called after it
+//					is released, so a handler that waits (on a message box,
+//					for example) does not block other threads' messages.
+//
+// Input Arguments:
+//		severity	= const Severity&
+//		message		= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void MessageReporter::Report(const Severity &severity, const wxString &message)
+{
+	std::recursive_mutex *mutex;
+	const Handler &current(GetHandler(mutex));
+	Handler handler;
+	{
+		std::lock_guard<std::recursive_mutex> lock(*mutex);
+		handler = current;
+		if (!handler)
+		{
+			std::cerr << (severity == severityError ? "Error:  " : "Warning:  ")
+				<< message.utf8_str() << std::endl;
+			return;
+		}
+	}
+
+	handler(severity, message);
+}
@@ -0,0 +1,48 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  messageReporter.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Reports errors and warnings from the conversion engine, so that
+//				 the engine does not depend on the GUI.
+// History:
+
+#ifndef _MESSAGE_REPORTER_H_
+#define _MESSAGE_REPORTER_H_
+
+// Standard C++ headers
+#include <functional>
+
+// wxWidgets headers
+#include <wx/string.h>
+
+class MessageReporter
+{
+public:
+	enum Severity
+	{
+		severityError,
+		severityWarning
+	};
+
+	typedef std::function<void(const Severity&, const wxString&)> Handler;
+
+	// Messages are written to stderr until a handler is set (the GUI shows
+	// them in message boxes).  The handler is called without a lock held, so
+	// it may be called from several threads at once.
+	static void SetHandler(const Handler &handler);
+
+	static void Error(const wxString &message);
+	static void Warning(const wxString &message);
+
+private:
+	static void Report(const Severity &severity, const wxString &message);
+};
+
+#endif// _MESSAGE_REPORTER_H_
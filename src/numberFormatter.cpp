@@ -0,0 +1,688 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  numberFormatter.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Locale-independent conversion of double to decimal text.
+// History:
+
+// Standard C++ headers
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Local headers
+#include "numberFormatter.h"
+#include "numberParser.h"
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		Constant Definitions
+//
+// Description:		Constants for the NumberFormatter namespace.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static const size_t maxScientificLength(32);// Sign, 17 digits, point and five-character exponent with room to spare
+static const size_t maxFixedLength(350);// Sign, "0.", 323 zeros and 17 digits for the smallest subnormal
+static const size_t maxFixedIntegerLength(312);// Sign, 309 digits, point and terminating null
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		WriteNonFinite
+//
+// Description:		Writes infinity or NaN.
+//
+// Input Arguments:
+//		first	= char*
+//		last	= char*
+//		value	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		char*, one past the last character written, or NULL
+//
+//==========================================================================
+static char* WriteNonFinite(char *first, char *last, const double &value)
+{
+	const char *text;
+	if (std::isnan(value))
+		text = "nan";
+	else if (value < 0.0)
+		text = "-inf";
+	else
+		text = "inf";
+
+	for (; *text; text++)
+	{
+		if (first == last)
+			return NULL;
+		*first++ = *text;
+	}
+
+	return first;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		Decompose
+//
+// Description:		Splits a positive, finite value into decimal digits and a
+//					power of ten, such that value = d.ddd x 10^exponent.
+//
+// Input Arguments:
+//		value				= const double&
+//		significantDigits	= const int&, or shortestRoundTrip
+//
+// Output Arguments:
+//		digits		= char* (at least maxSignificantDigits long, not terminated)
+//		digitCount	= int&
+//		exponent	= int&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static void Decompose(const double &value, const int &significantDigits,
+	char *digits, int &digitCount, int &exponent)
+{
+	char buffer[64];
+	const char *end;
+
+#ifdef __cpp_lib_to_chars
+	if (significantDigits < 0)
+		end = std::to_chars(buffer, buffer + sizeof(buffer), value,
+			std::chars_format::scientific).ptr;
+	else
+		end = std::to_chars(buffer, buffer + sizeof(buffer), value,
+			std::chars_format::scientific, significantDigits - 1).ptr;
+#else
+	int length(0);
+	if (significantDigits < 0)
+	{
+		// Fifteen digits always identify a normal double when one exists that
+		// short; otherwise add digits until the text reads back exactly
+		double check;
+		for (int precision = value < DBL_MIN ? 1 : 15; precision <= NumberFormatter::maxSignificantDigits; precision++)
+		{
+			length = snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+			if (NumberParser::Parse(buffer, buffer + length, check, end) && check == value)
+				break;
+		}
+	}
+	else
+		length = snprintf(buffer, sizeof(buffer), "%.*e", significantDigits - 1, value);
+	end = buffer + length;
+#endif
+
+	const char *p(buffer);
+	digitCount = 0;
+	for (; p != end && *p != 'e'; p++)
+	{
+		if (*p != '.')
+			digits[digitCount++] = *p;
+	}
+
+	// The buffer is not terminated, so atoi() cannot be used here
+	bool negativeExponent(false);
+	exponent = 0;
+	for (p++; p != end; p++)
+	{
+		if (*p == '-')
+			negativeExponent = true;
+		else if (*p != '+')
+			exponent = exponent * 10 + *p - '0';
+	}
+
+	if (negativeExponent)
+		exponent = -exponent;
+
+	if (significantDigits < 0)
+	{
+		while (digitCount > 1 && digits[digitCount - 1] == '0')
+			digitCount--;
+	}
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		PositionalLength
+//
+// Description:		Returns the number of characters WritePositional will use.
+//
+// Input Arguments:
+//		digitCount	= const int&
+//		exponent	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		size_t
+//
+//==========================================================================
+static size_t PositionalLength(const int &digitCount, const int &exponent)
+{
+	if (exponent < 0)
+		return 2 - exponent - 1 + digitCount;
+
+	const int integerDigits(exponent + 1);
+	if (digitCount > integerDigits)
+		return digitCount + 1;
+
+	return integerDigits;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		WritePositional
+//
+// Description:		Writes d.ddd x 10^exponent without an exponent, padding
+//					with zeros as necessary.  Space must already be checked.
+//
+// Input Arguments:
+//		p			= char*
+//		digits		= const char*
+//		digitCount	= const int&
+//		exponent	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		char*, one past the last character written
+//
+//==========================================================================
+static char* WritePositional(char *p, const char *digits, const int &digitCount, const int &exponent)
+{
+	int i;
+	if (exponent < 0)
+	{
+		*p++ = '0';
+		*p++ = '.';
+		for (i = exponent + 1; i < 0; i++)
+			*p++ = '0';
+		for (i = 0; i < digitCount; i++)
+			*p++ = digits[i];
+		return p;
+	}
+
+	for (i = 0; i <= exponent; i++)
+		*p++ = i < digitCount ? digits[i] : '0';
+
+	if (digitCount > exponent + 1)
+	{
+		*p++ = '.';
+		for (; i < digitCount; i++)
+			*p++ = digits[i];
+	}
+
+	return p;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		ExponentLength
+//
+// Description:		Returns the number of characters WriteExponent will use.
+//
+// Input Arguments:
+//		exponent	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		size_t
+//
+//==========================================================================
+static size_t ExponentLength(const int &exponent)
+{
+	if (exponent >= 100 || exponent <= -100)
+		return 5;
+	return 4;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		WriteExponent
+//
+// Description:		Writes the exponent in printf style (e+05, e-123).  Space
+//					must already be checked.
+//
+// Input Arguments:
+//		p			= char*
+//		exponent	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		char*, one past the last character written
+//
+//==========================================================================
+static char* WriteExponent(char *p, const int &exponent)
+{
+	*p++ = 'e';
+	*p++ = exponent < 0 ? '-' : '+';
+
+	const int magnitude(std::abs(exponent));
+	if (magnitude >= 100)
+		*p++ = static_cast<char>('0' + magnitude / 100);
+	*p++ = static_cast<char>('0' + magnitude / 10 % 10);
+	*p++ = static_cast<char>('0' + magnitude % 10);
+
+	return p;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		ClampSignificantDigits
+//
+// Description:		Limits a significant digit request to what a double can
+//					represent (at least one, at most maxSignificantDigits).
+//					shortestRoundTrip is passed through.
+//
+// Input Arguments:
+//		significantDigits	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int
+//
+//==========================================================================
+static int ClampSignificantDigits(const int &significantDigits)
+{
+	if (significantDigits < 0)
+		return NumberFormatter::shortestRoundTrip;
+	else if (significantDigits == 0)
+		return 1;
+	else if (significantDigits > NumberFormatter::maxSignificantDigits)
+		return NumberFormatter::maxSignificantDigits;
+
+	return significantDigits;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		WriteDigits
+//
+// Description:		Writes a finite value by decomposing it into decimal
+//					digits and placing the decimal point and exponent for the
+//					requested style.  For Style::Fixed, significantDigits
+//					determines the digits written before zero padding.
+//
+// Input Arguments:
+//		first				= char*
+//		last				= char*
+//		value				= const double&
+//		style				= const NumberFormatter::Style&
+//		significantDigits	= const int&, or shortestRoundTrip
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		char*, one past the last character written, or NULL if the range is
+//		too small
+//
+//==========================================================================
+static char* WriteDigits(char *first, char *last, const double &value,
+	const NumberFormatter::Style &style, const int &significantDigits)
+{
+	using NumberFormatter::Style;
+
+	char *p(first);
+	if (std::signbit(value))
+	{
+		if (p == last)
+			return NULL;
+		*p++ = '-';
+	}
+
+	char digits[NumberFormatter::maxSignificantDigits];
+	int digitCount, exponent;
+	Decompose(std::fabs(value), significantDigits, digits, digitCount, exponent);
+
+	// Position of the decimal point (relative to the first digit) and
+	// the exponent to write after the digits
+	int pointPosition(0), writtenExponent(exponent);
+	bool writeExponent(true);
+	if (style == Style::Fixed)
+		writeExponent = false;
+	else if (style == Style::Engineering)
+	{
+		pointPosition = exponent % 3;
+		if (pointPosition < 0)
+			pointPosition += 3;
+		writtenExponent = exponent - pointPosition;
+	}
+	else if (style == Style::Shortest)
+		writeExponent = PositionalLength(digitCount, exponent) >
+			PositionalLength(digitCount, 0) + ExponentLength(exponent);
+
+	if (!writeExponent)
+		pointPosition = exponent;
+
+	size_t length(PositionalLength(digitCount, pointPosition));
+	if (writeExponent)
+		length += ExponentLength(writtenExponent);
+
+	if (static_cast<size_t>(last - p) < length)
+		return NULL;
+
+	p = WritePositional(p, digits, digitCount, pointPosition);
+	if (writeExponent)
+		p = WriteExponent(p, writtenExponent);
+
+	return p;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		MaxLength
+//
+// Description:		Returns a buffer size that is large enough for any value
+//					in the specified style.
+//
+// Input Arguments:
+//		style		= const Style&
+//		precision	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		size_t
+//
+//==========================================================================
+size_t NumberFormatter::MaxLength(const Style &style, const int &precision)
+{
+	if (style != Style::Fixed)
+		return maxScientificLength;
+	else if (precision < 0)
+		return maxFixedLength;
+
+	return maxFixedIntegerLength + precision;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		Format
+//
+// Description:		Writes the value to the specified range.  Shortest
+//					round-trip text is generated by std::to_chars (Ryu in the
+//					standard libraries that provide floating point to_chars)
+//					where available.  Engineering notation and significant
+//					digit requests are assembled from the decimal digits.
+//
+// Input Arguments:
+//		first		= char*
+//		last		= char*
+//		value		= const double&
+//		style		= const Style&
+//		precision	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		char*, one past the last character written, or NULL if the range is
+//		too small
+//
+//==========================================================================
+char* NumberFormatter::Format(char *first, char *last, const double &value,
+	const Style &style, const int &precision)
+{
+	if (!std::isfinite(value))
+		return WriteNonFinite(first, last, value);
+
+#ifdef __cpp_lib_to_chars
+	if (style == Style::Fixed || (precision < 0 && style != Style::Engineering))
+	{
+		std::to_chars_result result;
+		if (style == Style::Fixed && precision >= 0)
+			result = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+		else if (style == Style::Fixed)
+			result = std::to_chars(first, last, value, std::chars_format::fixed);
+		else if (style == Style::Scientific)
+			result = std::to_chars(first, last, value, std::chars_format::scientific);
+		else
+			result = std::to_chars(first, last, value);
+
+		if (result.ec != std::errc())
+			return NULL;
+		return result.ptr;
+	}
+#else
+	if (style == Style::Fixed && precision >= 0)
+	{
+		// snprintf() needs room for the terminating null
+		const int length(snprintf(first, last - first, "%.*f", precision, value));
+		if (length < 0 || length >= last - first)
+			return NULL;
+		return first + length;
+	}
+#endif
+
+	if (style == Style::Fixed)
+		return WriteDigits(first, last, value, style, shortestRoundTrip);
+
+	return WriteDigits(first, last, value, style, ClampSignificantDigits(precision));
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		Format
+//
+// Description:		Returns the value as a string.
+//
+// Input Arguments:
+//		value		= const double&
+//		style		= const Style&
+//		precision	= const int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString
+//
+//==========================================================================
+wxString NumberFormatter::Format(const double &value, const Style &style, const int &precision)
+{
+	std::string buffer(MaxLength(style, precision), '\0');
+	char *first(&buffer[0]);
+	const char *end(Format(first, first + buffer.size(), value, style, precision));
+	if (!end)
+		return wxEmptyString;
+
+	return wxString(first, end - first);
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		Format
+//
+// Description:		Writes many values into one buffer, each followed by the
+//					separator.  Callers typically flush the buffer and call
+//					again with the remaining values when not all of them fit.
+//
+// Input Arguments:
+//		values		= const double*
+//		count		= const size_t&
+//		buffer		= char*
+//		size		= const size_t&
+//		separator	= const char&
+//		style		= const Style&
+//		precision	= const int&
+//
+// Output Arguments:
+//		used		= size_t&, number of characters written
+//
+// Return Value:
+//		size_t, number of values written
+//
+//==========================================================================
+size_t NumberFormatter::Format(const double *values, const size_t &count, char *buffer,
+	const size_t &size, const char &separator, size_t &used,
+	const Style &style, const int &precision)
+{
+	char *p(buffer);
+	char *last(buffer + size);
+	size_t i;
+	for (i = 0; i < count; i++)
+	{
+		char *end(Format(p, last, values[i], style, precision));
+		if (!end || end == last)
+			break;
+
+		*end = separator;
+		p = end + 1;
+	}
+
+	used = p - buffer;
+	return i;
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		FormatSignificant
+//
+// Description:		Writes the value rounded to the specified number of
+//					significant digits.  Unlike Format, this also applies to
+//					Style::Fixed (1234 to two digits is 1200, 0.012345 is
+//					0.012).
+//
+// Input Arguments:
+//		first				= char*
+//		last				= char*
+//		value				= const double&
+//		significantDigits	= const unsigned int&
+//		style				= const Style&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		char*, one past the last character written, or NULL if the range is
+//		too small
+//
+//==========================================================================
+char* NumberFormatter::FormatSignificant(char *first, char *last, const double &value,
+	const unsigned int &significantDigits, const Style &style)
+{
+	if (!std::isfinite(value))
+		return WriteNonFinite(first, last, value);
+
+	if (significantDigits > static_cast<unsigned int>(maxSignificantDigits))
+		return WriteDigits(first, last, value, style, maxSignificantDigits);
+
+	return WriteDigits(first, last, value, style, ClampSignificantDigits(significantDigits));
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		FormatSignificant
+//
+// Description:		Returns the value rounded to the specified number of
+//					significant digits as a string.
+//
+// Input Arguments:
+//		value				= const double&
+//		significantDigits	= const unsigned int&
+//		style				= const Style&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString
+//
+//==========================================================================
+wxString NumberFormatter::FormatSignificant(const double &value,
+	const unsigned int &significantDigits, const Style &style)
+{
+	char buffer[maxFixedLength];
+	const char *end(FormatSignificant(buffer, buffer + maxFixedLength,
+		value, significantDigits, style));
+	if (!end)
+		return wxEmptyString;
+
+	return wxString(buffer, end - buffer);
+}
+
+//==========================================================================
+// Namespace:		NumberFormatter
+// Function:		FormatSignificant
+//
+// Description:		Writes many values into one buffer, each rounded to its
+//					own number of significant digits (typically counted from
+//					the text it was converted from) and followed by the
+//					separator.
+//
+// Input Arguments:
+//		values				= const double*
+//		significantDigits	= const unsigned int*, one entry per value
+//		count				= const size_t&
+//		buffer				= char*
+//		size				= const size_t&
+//		separator			= const char&
+//		style				= const Style&
+//
+// Output Arguments:
+//		used		= size_t&, number of characters written
+//
+// Return Value:
+//		size_t, number of values written
+//
+//==========================================================================
+size_t NumberFormatter::FormatSignificant(const double *values,
+	const unsigned int *significantDigits, const size_t &count, char *buffer,
+	const size_t &size, const char &separator, size_t &used, const Style &style)
+{
+	char *p(buffer);
+	char *last(buffer + size);
+	size_t i;
+	for (i = 0; i < count; i++)
+	{
+		char *end(FormatSignificant(p, last, values[i], significantDigits[i], style));
+		if (!end || end == last)
+			break;
+
+		*end = separator;
+		p = end + 1;
+	}
+
+	used = p - buffer;
+	return i;
+}
@@ -0,0 +1,73 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  numberFormatter.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Locale-independent conversion of double to decimal text.
+// History:
+
+#ifndef _NUMBER_FORMATTER_H_
+#define _NUMBER_FORMATTER_H_
+
+// Standard C++ headers
+#include <cstddef>
+
+// wxWidgets forward declarations
+class wxString;
+
+namespace NumberFormatter
+{
+	enum class Style
+	{
+		Shortest,// Fixed or scientific, whichever is fewer characters
+		Fixed,// 1234.5
+		Scientific,// 1.2345e+03
+		Engineering// 1.2345e+03 (exponent is always a multiple of three)
+	};
+
+	// Precision is the number of digits after the decimal point for Style::Fixed
+	// and the number of significant digits (at most maxSignificantDigits) for
+	// the other styles.  With shortestRoundTrip, the fewest digits that read
+	// back as exactly the same double are written.
+	static const int shortestRoundTrip(-1);
+	static const int maxSignificantDigits(17);
+
+	// Size of a buffer that is always large enough for one value
+	size_t MaxLength(const Style &style, const int &precision = shortestRoundTrip);
+
+	// Writes the value to [first, last) without a terminating null; returns
+	// one past the last character written, or NULL if the range is too small
+	char* Format(char *first, char *last, const double &value,
+		const Style &style = Style::Shortest, const int &precision = shortestRoundTrip);
+
+	wxString Format(const double &value,
+		const Style &style = Style::Shortest, const int &precision = shortestRoundTrip);
+
+	// Writes values to the buffer, each followed by separator, stopping at the
+	// first value that does not fit.  Returns the number of values written;
+	// used is the number of characters written.
+	size_t Format(const double *values, const size_t &count, char *buffer,
+		const size_t &size, const char &separator, size_t &used,
+		const Style &style = Style::Shortest, const int &precision = shortestRoundTrip);
+
+	// As above, but the digits are always counted as significant figures (so
+	// the precision of an input can be carried through to the output)
+	char* FormatSignificant(char *first, char *last, const double &value,
+		const unsigned int &significantDigits, const Style &style = Style::Shortest);
+
+	wxString FormatSignificant(const double &value,
+		const unsigned int &significantDigits, const Style &style = Style::Shortest);
+
+	// One significant digit count per value
+	size_t FormatSignificant(const double *values, const unsigned int *significantDigits,
+		const size_t &count, char *buffer, const size_t &size, const char &separator,
+		size_t &used, const Style &style = Style::Shortest);
+}
+
+#endif// _NUMBER_FORMATTER_H_
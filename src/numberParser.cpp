@@ -0,0 +1,292 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  numberParser.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Locale-independent conversion of decimal text to double.
+// History:
+
+// Standard C++ headers
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#ifndef __cpp_lib_to_chars
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+#endif
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+// Local headers
+#include "numberParser.h"
+
+//==========================================================================
+// Namespace:		NumberParser
+// Function:		Constant Definitions
+//
+// Description:		Constants for the NumberParser namespace.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static const int maxMantissaDigits(19);// Any 19-digit decimal fits in uint64_t
+static const uint64_t maxExactMantissa(uint64_t(1) << 53);
+static const int maxExactPower(22);// Largest power of ten represented exactly by a double
+static const double exactPowersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+	1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+//==========================================================================
+// Namespace:		NumberParser
+// Function:		IsDigit
+//
+// Description:		Locale-independent test for a decimal digit.
+//
+// Input Arguments:
+//		c	= const char&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+static inline bool IsDigit(const char &c)
+{
+	return c >= '0' && c <= '9';
+}
+
+//==========================================================================
+// Namespace:		NumberParser
+// Function:		ParseSlow
+//
+// Description:		Correctly rounded conversion for the cases the fast path
+//					cannot handle exactly (more than 19 significant digits,
+//					large exponents, etc.).  Uses std::from_chars where the
+//					standard library provides it for floating point, otherwise
+//					strtod in the "C" locale.
+//
+// Input Arguments:
+//		first		= const char* (just past the sign)
+//		last		= const char* (end of the validated number)
+//		overflow	= const bool&, result to use if out of range (infinity or zero)
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+static double ParseSlow(const char *first, const char *last, const bool &overflow)
+{
+	double value(0.0);
+#ifdef __cpp_lib_to_chars
+	if (std::from_chars(first, last, value).ec == std::errc::result_out_of_range)
+		value = overflow ? HUGE_VAL : 0.0;
+#else
+	// strtod() requires termination
+	const std::string text(first, last);
+#ifdef _MSC_VER
+	static const _locale_t cLocale(_create_locale(LC_NUMERIC, "C"));
+	value = _strtod_l(text.c_str(), NULL, cLocale);
+#else
+	static const locale_t cLocale(newlocale(LC_NUMERIC_MASK, "C", (locale_t)0));
+	value = strtod_l(text.c_str(), NULL, cLocale);
+#endif
+	(void)overflow;// strtod() handles this itself
+#endif
+	return value;
+}
+
+//==========================================================================
+// Namespace:		NumberParser
+// Function:		Parse
+//
+// Description:		Parses a decimal number from the specified range.  Digits
+//					are accumulated into a 64-bit integer, and when both the
+//					integer and the power of ten are exactly representable the
+//					result is a single correctly-rounded multiply or divide
+//					(Clinger's fast path).  This covers nearly all input; the
+//					rest is passed to ParseSlow.
+//
+// Input Arguments:
+//		first	= const char*
+//		last	= const char*
+//
+// Output Arguments:
+//		value	= double&
+//		end		= const char*&, first character following the number
+//
+// Return Value:
+//		bool, true if a number was found at first
+//
+//==========================================================================
+bool NumberParser::Parse(const char *first, const char *last, double &value, const char *&end)
+{
+	const char *p(first);
+	bool negative(false);
+	if (p != last && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+	const char *digitsStart(p);
+
+	uint64_t mantissa(0);
+	int digitCount(0), exponent(0);
+	bool foundDigit(false), truncated(false), afterPoint(false);
+	for (; p != last; p++)
+	{
+		if (*p == '.' && !afterPoint)
+		{
+			afterPoint = true;
+			continue;
+		}
+		else if (!IsDigit(*p))
+			break;
+
+		foundDigit = true;
+		const unsigned int digit(*p - '0');
+		if (mantissa == 0 && digit == 0)
+		{
+			if (afterPoint)
+				exponent--;
+		}
+		else if (digitCount < maxMantissaDigits)
+		{
+			mantissa = mantissa * 10 + digit;
+			digitCount++;
+			if (afterPoint)
+				exponent--;
+		}
+		else
+		{
+			truncated = truncated || digit != 0;
+			if (!afterPoint)
+				exponent++;
+		}
+	}
+
+	if (!foundDigit)
+		return false;
+
+	if (p != last && (*p == 'e' || *p == 'E'))
+	{
+		const char *q(p + 1);
+		bool negativeExponent(false);
+		if (q != last && (*q == '-' || *q == '+'))
+		{
+			negativeExponent = *q == '-';
+			q++;
+		}
+
+		// An 'e' without digits is not part of the number
+		if (q != last && IsDigit(*q))
+		{
+			int exponentValue(0);
+			for (; q != last && IsDigit(*q); q++)
+			{
+				if (exponentValue < 100000)
+					exponentValue = exponentValue * 10 + (*q - '0');
+			}
+
+			exponent += negativeExponent ? -exponentValue : exponentValue;
+			p = q;
+		}
+	}
+
+	end = p;
+	if (mantissa == 0)
+		value = 0.0;
+	else if (!truncated && mantissa <= maxExactMantissa &&
+		exponent >= -maxExactPower && exponent <= maxExactPower)
+	{
+		if (exponent < 0)
+			value = static_cast<double>(mantissa) / exactPowersOfTen[-exponent];
+		else
+			value = static_cast<double>(mantissa) * exactPowersOfTen[exponent];
+	}
+	else
+	{
+		// Short mantissas with large exponents can sometimes absorb part of the power exactly
+		bool exact(false);
+		if (!truncated && exponent > maxExactPower && exponent <= maxExactPower + 15)
+		{
+			uint64_t scaled(mantissa);
+			for (int i = maxExactPower; i < exponent && scaled <= maxExactMantissa; i++)
+				scaled *= 10;
+
+			if (scaled <= maxExactMantissa)
+			{
+				value = static_cast<double>(scaled) * exactPowersOfTen[maxExactPower];
+				exact = true;
+			}
+		}
+
+		if (!exact)
+			value = ParseSlow(digitsStart, p, exponent + digitCount > 0);
+	}
+
+	if (negative)
+		value = -value;
+
+	return true;
+}
+
+//==========================================================================
+// Namespace:		NumberParser
+// Function:		Parse
+//
+// Description:		Parses a string that must contain exactly one number
+//					(optionally surrounded by whitespace).
+//
+// Input Arguments:
+//		s		= const wxString&
+//
+// Output Arguments:
+//		value	= double&
+//
+// Return Value:
+//		bool, true for success
+//
+//==========================================================================
+bool NumberParser::Parse(const wxString &s, double &value)
+{
+	wxString trimmed(s);
+	trimmed.Trim().Trim(false);
+
+	const std::string text(trimmed.mb_str());
+	const char *last(text.data() + text.size());
+	const char *end;
+	double parsed;
+	if (!Parse(text.data(), last, parsed, end) || end != last)
+		return false;
+
+	value = parsed;
+	return true;
+}
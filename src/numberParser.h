@@ -0,0 +1,31 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  numberParser.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Locale-independent conversion of decimal text to double.
+// History:
+
+#ifndef _NUMBER_PARSER_H_
+#define _NUMBER_PARSER_H_
+
+// wxWidgets forward declarations
+class wxString;
+
+namespace NumberParser
+{
+	// Parses [+-]digits[.digits][(e|E)[+-]digits] starting at first (no leading
+	// whitespace).  Always uses '.' as the decimal point and rounds correctly.
+	bool Parse(const char *first, const char *last, double &value, const char *&end);
+
+	// The entire string (ignoring surrounding whitespace) must be a number
+	bool Parse(const wxString &s, double &value);
+}
+
+#endif// _NUMBER_PARSER_H_
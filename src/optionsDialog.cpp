@@ -19,6 +19,8 @@
 // Local headers
 #include "optionsDialog.h"
 #include "converterApp.h"
+#include "numberFormatter.h"
+#include "numberParser.h"
 
 #ifdef __WXMSW__
 #pragma warning(disable:4428)// Compiler bug erroneously flags strings containing unicode characters
@@ -32,7 +34,7 @@
 //
 // Input Arguments:
 //		parent	= wxWindow*
-//		xml		= XMLConversionFactors&
+//		catalog	= LayeredCatalog&
 //
 // Output Arguments:
 //		None
@@ -41,8 +43,8 @@
 //		None
 //
 //==========================================================================
-OptionsDialog::OptionsDialog(wxWindow *parent, XMLConversionFactors &xml)
-	: wxDialog(parent, wxID_ANY, _T("Options")), xml(xml)
+OptionsDialog::OptionsDialog(wxWindow *parent, LayeredCatalog &catalog)
+	: wxDialog(parent, wxID_ANY, _T("Options")), catalog(catalog)
 {
 	CreateControls();
 	CenterOnParent();
@@ -140,7 +142,9 @@ void OptionsDialog::CreateControls()
 // Function:		TransferDataFromWindow
 //
 // Description:		Determines if the data on the control is acceptable and
-//					updates the xml object as required.
+//					updates the catalog as required.  Changes to units from
+//					earlier layers are added to the last layer, where they
+//					take precedence.
 //
 // Input Arguments:
 //		None
@@ -175,19 +179,17 @@ bool OptionsDialog::TransferDataFromWindow()
 		}
 	}
 
-	for (size_t i = 0; i < newGroups.size(); i++)
-		xml.AddGroup(newGroups[i]);
-
 	try
 	{
-		for (size_t i = 0; i < newUnits.size(); i++)
-			xml.AddEquivalence(newUnits[i].first, newUnits[i].second);
+		for (size_t i = 0; i < newGroups.size(); i++)
+			catalog.AddGroup(newGroups[i]);
 
-		for (size_t i = 0; i < changedUnits.size(); i++)
-			xml.ChangeEquivalence(changedUnits[i].first, changedUnits[i].second);
+		std::vector<std::pair<wxString, XMLConversionFactors::Equivalence> > equivalences(newUnits);
+		equivalences.insert(equivalences.end(), changedUnits.begin(), changedUnits.end());
+		catalog.AddEquivalences(equivalences);// Warnings are reported when the catalog is reloaded
 
 		for (size_t i = 0; i < groupList->GetCount(); i++)
-			xml.SetGroupVisibility(groupList->GetString(i), groupList->IsChecked(i));
+			catalog.SetGroupVisibility(groupList->GetString(i), groupList->IsChecked(i));
 	}
 	catch (std::exception &e)
 	{
@@ -197,7 +199,7 @@ bool OptionsDialog::TransferDataFromWindow()
 		return false;
 	}
 
-	xml.Save();
+	catalog.Save();
 
 	return true;
 }
@@ -226,7 +228,7 @@ void OptionsDialog::OnNewGroup(wxCommandEvent& event)
 
 	for (size_t i = 0; i < groupList->GetCount(); i++)
 	{
-		if (groupName.Cmp(groupList->GetString(i)) == 0)
+		if (groupName.CmpNoCase(groupList->GetString(i)) == 0)
 		{
 			wxMessageBox(_T("Group '") + groupName + _T("' already exists!"), _T("Error"), wxICON_ERROR, this);
 			return;
@@ -421,22 +423,22 @@ XMLConversionFactors::Equivalence OptionsDialog::GetUnitInfo(const wxString &gro
 			return changedUnits[i].second;
 	}
 
-	for (size_t i = 0; i < xml.GroupCount(); i++)
+	const int i(catalog.FindGroup(groupName));
+	if (i != wxNOT_FOUND)
 	{
-		if (xml.GetGroup(i).name.Cmp(groupName) == 0)
+		const XMLConversionFactors::FactorGroup &group(catalog.GetGroup(i));
+
+		// Check all A units first
+		for (size_t j = 0; j < group.equiv.size(); j++)
 		{
-			// Check all A units first
-			for (size_t j = 0; j < xml.GetGroup(i).equiv.size(); j++)
-			{
-				if (xml.GetGroup(i).equiv[j].aUnit.Cmp(unitName) == 0)
-					return xml.GetGroup(i).equiv[j];
-			}
+			if (group.equiv[j].aUnit.Cmp(unitName) == 0)
+				return group.equiv[j];
+		}
 
-			for (size_t j = 0; j < xml.GetGroup(i).equiv.size(); j++)
-			{
-				if (xml.GetGroup(i).equiv[j].bUnit.Cmp(unitName) == 0)
-					return xml.GetGroup(i).equiv[j];
-			}
+		for (size_t j = 0; j < group.equiv.size(); j++)
+		{
+			if (group.equiv[j].bUnit.Cmp(unitName) == 0)
+				return group.equiv[j];
 		}
 	}
 
@@ -478,10 +480,10 @@ XMLConversionFactors::Equivalence OptionsDialog::GetUnitInfo(const wxString &gro
 //==========================================================================
 void OptionsDialog::AddGroupsToControl()
 {
-	for (unsigned int i = 0; i < xml.GroupCount(); i++)
+	for (unsigned int i = 0; i < catalog.GroupCount(); i++)
 	{
-		groupList->Append(xml.GetGroup(i).name);
-		groupList->Check(i, xml.GetGroup(i).display);
+		groupList->Append(catalog.GetGroupName(i));
+		groupList->Check(i, catalog.GroupIsDisplayed(i));
 	}
 }
 
@@ -542,7 +544,7 @@ wxArrayString OptionsDialog::GetCompleteUnitList(const wxString &groupName) cons
 	wxArrayString units;
 	if (!isNewGroup)
 	{
-		XMLConversionFactors::FactorGroup group = xml.GetGroup(groupName);// TODO:  catch exceptions
+		const XMLConversionFactors::FactorGroup &group = catalog.GetGroup(groupName);// TODO:  catch exceptions
 		units = group.GetUnitList();
 	}
 
@@ -582,14 +584,9 @@ wxArrayString OptionsDialog::GetNewUnits(const wxString &groupName) const
 	}
 
 	wxArrayString oldUnits;
-	for (unsigned int i = 0; i < xml.GroupCount(); i++)
-	{
-		if (xml.GetGroup(i).name.Cmp(groupName) == 0)
-		{
-			oldUnits = xml.GetGroup(i).GetUnitList();
-			break;
-		}
-	}
+	const int groupIndex(catalog.FindGroup(groupName));
+	if (groupIndex != wxNOT_FOUND)
+		oldUnits = catalog.GetGroup(groupIndex).GetUnitList();
 
 	newUnitList.Sort();
 	for (size_t i = 1; i < newUnitList.Count(); i++)
@@ -966,13 +963,13 @@ wxString OptionsDialog::AddUnitDialog::MultiplyTerms(const std::vector<wxString>
 	double v, result(1.0);
 	for (size_t i = 0; i < terms.size(); i++)
 	{
-		if (!terms[i].ToDouble(&v))
+		if (!NumberParser::Parse(terms[i], v))
 			throw errorHasErrors;
 
 		result *= v;
 	}
 
-	return wxString::Format(_T("%f"), result);
+	return NumberFormatter::Format(result);
 }
 
 //==========================================================================
@@ -1316,7 +1313,8 @@ bool OptionsDialog::AddUnitDialog::TransferDataFromWindow()
 	}
 
 	double factor;
-	if (!aQtyText->GetValue().ToDouble(&factor) || !bQtyText->GetValue().ToDouble(&factor))
+	if (!NumberParser::Parse(aQtyText->GetValue(), factor) ||
+		!NumberParser::Parse(bQtyText->GetValue(), factor))
 	{
 		wxMessageBox(_T("Could not convert conversion factor to value!"), _T("Error"), wxICON_ERROR, this);
 		return false;
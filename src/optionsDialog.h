@@ -22,7 +22,7 @@
 #include <wx/wx.h>
 
 // Local headers
-#include "xmlConversionFactors.h"
+#include "layeredCatalog.h"
 
 // wxWidgets forward declarations
 class wxNotebook;
@@ -30,10 +30,10 @@ class wxNotebook;
 class OptionsDialog : public wxDialog
 {
 public:
-	OptionsDialog(wxWindow *parent, XMLConversionFactors &xml);
+	OptionsDialog(wxWindow *parent, LayeredCatalog &catalog);
 
 private:
-	XMLConversionFactors &xml;
+	LayeredCatalog &catalog;
 	void CreateControls();
 
 	wxCheckListBox *groupList;
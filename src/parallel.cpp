@@ -0,0 +1,80 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  parallel.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Runs independent work items on a pool of threads.
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Local headers
+#include "parallel.h"
+
+//==========================================================================
+// Namespace:		Parallel
+// Function:		ThreadCount
+//
+// Description:		Returns the number of threads used by For().
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		unsigned int
+//
+//==========================================================================
+unsigned int Parallel::ThreadCount()
+{
+	return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+//==========================================================================
+// Namespace:		Parallel
+// Function:		For
+//
+// Description:		Calls work(i) for each i in [0, count), in parallel.
+//
+// Input Arguments:
+//		count	= const size_t&
+//		work	= const std::function<void(const size_t&)>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void Parallel::For(const size_t &count, const std::function<void(const size_t&)> &work)
+{
+	std::atomic<size_t> next(0);
+	auto worker([&next, &count, &work]()
+	{
+		size_t i;
+		while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count)
+			work(i);
+	});
+
+	const size_t threadCount(std::min<size_t>(ThreadCount(), count));
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; i++)
+		threads.emplace_back(worker);
+
+	worker();
+	for (auto &thread : threads)
+		thread.join();
+}
@@ -0,0 +1,33 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  parallel.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Runs independent work items on a pool of threads.
+// History:
+
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+// Standard C++ headers
+#include <cstddef>
+#include <functional>
+
+namespace Parallel
+{
+	// Number of threads used by For() (at least one)
+	unsigned int ThreadCount();
+
+	// Calls work(i) for each i in [0, count).  Items are handed out one at a
+	// time, so uneven items balance across the threads; the calling thread
+	// takes part.  Work must not throw.
+	void For(const size_t &count, const std::function<void(const size_t&)> &work);
+}
+
+#endif// _PARALLEL_H_
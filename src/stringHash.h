@@ -0,0 +1,48 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  stringHash.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Hash function for using wxString as a key in unordered containers
+//				 (std::hash<wxString> is not available in all wxWidgets versions).
+// History:
+
+#ifndef _STRING_HASH_H_
+#define _STRING_HASH_H_
+
+// Standard C++ headers
+#include <cstddef>
+#include <cstdint>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+struct StringHash
+{
+	static const uint64_t offsetBasis = 0xCBF29CE484222325ULL;
+
+	// 64-bit FNV-1a over the characters in the string's internal
+	// representation (no conversion or allocation); pass the result of a
+	// previous call as the basis to combine several strings
+	static uint64_t Hash(const wxString &s, uint64_t basis = offsetBasis)
+	{
+		uint64_t hash(basis);
+		for (auto c = s.wx_str(); *c; c++)
+		{
+			hash ^= static_cast<uint64_t>(*c);
+			hash *= 0x100000001B3ULL;
+		}
+
+		return hash;
+	}
+
+	size_t operator()(const wxString &s) const { return static_cast<size_t>(Hash(s)); };
+};
+
+#endif// _STRING_HASH_H_
@@ -0,0 +1,476 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  vectorMath.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Array forms of the math functions available to relations, written
+//				 without data-dependent branches so they vectorize.
+// History:
+
+// Standard C++ headers
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+// Local headers
+#include "vectorMath.h"
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Constant Definitions
+//
+// Description:		Constants for the VectorMath kernels.  The log coefficients
+//					and the split of ln(2) are from fdlibm (Sun Microsystems).
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static const double ln2Hi(6.93147180369123816490e-01);
+static const double ln2Lo(1.90821492927058770002e-10);
+static const double log2e(1.44269504088896338700e+00);
+static const double log10e(4.34294481903251827651e-01);
+static const double log10eTail(1.09831965021676510e-17);// log10(e) - log10e
+static const double sqrt2(1.41421356237309514547e+00);
+static const double shifter(6755399441055744.0);// 1.5 * 2^52, rounds to integer when added
+static const double two52(4503599627370496.0);
+static const double two53(9007199254740992.0);
+static const double two54(18014398509481984.0);
+static const double splitter(134217729.0);// 2^27 + 1
+static const double minNormal(2.2250738585072014e-308);
+static const double expOverflow(709.782712893383973096);
+static const double expUnderflow(-745.133219101941108420);
+
+static const double lg1(6.666666666666735130e-01);
+static const double lg2(3.999999999940941908e-01);
+static const double lg3(2.857142874366239149e-01);
+static const double lg4(2.222219843214978396e-01);
+static const double lg5(1.818357216161805012e-01);
+static const double lg6(1.531383769920937332e-01);
+static const double lg7(1.479819860511658591e-01);
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		ToBits
+//
+// Description:		Reinterprets a double as its IEEE-754 bit pattern.
+//
+// Input Arguments:
+//		value	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		uint64_t
+//
+//==========================================================================
+static inline uint64_t ToBits(const double &value)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		FromBits
+//
+// Description:		Reinterprets an IEEE-754 bit pattern as a double.
+//
+// Input Arguments:
+//		bits	= const uint64_t&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+static inline double FromBits(const uint64_t &bits)
+{
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Power2
+//
+// Description:		Returns 2^n for integer-valued n in the normal exponent range.
+//					Integer work is limited to 64-bit add and shift so that the
+//					callers vectorize with SSE2.
+//
+// Input Arguments:
+//		n	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+static inline double Power2(const double &n)
+{
+	return FromBits((ToBits(n + (1023.0 + shifter)) - ToBits(shifter)) << 52);
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		ExpKernel
+//
+// Description:		Computes e^x for one lane.  The argument is reduced to
+//					x = k * ln(2) + r with |r| <= ln(2) / 2, e^r is evaluated
+//					with a Taylor polynomial and the result is scaled by 2^k
+//					(in two steps so that subnormal and near-overflow results
+//					are handled without branches).
+//
+// Input Arguments:
+//		x	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+static inline double ExpKernel(const double &x)
+{
+	double clamped(x > expOverflow ? expOverflow : x);
+	clamped = clamped < expUnderflow ? expUnderflow : clamped;
+	clamped = x == x ? clamped : 0.0;
+
+	const double kd((clamped * log2e + shifter) - shifter);
+
+	const double r((clamped - kd * ln2Hi) - kd * ln2Lo);
+	const double p(1.0 + r * (1.0 + r * (1.0 / 2.0 + r * (1.0 / 6.0 + r * (1.0 / 24.0
+		+ r * (1.0 / 120.0 + r * (1.0 / 720.0 + r * (1.0 / 5040.0 + r * (1.0 / 40320.0
+		+ r * (1.0 / 362880.0 + r * (1.0 / 3628800.0 + r * (1.0 / 39916800.0
+		+ r * (1.0 / 479001600.0 + r * (1.0 / 6227020800.0))))))))))))));
+
+	const double k1((kd * 0.5 + shifter) - shifter);
+	double y(p * Power2(k1) * Power2(kd - k1));
+
+	y = x > expOverflow ? HUGE_VAL : y;
+	y = x < expUnderflow ? 0.0 : y;
+	return x == x ? y : x;
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Split
+//
+// Description:		Splits a double into two halves that can be multiplied
+//					exactly (Veltkamp/Dekker).
+//
+// Input Arguments:
+//		a	= const double&
+//
+// Output Arguments:
+//		hi	= double&
+//		lo	= double&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static inline void Split(const double &a, double &hi, double &lo)
+{
+	const double c(splitter * a);
+	hi = c - (c - a);
+	lo = a - hi;
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		TwoSum
+//
+// Description:		Computes a + b and the exact rounding error of the sum (Knuth).
+//
+// Input Arguments:
+//		a	= const double&
+//		b	= const double&
+//
+// Output Arguments:
+//		sum		= double&
+//		error	= double&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static inline void TwoSum(const double &a, const double &b, double &sum, double &error)
+{
+	sum = a + b;
+	const double bVirtual(sum - a);
+	error = (a - (sum - bVirtual)) + (b - bVirtual);
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		LogKernel
+//
+// Description:		Computes ln(x) for one lane of positive, finite x, as an
+//					unevaluated sum hi + lo carrying roughly 70 bits.  Writes
+//					x = 2^k * m with sqrt(2) / 2 <= m < sqrt(2) and evaluates
+//					ln(m) with the fdlibm rational approximation.
+//
+// Input Arguments:
+//		x	= const double&
+//
+// Output Arguments:
+//		hi	= double&
+//		lo	= double&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+static inline void LogKernel(const double &x, double &hi, double &lo)
+{
+	const bool subnormal(x < minNormal);
+	const uint64_t bits(ToBits(subnormal ? x * two54 : x));
+	double kd(FromBits(((bits >> 52) & 0x7ff) + ToBits(shifter)) - shifter - 1023.0);
+	kd -= subnormal ? 54.0 : 0.0;
+	double m(FromBits((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL));
+
+	const bool large(m > sqrt2);
+	m = large ? 0.5 * m : m;
+	kd += large ? 1.0 : 0.0;
+
+	const double f(m - 1.0);
+	const double s(f / (2.0 + f));
+	const double z(s * s);
+	const double r(z * (lg1 + z * (lg2 + z * (lg3 + z * (lg4 + z * (lg5 + z * (lg6 + z * lg7)))))));
+	double fHi, fLo;
+	Split(f, fHi, fLo);
+	const double halfSquare(0.5 * f * f);
+	const double halfSquareLo(0.5 * (((fHi * fHi - 2.0 * halfSquare) + 2.0 * fHi * fLo) + fLo * fLo));
+	const double t(s * (halfSquare + r));
+
+	// ln(m) = f - halfSquare + t, with the rounding errors carried in logMLo
+	double logM, logMLo;
+	TwoSum(f, -halfSquare, logM, logMLo);
+	logMLo += t - halfSquareLo;
+
+	double sum, error;
+	TwoSum(kd * ln2Hi, logM, sum, error);
+	error += logMLo + kd * ln2Lo;
+
+	hi = sum + error;
+	lo = error - (hi - sum);
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		LogSpecialCases
+//
+// Description:		Applies IEEE results for non-positive, infinite and NaN
+//					arguments to a log result.
+//
+// Input Arguments:
+//		x	= const double&
+//		y	= const double&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		double
+//
+//==========================================================================
+static inline double LogSpecialCases(const double &x, const double &y)
+{
+	double result(x < 0.0 ? NAN : y);
+	result = x == 0.0 ? -HUGE_VAL : result;
+	result = x == HUGE_VAL ? x : result;
+	return x == x ? result : x;
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Sqrt
+//
+// Description:		Computes the square root of each element.  Relies on the
+//					hardware instruction (requires -fno-math-errno with gcc to
+//					vectorize).
+//
+// Input Arguments:
+//		x		= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		y		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void VectorMath::Sqrt(const double *x, double *y, const size_t &count)
+{
+	for (size_t i = 0; i < count; i++)
+		y[i] = sqrt(x[i]);
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Exp
+//
+// Description:		Computes e^x for each element (within 1 ulp).
+//
+// Input Arguments:
+//		x		= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		y		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void VectorMath::Exp(const double *x, double *y, const size_t &count)
+{
+	for (size_t i = 0; i < count; i++)
+		y[i] = ExpKernel(x[i]);
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Log
+//
+// Description:		Computes the natural logarithm of each element (within 1 ulp).
+//
+// Input Arguments:
+//		x		= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		y		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void VectorMath::Log(const double *x, double *y, const size_t &count)
+{
+	double hi, lo;
+	for (size_t i = 0; i < count; i++)
+	{
+		LogKernel(x[i], hi, lo);
+		y[i] = LogSpecialCases(x[i], hi + lo);
+	}
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Log10
+//
+// Description:		Computes the base-10 logarithm of each element.
+//
+// Input Arguments:
+//		x		= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		y		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void VectorMath::Log10(const double *x, double *y, const size_t &count)
+{
+	double hi, lo, hiHi, hiLo, log10eHi, log10eLo;
+	Split(log10e, log10eHi, log10eLo);
+	for (size_t i = 0; i < count; i++)
+	{
+		LogKernel(x[i], hi, lo);
+		const double product(hi * log10e);
+		Split(hi, hiHi, hiLo);
+		const double productLo(((hiHi * log10eHi - product) + hiHi * log10eLo + hiLo * log10eHi)
+			+ hiLo * log10eLo + hi * log10eTail + lo * log10e);
+		y[i] = LogSpecialCases(x[i], product + productLo);
+	}
+}
+
+//==========================================================================
+// Namespace:		VectorMath
+// Function:		Pow
+//
+// Description:		Computes x^y for each pair of elements as e^(y * ln|x|),
+//					carrying the extra precision of the log through the
+//					product so the result is accurate to a few ulp for
+//					exponents of moderate magnitude.  Signs, zeros, infinities
+//					and NaN follow the C library pow().
+//
+// Input Arguments:
+//		x		= const double*
+//		y		= const double*
+//		count	= const size_t&
+//
+// Output Arguments:
+//		z		= double*
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void VectorMath::Pow(const double *x, const double *y, double *z, const size_t &count)
+{
+	double hi, lo, yHi, yLo, hiHi, hiLo;
+	for (size_t i = 0; i < count; i++)
+	{
+		const double ax(fabs(x[i]));
+		const double ay(fabs(y[i]));
+		LogKernel(ax, hi, lo);
+
+		const double p(y[i] * hi);
+		Split(y[i], yHi, yLo);
+		Split(hi, hiHi, hiLo);
+		double pLo(((yHi * hiHi - p) + yHi * hiLo + yLo * hiHi) + yLo * hiLo + y[i] * lo);
+		pLo = fabs(p) < 1000.0 ? pLo : 0.0;
+
+		// The correction is skipped on overflow, where inf * 0 would give NaN
+		const double e(ExpKernel(p));
+		double result(e == HUGE_VAL ? e : e + e * pLo);
+
+		// Negative bases are only defined for integer exponents.  The tests
+		// are written as selects on doubles so the loop stays vectorizable.
+		// The special cases follow C99 (Annex F), as the scalar pow() does.
+		const double rounded(ay < two52 ? (ay + two52) - two52 : ay);
+		const double half(0.5 * ay);
+		const bool integer(rounded == ay);
+		const double oddSign(integer && ay < two53 ? ((half + two52) - two52 != half ? -1.0 : 1.0) : 1.0);
+
+		result = ax == 1.0 ? 1.0 : result;// Huge exponents would make the correction NaN
+		result = ax == 0.0 ? (y[i] > 0.0 ? 0.0 : HUGE_VAL) : result;
+		result = ax == HUGE_VAL ? (y[i] > 0.0 ? HUGE_VAL : 0.0) : result;
+		result = copysign(1.0, x[i]) < 0.0 ? result * oddSign : result;
+		result = x[i] < 0.0 && ax != HUGE_VAL && !integer ? NAN : result;
+		result = ay == HUGE_VAL ? (ax == 1.0 ? 1.0 : ((ax > 1.0) == (y[i] > 0.0) ? HUGE_VAL : 0.0)) : result;
+
+		result = x[i] != x[i] ? x[i] : result;
+		result = y[i] != y[i] ? y[i] : result;
+		result = y[i] == 1.0 ? x[i] : result;
+		result = y[i] == 0.0 ? 1.0 : result;
+		result = x[i] == 1.0 ? 1.0 : result;
+		z[i] = result;
+	}
+}
@@ -0,0 +1,32 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  vectorMath.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Array forms of the math functions available to relations, written
+//				 without data-dependent branches so they vectorize.
+// History:
+
+#ifndef _VECTOR_MATH_H_
+#define _VECTOR_MATH_H_
+
+// Standard C++ headers
+#include <cstddef>
+
+namespace VectorMath
+{
+	// Outputs may alias inputs
+	void Sqrt(const double *x, double *y, const size_t &count);
+	void Exp(const double *x, double *y, const size_t &count);
+	void Log(const double *x, double *y, const size_t &count);
+	void Log10(const double *x, double *y, const size_t &count);
+	void Pow(const double *x, const double *y, double *z, const size_t &count);
+}
+
+#endif// _VECTOR_MATH_H_
@@ -13,10 +13,29 @@
 // History:
 
 // Standard C++ headers
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
 #include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+// wxWidgets headers
+#include <wx/filename.h>
 
 // Local headers
 #include "xmlConversionFactors.h"
+#include "xmlStreamReader.h"
+#include "catalogCache.h"
+#include "mappedFile.h"
+#include "embeddedCatalog.h"
+#include "expressionTree.h"
+#include "compiledConversion.h"
+#include "parallel.h"
+#include "cycleCheck.h"
+#include "editJournal.h"
+#include "catalogFormat.h"
+#include "messageReporter.h"
 
 // To maintain support for wxWidgets versions < 2.9
 #if !wxCHECK_VERSION(3,0,0)
@@ -49,6 +68,14 @@ const wxString XMLConversionFactors::aUnitAttr(_T("A_UNIT"));
 const wxString XMLConversionFactors::bUnitAttr(_T("B_UNIT"));
 const wxString XMLConversionFactors::equationAttr(_T("RELATION"));
 
+// Edit journal record types
+const std::string XMLConversionFactors::addGroupEdit("G");
+const std::string XMLConversionFactors::addEquivalenceEdit("E");
+const std::string XMLConversionFactors::changeEquivalenceEdit("C");
+const std::string XMLConversionFactors::setVisibilityEdit("V");
+const std::string XMLConversionFactors::compactedEdit("X");// Hash and size of the compacted catalog
+const uint64_t XMLConversionFactors::maxJournalSize(64 * 1024);
+
 //==========================================================================
 // Class:			XMLConversionFactors
 // Function:		XMLConversionFactors
@@ -57,6 +84,8 @@ const wxString XMLConversionFactors::equationAttr(_T("RELATION"));
 //
 // Input Arguments:
 //		fileName	= const wxString&
+//		lazy		= const bool&
+//		overlay		= const bool&
 //
 // Output Arguments:
 //		None
@@ -65,15 +94,17 @@ const wxString XMLConversionFactors::equationAttr(_T("RELATION"));
 //		None
 //
 //==========================================================================
-XMLConversionFactors::XMLConversionFactors(const wxString &fileName) : fileName(fileName)
+XMLConversionFactors::XMLConversionFactors(const wxString &fileName, const bool &lazy, const bool &overlay)
+	: fileName(fileName), cacheFileName(fileName + _T(".cache")),
+	journalFileName(fileName + _T(".journal")), lazy(lazy), overlay(overlay)
 {
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		Load
+// Function:		~XMLConversionFactors
 //
-// Description:		Method for initializing this object.
+// Description:		Destructor for XMLConversionFactors class.
 //
 // Input Arguments:
 //		None
@@ -82,58 +113,315 @@ XMLConversionFactors::XMLConversionFactors(const wxString &fileName) : fileName(
 //		None
 //
 // Return Value:
-//		bool, true for success, false otherwise
+//		None
 //
 //==========================================================================
-bool XMLConversionFactors::Load()
+XMLConversionFactors::~XMLConversionFactors()
 {
-	ResetForLoad();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+//
+// Description:		Receives events from XMLStreamReader and builds the
+//					FactorGroups directly (no DOM is created).  When ranges
+//					are requested, only each group's name, display flag and
+//					byte range are recorded.
+//
+//==========================================================================
+class XMLConversionFactors::LoadHandler : public XMLStreamReader::Handler
+{
+public:
+	LoadHandler(std::vector<FactorGroup> &groups, XMLStreamReader &reader,
+		std::vector<std::pair<size_t, size_t> > *ranges = nullptr,
+		const unsigned int &depth = 0, const bool &allowEmptyGroups = false);
+
+	bool StartElement(const std::string &name, const XMLStreamReader::AttributeList &attributes) override;
+	bool EndElement(const std::string &name) override;
+
+private:
+	std::vector<FactorGroup> &groups;
+	XMLStreamReader &reader;
+	std::vector<std::pair<size_t, size_t> > *ranges;
+	const bool allowEmptyGroups;
+
+	unsigned int depth;
+	bool inGroup;
+	FactorGroup group;
+	size_t groupStart;
+	unsigned int equivalenceCount;
+
+	// UTF-8 copies of the tags, for comparison without conversion
+	const std::string rootTag;
+	const std::string groupTag;
+	const std::string equivTag;
+	const std::string nameTag;
+	const std::string displayTag;
+	const std::string aUnitTag;
+	const std::string bUnitTag;
+	const std::string equationTag;
+
+	bool Fail(const wxString &message);
+	bool ReadAttribute(const XMLStreamReader::AttributeList &attributes,
+		const std::string &tag, const wxString &node, wxString &value);
+	bool ReadGroup(const XMLStreamReader::AttributeList &attributes);
+	bool ReadEquivalence(const XMLStreamReader::AttributeList &attributes);
+
+	static std::string ToUTF8(const wxString &s);
+};
+
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		LoadHandler
+//
+// Description:		Constructor for LoadHandler class.
+//
+// Input Arguments:
+//		groups	= std::vector<FactorGroup>& to which groups are added
+//		reader	= XMLStreamReader&
+//		ranges	= std::vector<std::pair<size_t, size_t> >* (if not NULL,
+//				  equivalences are skipped and group ranges are added)
+//		depth	= const unsigned int& (1 when reading a single group)
+//		allowEmptyGroups	= const bool&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+XMLConversionFactors::LoadHandler::LoadHandler(std::vector<FactorGroup> &groups,
+	XMLStreamReader &reader, std::vector<std::pair<size_t, size_t> > *ranges,
+	const unsigned int &depth, const bool &allowEmptyGroups) : groups(groups), reader(reader),
+	ranges(ranges), allowEmptyGroups(allowEmptyGroups), depth(depth), inGroup(false), groupStart(0), equivalenceCount(0), rootTag(ToUTF8(rootName)), groupTag(ToUTF8(groupNodeStr)), equivTag(ToUTF8(equivNode)),
+	nameTag(ToUTF8(nameAttr)), displayTag(ToUTF8(displayAttr)), aUnitTag(ToUTF8(aUnitAttr)),
+	bUnitTag(ToUTF8(bUnitAttr)), equationTag(ToUTF8(equationAttr))
+{
+}
 
-	if (!document->Load(fileName, xmlEncoding, wxXMLDOC_KEEP_WHITESPACE_NODES))
-		return false;// Error message generated in wx call - don't create additional message
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		ToUTF8
+//
+// Description:		Converts the string to UTF-8.
+//
+// Input Arguments:
+//		s	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+//==========================================================================
+std::string XMLConversionFactors::LoadHandler::ToUTF8(const wxString &s)
+{
+	return std::string(s.utf8_str());
+}
 
-	if (document->GetFileEncoding().Cmp(xmlEncoding) != 0)
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		StartElement
+//
+// Description:		Handles element start events.  Elements other than groups
+//					and equivalences are ignored (to allow for comments, etc.).
+//
+// Input Arguments:
+//		name		= const std::string&
+//		attributes	= const XMLStreamReader::AttributeList&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false to stop reading
+//
+//==========================================================================
+bool XMLConversionFactors::LoadHandler::StartElement(const std::string &name,
+	const XMLStreamReader::AttributeList &attributes)
+{
+	depth++;
+	if (depth == 1)
 	{
-		wxMessageBox(_T("The XML declaration in ") + fileName
-			+ _T(" contains 'encoding=") + document->GetFileEncoding()
-			+ _T("', but Converter expects ") + xmlEncoding + _T("."));
-		return false;
+		if (!reader.GetEncoding().IsEmpty() && reader.GetEncoding().CmpNoCase(xmlEncoding) != 0)
+			return Fail(_T("The XML declaration contains 'encoding=") + reader.GetEncoding()
+				+ _T("', but Converter expects ") + xmlEncoding);
+
+		if (name != rootTag)
+			return Fail(_T("Root node expected to be '") + rootName + _T("'"));
 	}
+	else if (depth == 2 && name == groupTag)
+		return ReadGroup(attributes);
+	else if (depth == 3 && inGroup && name == equivTag)
+		return ReadEquivalence(attributes);
 
-	if (document->GetRoot()->GetName().Cmp(rootName) != 0)
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		EndElement
+//
+// Description:		Handles element end events.  Completed groups are added
+//					to the catalog.
+//
+// Input Arguments:
+//		name	= const std::string&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, false to stop reading
+//
+//==========================================================================
+bool XMLConversionFactors::LoadHandler::EndElement(const std::string &WXUNUSED(name))
+{
+	depth--;
+	if (depth == 1 && inGroup)
 	{
-		DoErrorMessage(_T("Root node expected to be '") + rootName + _T("'"));
-		return false;
+		inGroup = false;
+		if (equivalenceCount == 0 && !allowEmptyGroups)
+			return Fail(_T("Group '") + group.name + _T("' has no equivalence definitions"));
+
+		if (ranges)
+			ranges->push_back(std::make_pair(groupStart, reader.GetTagEnd()));
+		group.IndexUnits();
+		groups.push_back(std::move(group));
+		group = FactorGroup();
 	}
 
-	wxXmlNode *child = document->GetRoot()->GetChildren();
-	while (child)
-	{
-		if (child->GetName().Cmp(groupNodeStr) == 0)
-		{
-			if (!ReadGroupNode(child))
-				return false;
-		}
-		/*else// Don't do this to allow comments
-		{
-			DoErrorMessage(_T("Unknown node '") + child->GetName() + _T("'"));
-			return false;
-		}*/
+	return true;
+}
 
-		child = child->GetNext();
-	}
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		ReadGroup
+//
+// Description:		Begins a new group.
+//
+// Input Arguments:
+//		attributes	= const XMLStreamReader::AttributeList&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::LoadHandler::ReadGroup(const XMLStreamReader::AttributeList &attributes)
+{
+	inGroup = true;
+	groupStart = reader.GetTagStart();
+	equivalenceCount = 0;
+	if (!ReadAttribute(attributes, nameTag, groupNodeStr, group.name))
+		return false;
+
+	const std::string *display(XMLStreamReader::FindAttribute(attributes, displayTag.c_str()));
+	group.display = !display || display->compare("1") == 0;
+	group.displaySet = display != nullptr;
 
-	if (DuplicateGroupsExist())
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		ReadEquivalence
+//
+// Description:		Reads and validates an equivalence within the current
+//					group.
+//
+// Input Arguments:
+//		attributes	= const XMLStreamReader::AttributeList&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::LoadHandler::ReadEquivalence(const XMLStreamReader::AttributeList &attributes)
+{
+	equivalenceCount++;
+	if (ranges)
+		return true;
+
+	Equivalence equiv;
+	if (!ReadAttribute(attributes, aUnitTag, equivNode, equiv.aUnit) ||
+		!ReadAttribute(attributes, bUnitTag, equivNode, equiv.bUnit) ||
+		!ReadAttribute(attributes, equationTag, equivNode, equiv.equation))
 		return false;
 
-	return groups.size() > 0;
+	const wxString error(CheckEquivalence(equiv));
+	if (!error.IsEmpty())
+		return Fail(error);
+
+	group.equiv.push_back(std::move(equiv));
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		ReadAttribute
+//
+// Description:		Reads a required attribute.
+//
+// Input Arguments:
+//		attributes	= const XMLStreamReader::AttributeList&
+//		tag			= const std::string&
+//		node		= const wxString&, for error messages
+//
+// Output Arguments:
+//		value		= wxString&
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::LoadHandler::ReadAttribute(const XMLStreamReader::AttributeList &attributes,
+	const std::string &tag, const wxString &node, wxString &value)
+{
+	const std::string *attribute(XMLStreamReader::FindAttribute(attributes, tag.c_str()));
+	if (!attribute)
+		return Fail(_T("Cannot read '") + wxString::FromUTF8(tag.c_str()) + _T("' attribute for '") + node + _T("' node"));
+
+	value = wxString::FromUTF8(attribute->c_str(), attribute->size());
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::LoadHandler
+// Function:		Fail
+//
+// Description:		Passes an error message to the reader and stops reading.
+//
+// Input Arguments:
+//		message	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, always false
+//
+//==========================================================================
+bool XMLConversionFactors::LoadHandler::Fail(const wxString &message)
+{
+	reader.SetError(message);
+	return false;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		ReadGroupNode
+// Function:		Load
 //
-// Description:		Reads the specified group node and it's children.
+// Description:		Method for initializing this object.  Reads the catalog
+//					and applies any saved edits that have not yet been merged
+//					into it.
 //
 // Input Arguments:
 //		None
@@ -145,51 +433,144 @@ bool XMLConversionFactors::Load()
 //		bool, true for success, false otherwise
 //
 //==========================================================================
-bool XMLConversionFactors::ReadGroupNode(wxXmlNode *node)
+bool XMLConversionFactors::Load()
 {
-	FactorGroup newGroup;
-	if (!node->GetAttribute(nameAttr, &newGroup.name))
-	{
-		DoErrorMessage(_T("Cannot read '") + nameAttr + _T("' attribute for '") + groupNodeStr + _T("' node"));
+	ResetForLoad();
+	if (!LoadCatalog())
 		return false;
-	}
 
-	newGroup.display = node->GetAttribute(displayAttr, _T("1")).Cmp(_T("1")) == 0;
+	ReplayJournal();
+	return true;
+}
 
-	wxXmlNode *child = node->GetChildren();
-	while (child)
-	{
-		if (child->GetName().Cmp(equivNode) == 0)
-		{
-			Equivalence equiv;
-			if (!ReadEquivNode(child, equiv))
-				return false;
-			newGroup.equiv.push_back(equiv);
-		}
-		/*else// Don't do this to allow comments
-		{
-			DoErrorMessage(_T("Unknown node '") + child->GetName() + _T("'"));
-			return false;
-		}*/
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		Load
+//
+// Description:		Loads the catalog again after the file has changed,
+//					reusing the groups that have not.
+//
+// Input Arguments:
+//		previous	= const XMLConversionFactors&, loaded from the same file
+//
+// Output Arguments:
+//		changedGroups	= std::set<wxString>&, groups whose equivalences or
+//						  display flags (or whether they are set) differ from
+//						  previous (or that are in only one of the catalogs)
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::Load(const XMLConversionFactors &previous, std::set<wxString> &changedGroups)
+{
+	changedGroups.clear();
+	reuse = &previous;
+	const bool loaded(Load());
+	reuse = nullptr;
+	if (!loaded)
+		return false;
 
-		child = child->GetNext();
+	for (unsigned int i = 0; i < groups.size(); i++)
+	{
+		const int j(previous.FindGroup(groups[i].name));
+		if (j == wxNOT_FOUND || previous.GroupIsDisplayed(j) != groups[i].display ||
+			previous.GroupSetsDisplay(j) != groups[i].displaySet || !SameGroup(i, previous, j))
+			changedGroups.insert(groups[i].name);
 	}
 
-	if (newGroup.equiv.size() == 0)
+	for (unsigned int j = 0; j < previous.GroupCount(); j++)
 	{
-		DoErrorMessage(_T("Group '") + newGroup.name + _T("' has no equivalence definitions"));
+		if (FindGroup(previous.GetGroupName(j)) == wxNOT_FOUND)
+			changedGroups.insert(previous.GetGroupName(j));
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		Swap
+//
+// Description:		Exchanges the loaded catalogs (and unsaved edits) of this
+//					object and another for the same file.
+//
+// Input Arguments:
+//		other	= XMLConversionFactors&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::Swap(XMLConversionFactors &other)
+{
+	assert(fileName.Cmp(other.fileName) == 0);
+
+	std::swap(sourceHash, other.sourceHash);
+	std::swap(sourceSize, other.sourceSize);
+	pendingEdits.swap(other.pendingEdits);
+	document.swap(other.document);
+	nodeIndexes.swap(other.nodeIndexes);
+
+	groups.swap(other.groups);
+	groupIndex.swap(other.groupIndex);
+	cache.swap(other.cache);
+	source.swap(other.source);
+	groupRanges.swap(other.groupRanges);
+	groupSources.swap(other.groupSources);
+	groupRead.swap(other.groupRead);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		SameEquivalences
+//
+// Description:		Checks whether two groups have the same equivalences, in
+//					the same order (so that one's solutions apply to the
+//					other).
+//
+// Input Arguments:
+//		a	= const FactorGroup&
+//		b	= const FactorGroup&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool XMLConversionFactors::SameEquivalences(const FactorGroup &a, const FactorGroup &b)
+{
+	if (a.equiv.size() != b.equiv.size())
 		return false;
+
+	for (size_t i = 0; i < a.equiv.size(); i++)
+	{
+		if (a.equiv[i].aUnit.Cmp(b.equiv[i].aUnit) != 0 ||
+			a.equiv[i].bUnit.Cmp(b.equiv[i].bUnit) != 0 ||
+			a.equiv[i].equation.Cmp(b.equiv[i].equation) != 0)
+			return false;
 	}
 
-	groups.push_back(newGroup);
 	return true;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		ReadEquivNode
+// Function:		LoadCatalog
 //
-// Description:		Reads the specified equivalence node.
+// Description:		Reads the catalog.  The file is read in a single streaming
+//					pass; the DOM required for editing is only built when
+//					edits are merged into the file (see LoadDocument()).
+//					The pass only indexes the groups; in lazy mode, each group
+//					is read when it is first used, otherwise all groups are
+//					read, validated and solved in parallel.  A missing overlay
+//					is an empty catalog.  Catalogs in other formats (see
+//					CatalogFormat) are always read in full.
 //
 // Input Arguments:
 //		None
@@ -201,153 +582,1438 @@ bool XMLConversionFactors::ReadGroupNode(wxXmlNode *node)
 //		bool, true for success, false otherwise
 //
 //==========================================================================
-bool XMLConversionFactors::ReadEquivNode(wxXmlNode *node, Equivalence &equiv)
+bool XMLConversionFactors::LoadCatalog()
 {
-	if (!node->GetAttribute(aUnitAttr, &equiv.aUnit))
+	if (overlay && !::wxFileExists(fileName))
+		return true;// Nothing has been added yet
+
+#ifdef EMBEDDED_CATALOG
+	// Without a user file, the catalog built into the executable is used
+	if (!::wxFileExists(fileName))
+		return LoadEmbedded();
+#endif
+
+	// Kept (as source) if groups are read from it later
+	std::unique_ptr<MappedFile> file(std::make_unique<MappedFile>());
+	if (!::wxFileExists(fileName) || !file->Open(fileName))
 	{
-		DoErrorMessage(_T("Cannot read '") + aUnitAttr + _T("' property from '") + equivNode + _T("' node"));
+		DoErrorMessage(_T("Cannot open '") + fileName + _T("'"));
 		return false;
 	}
 
-	if (!node->GetAttribute(bUnitAttr, &equiv.bUnit))
+	// The cache only holds catalogs that were valid when it was written, so
+	// no further checks are required when it matches.  It stays mapped and
+	// groups are copied out of it as they are used.
+	sourceHash = CatalogCache::Hash(file->GetData(), file->GetSize());
+	sourceSize = file->GetSize();
+	cache = std::make_unique<CatalogCache>();
+	if (cache->Open(cacheFileName, sourceHash, file->GetSize()))
 	{
-		DoErrorMessage(_T("Cannot read '") + bUnitAttr + _T("' property from '") + equivNode + _T("' node"));
-		return false;
+		groups.resize(cache->GroupCount());
+		for (unsigned int i = 0; i < groups.size(); i++)
+		{
+			groups[i].name = cache->GetGroupName(i).ToString();
+			groups[i].display = cache->GetGroupDisplay(i);
+			groups[i].displaySet = cache->GetGroupSetsDisplay(i);
+			groupSources.push_back(i);
+		}
+
+		groupRead.reset(new ReadState[groups.size()]);
+		return IndexGroups() && (groups.size() > 0 || overlay);
 	}
+	cache.reset();
 
-	if (!node->GetAttribute(equationAttr, &equiv.equation))
+	const CatalogFormat::Type format(CatalogFormat::FromFileName(fileName));
+	if (format != CatalogFormat::typeXML)
 	{
-		DoErrorMessage(_T("Cannot read '") + equationAttr + _T("' property from '") + equivNode + _T("' node"));
-		return false;
+		const wxString error(CatalogFormat::Read(format, file->GetData(), file->GetSize(), overlay, groups));
+		if (!error.IsEmpty())
+		{
+			DoErrorMessage(error);
+			return false;
+		}
+
+		if (!IndexGroups() || (groups.size() == 0 && !overlay) || !CheckAllGroups())
+		{
+			groups.clear();
+			return false;
+		}
+
+		CatalogCache::Write(cacheFileName, sourceHash, file->GetSize(), groups);
+		return true;
 	}
-	if (!equiv.equation.Contains(_T("=")) ||
-		!equiv.equation.Contains(_T("a")) ||
-		!equiv.equation.Contains(_T("b")))
+
+	XMLStreamReader reader;
+	LoadHandler handler(groups, reader, &groupRanges, 0, overlay);
+	if (!reader.Parse(file->GetData(), file->GetData() + file->GetSize(), handler))
 	{
-		DoErrorMessage(_T("Relationship between '") + equiv.aUnit + _T("' and '")
-			+ equiv.bUnit + _T("' must containt 'a', 'b', and '='"));
+		DoErrorMessage(reader.GetError() + wxString::Format(_T(" (line %u)"), reader.GetLine()));
+		groups.clear();
+		groupRanges.clear();
 		return false;
 	}
 
-	if (equiv.aUnit.Cmp(equiv.bUnit) == 0)
+	if (!IndexGroups() || (groups.size() == 0 && !overlay))
+		return false;
+
+	// The cache is only written once every group has been validated
+	if (lazy)
+	{
+		for (unsigned int i = 0; i < groups.size(); i++)
+			groupSources.push_back(i);
+		groupRead.reset(new ReadState[groups.size()]);
+		source = std::move(file);
+		return true;
+	}
+
+	if (!ReadAllGroups(file->GetData()))
 	{
-		DoErrorMessage(_T("Equivalence definition must have two unique unit strings"));
+		groups.clear();
+		groupRanges.clear();
 		return false;
 	}
+	groupRanges.clear();
+
+	// Failure to write the cache only costs time on the next load
+	CatalogCache::Write(cacheFileName, sourceHash, file->GetSize(), groups);
 
 	return true;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		DuplicateGroupsExist
+// Function:		ReadAllGroups
 //
-// Description:		Determines uniqueness of the groups.
+// Description:		Reads, validates, solves and checks every group in
+//					parallel.
+//					Messages are collected per group and reported in document
+//					order, so the report does not depend on thread timing.
 //
 // Input Arguments:
-//		None
+//		data	= const char*, start of the source XML
 //
 // Output Arguments:
 //		None
 //
 // Return Value:
-//		bool, true if two groups have the same name
+//		bool, true if every group was read without error
 //
 //==========================================================================
-bool XMLConversionFactors::DuplicateGroupsExist() const
+bool XMLConversionFactors::ReadAllGroups(const char *data)
 {
-	for (size_t i = 1; i < groups.size(); i++)
+	std::vector<wxString> errors(groups.size()), warnings(groups.size());
+	Parallel::For(groups.size(), [this, data, &errors, &warnings](const size_t &i)
 	{
-		for (size_t j = i + 1; j < groups.size(); j++)
-		{
-			if (groups[i].name.CmpNoCase(groups[j].name) == 0)
-			{
-				DoErrorMessage(_T("Duplicate groups '") + groups[i - 1].name + _T("'"));
-				return true;
-			}
-		}
-	}
+		errors[i] = ReadGroupFromSource(data, i, groups[i], warnings[i]);
+	});
 
-	return false;
+	return ReportMessages(errors, warnings);
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		GetGroup
+// Function:		ReportMessages
 //
-// Description:		Gets the group by name.
+// Description:		Reports the errors and warnings collected for each group,
+//					in group order.
 //
 // Input Arguments:
-//		None
+//		errors		= const std::vector<wxString>&
+//		warnings	= const std::vector<wxString>&, same size as errors
 //
 // Output Arguments:
 //		None
 //
 // Return Value:
-//		XMLConversionFactors::FactorGroup
+//		bool, true if there were no errors
 //
 //==========================================================================
-XMLConversionFactors::FactorGroup XMLConversionFactors::GetGroup(const wxString &name) const
+bool XMLConversionFactors::ReportMessages(const std::vector<wxString> &errors,
+	const std::vector<wxString> &warnings) const
 {
-	for (size_t i = 0; i < groups.size(); i++)
+	wxString errorReport, warningReport;
+	for (unsigned int i = 0; i < errors.size(); i++)
+	{
+		if (!errors[i].IsEmpty())
+			errorReport += (errorReport.IsEmpty() ? wxString() : wxString(_T("\n"))) + errors[i];
+		if (!warnings[i].IsEmpty())
+			warningReport += (warningReport.IsEmpty() ? wxString() : wxString(_T("\n"))) + warnings[i];
+	}
+
+	if (!errorReport.IsEmpty())
+	{
+		DoErrorMessage(errorReport);
+		return false;
+	}
+
+	if (!warningReport.IsEmpty())
+		DoWarningMessage(warningReport);
+
+	return true;
+}
+
+#ifdef EMBEDDED_CATALOG
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		LoadEmbedded
+//
+// Description:		Loads the catalog that was built into the executable.
+//					The tables were solved and checked when they were
+//					generated, so the groups are only indexed.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::LoadEmbedded()
+{
+	groups.resize(EmbeddedCatalog::groupCount);
+	for (unsigned int i = 0; i < EmbeddedCatalog::groupCount; i++)
+	{
+		const EmbeddedCatalog::Group &g(EmbeddedCatalog::groups[i]);
+		groups[i].name = wxString::FromUTF8(g.name);
+		groups[i].display = g.display;
+		groups[i].equiv.resize(g.equivalenceCount);
+		for (unsigned int j = 0; j < g.equivalenceCount; j++)
+		{
+			const EmbeddedCatalog::Equivalence &e(EmbeddedCatalog::equivalences[g.firstEquivalence + j]);
+			groups[i].equiv[j].aUnit = wxString::FromUTF8(e.aUnit);
+			groups[i].equiv[j].bUnit = wxString::FromUTF8(e.bUnit);
+			groups[i].equiv[j].equation = wxString::FromUTF8(e.equation);
+			groups[i].equiv[j].aSolution = wxString::FromUTF8(e.aSolution);
+			groups[i].equiv[j].bSolution = wxString::FromUTF8(e.bSolution);
+			groups[i].equiv[j].pathEdge = e.pathEdge;
+		}
+		groups[i].IndexUnits();
+	}
+
+	return IndexGroups() && groups.size() > 0;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		CopyGroupsToDocument
+//
+// Description:		Adds the embedded catalog to the (empty) document, so that
+//					edits to the embedded catalog are saved as a complete
+//					user file.  The tables are used rather than the loaded
+//					groups, which may already include journaled edits.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::CopyGroupsToDocument()
+{
+	for (unsigned int i = 0; i < EmbeddedCatalog::groupCount; i++)
+	{
+		const EmbeddedCatalog::Group &g(EmbeddedCatalog::groups[i]);
+		wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE, groupNodeStr);
+		node->AddAttribute(nameAttr, wxString::FromUTF8(g.name));
+		node->AddAttribute(displayAttr, g.display ? _T("1") : _T("0"));
+		AddNodePreserveFormatting(document->GetRoot(), node);
+
+		for (unsigned int j = 0; j < g.equivalenceCount; j++)
+		{
+			const EmbeddedCatalog::Equivalence &e(EmbeddedCatalog::equivalences[g.firstEquivalence + j]);
+			Equivalence equiv;
+			equiv.aUnit = wxString::FromUTF8(e.aUnit);
+			equiv.bUnit = wxString::FromUTF8(e.bUnit);
+			equiv.equation = wxString::FromUTF8(e.equation);
+			AddNodePreserveFormatting(node, equiv.ToXmlNode());
+		}
+	}
+}
+#endif
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ReadGroup
+//
+// Description:		Reads the specified group's equivalences, if they have
+//					not already been read.  Safe to call from multiple threads.
+//					Only the equivalences are written (published by the done
+//					flag); the name and display flag are left alone, since
+//					the display flag may have been edited and a reload may be
+//					reading both on another thread.
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::ReadGroup(const unsigned int &i) const
+{
+	if (!groupRead || groupSources[i] == wxNOT_FOUND)
+		return;
+
+	const unsigned int entry(groupSources[i]);
+	std::call_once(groupRead[entry].once, [this, &i, &entry]()
+	{
+		FactorGroup group;
+		if (cache)
+			group = cache->GetGroup(entry);
+		else
+		{
+			wxString warnings;
+			const wxString error(ReadGroupFromSource(source->GetData(), entry, group, warnings));
+			if (!error.IsEmpty())
+				DoErrorMessage(error);
+			else if (!warnings.IsEmpty())
+				DoWarningMessage(warnings);
+		}
+		groups[i].TakeEquivalences(std::move(group));
+		groupRead[entry].done.store(true, std::memory_order_release);
+	});
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ReleaseSource
+//
+// Description:		Reads every group that has not been read, then unmaps the
+//					source.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::ReleaseSource()
+{
+	for (unsigned int i = 0; i < groups.size(); i++)
+		ReadGroup(i);
+
+	groupRead.reset();
+	groupSources.clear();
+	groupRanges.clear();
+	source.reset();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ReadGroupFromSource
+//
+// Description:		Reads, validates and solves the specified group from its
+//					byte range in the source XML.  On error, the group is left
+//					without equivalences.  Only touches the given group, so
+//					groups may be read concurrently.  When reloading, a group
+//					with the same equivalences as before is copied, solutions
+//					and all (its warnings were reported when it was first read).
+//
+// Input Arguments:
+//		data	= const char*, start of the source XML
+//		range	= const unsigned int&, index of the group's byte range
+//
+// Output Arguments:
+//		group		= FactorGroup&
+//		warnings	= wxString&, equations that could not be solved
+//
+// Return Value:
+//		wxString, empty for success, error message otherwise
+//
+//==========================================================================
+wxString XMLConversionFactors::ReadGroupFromSource(const char *data,
+	const unsigned int &range, FactorGroup &group, wxString &warnings) const
+{
+	const char *first(data + groupRanges[range].first);
+	std::vector<FactorGroup> read;
+	XMLStreamReader reader;
+	LoadHandler handler(read, reader, nullptr, 1, overlay);
+	if (!reader.Parse(first, data + groupRanges[range].second, handler))
+	{
+		const unsigned int line(std::count(data, first, '\n') + reader.GetLine());
+		return reader.GetError() + wxString::Format(_T(" (line %u)"), line);
+	}
+
+	if (!ReuseGroup(read.front()))
+		warnings = CheckGroup(read.front());
+	group = std::move(read.front());
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ReuseGroup
+//
+// Description:		When reloading, replaces a group that has the same
+//					equivalences as before with the previous copy, solutions
+//					and all (its warnings were reported when it was first
+//					read).  The display flag is kept.
+//
+// Input Arguments:
+//		group	= FactorGroup&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if the group was replaced (and need not be checked)
+//
+//==========================================================================
+bool XMLConversionFactors::ReuseGroup(FactorGroup &group) const
+{
+	const int previous(reuse ? reuse->FindGroup(group.name) : wxNOT_FOUND);
+	const FactorGroup *previousGroup(previous == wxNOT_FOUND ? nullptr : reuse->GetReadGroup(previous));
+	if (!previousGroup || !SameEquivalences(group, *previousGroup))
+		return false;
+
+	const bool display(group.display), displaySet(group.displaySet);
+	group = *previousGroup;
+	group.display = display;
+	group.displaySet = displaySet;
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		GetReadGroup
+//
+// Description:		Returns the specified group if it has been read, without
+//					reading it.  Safe to call from another thread while the
+//					catalog is in use (but not while it is edited).
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const FactorGroup*, NULL if the group has not been read
+//
+//==========================================================================
+const XMLConversionFactors::FactorGroup* XMLConversionFactors::GetReadGroup(const unsigned int &i) const
+{
+	if (groupRead && groupSources[i] != wxNOT_FOUND &&
+		!groupRead[groupSources[i]].done.load(std::memory_order_acquire))
+		return nullptr;
+	return &groups[i];
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		GetGroupSource
+//
+// Description:		Finds the XML text of a group that has not been read.
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		first	= const char*&
+//		last	= const char*&
+//
+// Return Value:
+//		bool, false if the group has no text in the source (it was read
+//		from the cache or added by an edit)
+//
+//==========================================================================
+bool XMLConversionFactors::GetGroupSource(const unsigned int &i, const char *&first, const char *&last) const
+{
+	if (!source || !groupRead || groupSources[i] == wxNOT_FOUND)
+		return false;
+
+	first = source->GetData() + groupRanges[groupSources[i]].first;
+	last = source->GetData() + groupRanges[groupSources[i]].second;
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		SameGroup
+//
+// Description:		Checks whether a group has the same equivalences as it
+//					did in the previous catalog, without reading the previous
+//					catalog's groups (which would read them on this thread,
+//					and defeat lazy loading).  Groups read by both are
+//					compared by their equivalences; groups read by neither
+//					by their XML text.  A group that the previous catalog has
+//					read is read here too.  Groups that cannot be compared
+//					are reported as changed.
+//
+// Input Arguments:
+//		i			= const unsigned int&, index in this catalog
+//		previous	= const XMLConversionFactors&
+//		j			= const unsigned int&, index in previous
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if the group is known to be unchanged
+//
+//==========================================================================
+bool XMLConversionFactors::SameGroup(const unsigned int &i,
+	const XMLConversionFactors &previous, const unsigned int &j) const
+{
+	const FactorGroup *previousGroup(previous.GetReadGroup(j));
+	if (previousGroup)
+		return SameEquivalences(GetGroup(i), *previousGroup);
+
+	const char *first, *last, *previousFirst, *previousLast;
+	return !GetReadGroup(i) && GetGroupSource(i, first, last) &&
+		previous.GetGroupSource(j, previousFirst, previousLast) &&
+		last - first == previousLast - previousFirst &&
+		std::equal(first, last, previousFirst);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		CheckAllGroups
+//
+// Description:		Solves and checks every (already read) group in parallel,
+//					reusing unchanged groups when reloading.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if there were no errors
+//
+//==========================================================================
+bool XMLConversionFactors::CheckAllGroups()
+{
+	std::vector<wxString> errors(groups.size()), warnings(groups.size());
+	Parallel::For(groups.size(), [this, &warnings](const size_t &i)
+	{
+		if (!ReuseGroup(groups[i]))
+			warnings[i] = CheckGroup(groups[i]);
+	});
+
+	return ReportMessages(errors, warnings);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		GetGroup
+//
+// Description:		Returns the specified group, reading it if necessary.
+//
+// Input Arguments:
+//		i	= const unsigned int&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const FactorGroup&
+//
+//==========================================================================
+const XMLConversionFactors::FactorGroup& XMLConversionFactors::GetGroup(const unsigned int &i) const
+{
+	ReadGroup(i);
+	return groups[i];
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		CheckGroup
+//
+// Description:		Solves the group's equations and checks that its
+//					redundant equivalences agree and that its units are
+//					connected.
+//
+// Input Arguments:
+//		group	= FactorGroup&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings (empty if there are none)
+//
+//==========================================================================
+wxString XMLConversionFactors::CheckGroup(FactorGroup &group)
+{
+	wxString warnings(SolveEquivalences(group));
+	const wxString cycles(CycleCheck(group).Check());
+	if (!cycles.IsEmpty())
+		warnings += (warnings.IsEmpty() ? wxString() : wxString(_T("\n"))) + cycles;
+
+	if (group.ComponentCount() > 1)
+	{
+		// Name the first unit of each component
+		wxString examples;
+		unsigned int next(0);
+		for (unsigned int i = 0; i < group.GetUnitList().Count(); i++)
+		{
+			if (group.GetComponent(i) != next)
+				continue;
+
+			examples += (next == 0 ? wxString() : wxString(_T(", "))) + _T("'") + group.GetUnitList()[i] + _T("'");
+			next++;
+		}
+
+		warnings += (warnings.IsEmpty() ? wxString() : wxString(_T("\n")))
+			+ _T("Group '") + group.name + wxString::Format(_T("' is split into %u unconnected sets of units ("),
+			group.ComponentCount()) + examples + _T(")");
+	}
+
+	return warnings;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		CheckEquivalence
+//
+// Description:		Checks that the equivalence's relation contains both units
+//					and an equals sign, and that the units differ.
+//
+// Input Arguments:
+//		e	= const Equivalence&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, empty if valid, error message otherwise
+//
+//==========================================================================
+wxString XMLConversionFactors::CheckEquivalence(const Equivalence &e)
+{
+	if (!e.equation.Contains(_T("=")) ||
+		!ExpressionTree::ContainsVariable(e.equation, _T("a")) ||
+		!ExpressionTree::ContainsVariable(e.equation, _T("b")))
+		return _T("Relationship between '") + e.aUnit + _T("' and '")
+			+ e.bUnit + _T("' must containt 'a', 'b', and '='");
+
+	if (e.aUnit.Cmp(e.bUnit) == 0)
+		return _T("Equivalence definition must have two unique unit strings");
+
+	return wxEmptyString;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		SolveEquivalences
+//
+// Description:		Solves each equation for a and for b, so the solutions
+//					can be stored in the cache, and checks that each solution
+//					compiles.  Solutions that fail are left empty and are
+//					solved again (and the error reported) when a conversion
+//					uses them.  Equations that are already solved (e.g. copied
+//					from another catalog) are not solved again.
+//
+// Input Arguments:
+//		group	= FactorGroup&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, one line per solution that failed (empty if none did)
+//
+//==========================================================================
+wxString XMLConversionFactors::SolveEquivalences(FactorGroup &group)
+{
+	ExpressionTree tree;
+	CompiledConversion check;
+	wxString warnings;
+	auto solve = [&](const Equivalence &equiv, const wxString &unknown,
+		const wxString &variable, wxString &solution)
+	{
+		wxString error(tree.SolveForString(equiv.equation, unknown, solution));
+		if (error.IsEmpty())
+			error = check.Compile(solution, variable);
+		if (error.IsEmpty())
+			return;
+
+		solution.Clear();
+		warnings += (warnings.IsEmpty() ? wxString() : wxString(_T("\n")))
+			+ _T("Cannot solve '") + equiv.equation + _T("' for ") + unknown
+			+ _T(" in group '") + group.name + _T("':  ") + error;
+	};
+
+	for (auto &equiv : group.equiv)
+	{
+		if (equiv.aSolution.IsEmpty())
+			solve(equiv, _T("a"), _T("b"), equiv.aSolution);
+		if (equiv.bSolution.IsEmpty())
+			solve(equiv, _T("b"), _T("a"), equiv.bSolution);
+	}
+
+	return warnings;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		LoadDocument
+//
+// Description:		Builds the DOM used for editing, if it does not already
+//					exist.  Whitespace nodes are kept so that saved files keep
+//					their formatting.  A missing overlay starts out empty.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if the document is ready for editing
+//
+//==========================================================================
+bool XMLConversionFactors::LoadDocument()
+{
+	if (document)
+		return document->IsOk();
+
+	document = std::make_unique<wxXmlDocument>();
+	nodeIndexes.clear();
+	if (!::wxFileExists(fileName))
+	{
+		if (overlay)
+			return CreateEmptyDocument();
+
+#ifdef EMBEDDED_CATALOG
+		if (CreateEmptyDocument())
+		{
+			CopyGroupsToDocument();
+			return true;
+		}
+#endif
+		return false;
+	}
+
+	return document->Load(fileName, xmlEncoding, wxXMLDOC_KEEP_WHITESPACE_NODES);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		IndexGroups
+//
+// Description:		Builds the group name index, checking that group names
+//					are unique (ignoring case).
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false if duplicate groups exist
+//
+//==========================================================================
+bool XMLConversionFactors::IndexGroups()
+{
+	std::unordered_set<wxString, StringHash> lowerCaseNames;
+	lowerCaseNames.reserve(groups.size());
+	groupIndex.clear();
+	groupIndex.reserve(groups.size());
+	for (unsigned int i = 0; i < groups.size(); i++)
+	{
+		if (!lowerCaseNames.insert(groups[i].name.Lower()).second)
+		{
+			DoErrorMessage(_T("Duplicate groups '") + groups[i].name + _T("'"));
+			groupIndex.clear();
+			return false;
+		}
+
+		groupIndex.insert(std::make_pair(groups[i].name, i));
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		GetGroup
+//
+// Description:		Gets the group by name.
+//
+// Input Arguments:
+//		name	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const XMLConversionFactors::FactorGroup&
+//
+//==========================================================================
+const XMLConversionFactors::FactorGroup& XMLConversionFactors::GetGroup(const wxString &name) const
+{
+	const int i(FindGroup(name));
+	if (i == wxNOT_FOUND)
+		throw std::runtime_error("Group not found");
+
+	return GetGroup(i);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		FindGroup
+//
+// Description:		Finds the index of the group with the specified name.
+//
+// Input Arguments:
+//		name	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, index of the group or wxNOT_FOUND
+//
+//==========================================================================
+int XMLConversionFactors::FindGroup(const wxString &name) const
+{
+	std::unordered_map<wxString, unsigned int, StringHash>::const_iterator it(groupIndex.find(name));
+	if (it == groupIndex.end())
+		return wxNOT_FOUND;
+
+	return static_cast<int>(it->second);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		DoErrorMessage
+//
+// Description:		Displays "Error reading..." message.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::DoErrorMessage(const wxString &message) const
+{
+	if (deferMessages)
+	{
+		std::lock_guard<std::mutex> lock(messageMutex);
+		deferredErrors += (deferredErrors.IsEmpty() ? wxString() : wxString(_T("\n"))) + message;
+		return;
+	}
+
+	MessageReporter::Error(_T("Error reading XML document:  ") + message + _T("."));
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		DoWarningMessage
+//
+// Description:		Displays a warning about a document that was read
+//					successfully.
+//
+// Input Arguments:
+//		message	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::DoWarningMessage(const wxString &message) const
+{
+	if (deferMessages)
+	{
+		std::lock_guard<std::mutex> lock(messageMutex);
+		deferredWarnings += (deferredWarnings.IsEmpty() ? wxString() : wxString(_T("\n"))) + message;
+		return;
+	}
+
+	MessageReporter::Warning(_T("Warning reading XML document:  ") + message + _T("."));
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ShowMessages
+//
+// Description:		Shows (and clears) the deferred messages.  Must be called
+//					from the main thread.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::ShowMessages()
+{
+	wxString errors, warnings;
+	{
+		std::lock_guard<std::mutex> lock(messageMutex);
+		errors.swap(deferredErrors);
+		warnings.swap(deferredWarnings);
+	}
+
+	const bool defer(deferMessages);
+	deferMessages = false;
+	if (!errors.IsEmpty())
+		DoErrorMessage(errors);
+	if (!warnings.IsEmpty())
+		DoWarningMessage(warnings);
+	deferMessages = defer;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		CreateEmptyDocument
+//
+// Description:		Creates empty conversion XML document.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if file written successfully
+//
+//==========================================================================
+bool XMLConversionFactors::CreateEmptyDocument()
+{
+	document = std::make_unique<wxXmlDocument>();
+	nodeIndexes.clear();
+	document->SetRoot(new wxXmlNode(wxXML_ELEMENT_NODE, rootName));
+	
+	return document->IsOk();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		AddGroup
+//
+// Description:		Adds a new group.  The edit is applied to the loaded
+//					groups immediately and written to the journal by Save().
+//
+// Input Arguments:
+//		name	= const wxString &name
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::AddGroup(const wxString &name)
+{
+	EditJournal::Record edit;
+	edit.push_back(addGroupEdit);
+	edit.push_back(std::string(name.utf8_str()));
+	ApplyEdit(edit);
+	pendingEdits.push_back(edit);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		AddEquivalence
+//
+// Description:		Adds an equivalence to the specified group.  The edit is
+//					applied to the loaded groups immediately and written to the
+//					journal by Save().
+//
+// Input Arguments:
+//		name	= const wxString& specifying the group
+//		e		= const Equivalence&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings from checking the group (empty if none)
+//
+//==========================================================================
+wxString XMLConversionFactors::AddEquivalence(const wxString &name, const Equivalence &e)
+{
+	EditJournal::Record edit(MakeEquivalenceEdit(addEquivalenceEdit, name, e));
+	ApplyEdit(edit);
+	pendingEdits.push_back(edit);
+	return CheckGroups(std::set<wxString>(&name, &name + 1)).front();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ChangeEquivalence
+//
+// Description:		Changes the equation of an existing equivalence.  The edit
+//					is applied to the loaded groups immediately and written to
+//					the journal by Save().
+//
+// Input Arguments:
+//		name	= const wxString& specifying the group
+//		e		= const Equivalence&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings from checking the group (empty if none)
+//
+//==========================================================================
+wxString XMLConversionFactors::ChangeEquivalence(const wxString &name, const Equivalence &e)
+{
+	EditJournal::Record edit(MakeEquivalenceEdit(changeEquivalenceEdit, name, e));
+	ApplyEdit(edit);
+	pendingEdits.push_back(edit);
+	return CheckGroups(std::set<wxString>(&name, &name + 1)).front();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		SetGroupVisibility
+//
+// Description:		Sets the visibility of the specified group.  The edit is
+//					applied to the loaded groups immediately and written to the
+//					journal by Save().
+//
+// Input Arguments:
+//		name	= const wxString&
+//		visible	= const bool&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::SetGroupVisibility(const wxString &name, const bool &visible)
+{
+	EditJournal::Record edit;
+	edit.push_back(setVisibilityEdit);
+	edit.push_back(std::string(name.utf8_str()));
+	edit.push_back(visible ? "1" : "0");
+	ApplyEdit(edit);
+	pendingEdits.push_back(edit);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		AddEquivalences
+//
+// Description:		Adds (or changes) a batch of equivalences as one edit.
+//					Only the groups it changes are read, and only they are
+//					copied, so a failure can restore them (and remove any
+//					groups it added).  New groups are added together, so the
+//					group index is only rebuilt once.  Save() journals the
+//					edits together.  The equivalences are used as given, so
+//					their solutions (e.g. found while checking an import) are
+//					kept rather than found again.
+//
+// Input Arguments:
+//		entries	= const std::vector<std::pair<wxString, Equivalence> >&,
+//				  group names and equivalences
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		wxString, warnings from checking the changed groups (empty if none)
+//
+//==========================================================================
+wxString XMLConversionFactors::AddEquivalences(const std::vector<std::pair<wxString, Equivalence> > &entries)
+{
+	// Position of each equivalence in each changed group, by its units, so
+	// that repeated units become changes (units are unique within a group)
+	typedef std::map<std::pair<wxString, wxString>, unsigned int> PositionMap;
+	std::map<wxString, PositionMap> positions;
+	std::vector<unsigned int> entryPositions;
+	std::vector<wxString> added;
+	std::vector<EditJournal::Record> edits;
+	std::vector<FactorGroup> original;// Of the existing groups that are changed
+	for (const auto &entry : entries)
+	{
+		auto group(positions.find(entry.first));
+		if (group == positions.end())
+		{
+			group = positions.insert(std::make_pair(entry.first, PositionMap())).first;
+			const int i(FindGroup(entry.first));
+			if (i == wxNOT_FOUND)
+			{
+				EditJournal::Record edit;
+				edit.push_back(addGroupEdit);
+				edit.push_back(std::string(entry.first.utf8_str()));
+				edits.push_back(edit);
+				added.push_back(entry.first);
+			}
+			else
+			{
+				original.push_back(GetGroup(i));
+				for (unsigned int j = 0; j < groups[i].equiv.size(); j++)
+					group->second.insert(std::make_pair(std::make_pair(
+						groups[i].equiv[j].aUnit, groups[i].equiv[j].bUnit), j));
+			}
+		}
+
+		const auto position(group->second.insert(std::make_pair(std::make_pair(
+			entry.second.aUnit, entry.second.bUnit), group->second.size())));
+		edits.push_back(MakeEquivalenceEdit(position.second ? addEquivalenceEdit : changeEquivalenceEdit,
+			entry.first, entry.second));
+		entryPositions.push_back(position.first->second);
+	}
+
+	AddGroups(added);// Changes nothing if any of them exist
+	try
+	{
+		for (unsigned int j = 0; j < entries.size(); j++)
+		{
+			FactorGroup &group(groups[FindGroup(entries[j].first)]);
+			if (entryPositions[j] == group.equiv.size())
+				group.equiv.push_back(entries[j].second);
+			else
+				group.equiv[entryPositions[j]] = entries[j].second;
+		}
+	}
+	catch (std::exception &)
+	{
+		RemoveGroups(added);
+		for (auto &group : original)
+			groups[FindGroup(group.name)] = std::move(group);
+		throw;
+	}
+
+	pendingEdits.insert(pendingEdits.end(), edits.begin(), edits.end());
+
+	std::set<wxString> changedGroups;
+	for (const auto &group : positions)
+		changedGroups.insert(group.first);
+
+	wxString warnings;
+	for (const auto &message : CheckGroups(changedGroups))
+	{
+		if (!message.IsEmpty())
+			warnings += (warnings.IsEmpty() ? wxString() : wxString(_T("\n"))) + message;
+	}
+
+	return warnings;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		AddGroups
+//
+// Description:		Adds empty groups, each in the same position as its node
+//					is given in the document (before the first group whose
+//					name sorts after it), in a single pass.  Throws, without
+//					adding any, if a group of the same name (ignoring case)
+//					exists.
+//
+// Input Arguments:
+//		names	= std::vector<wxString>
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::AddGroups(std::vector<wxString> names)
+{
+	if (names.empty())
+		return;
+
+	std::unordered_set<wxString, StringHash> lowerCaseNames;
+	lowerCaseNames.reserve(groups.size() + names.size());
+	for (const auto &group : groups)
+		lowerCaseNames.insert(group.name.Lower());
+	for (const auto &name : names)
+	{
+		if (!lowerCaseNames.insert(name.Lower()).second)
+			throw std::runtime_error(std::string((_T("Group '") + name + _T("' already exists")).mb_str()));
+	}
+
+	std::sort(names.begin(), names.end(), [](const wxString &a, const wxString &b)
+	{
+		return a.CmpNoCase(b) < 0;
+	});
+
+	std::vector<FactorGroup> merged;
+	std::vector<int> mergedSources;
+	merged.reserve(groups.size() + names.size());
+	if (groupRead)
+		mergedSources.reserve(merged.capacity());
+	std::vector<wxString>::const_iterator name(names.begin());
+	for (unsigned int i = 0; i <= groups.size(); i++)
+	{
+		for (; name != names.end() && (i == groups.size() || name->CmpNoCase(groups[i].name) < 0); ++name)
+		{
+			FactorGroup group;
+			group.name = *name;
+			group.display = true;
+			group.displaySet = false;
+			group.IndexUnits();
+			merged.push_back(std::move(group));
+			if (groupRead)
+				mergedSources.push_back(wxNOT_FOUND);
+		}
+
+		if (i == groups.size())
+			break;
+		merged.push_back(std::move(groups[i]));
+		if (groupRead)
+			mergedSources.push_back(groupSources[i]);
+	}
+
+	groups = std::move(merged);
+	if (groupRead)
+		groupSources = std::move(mergedSources);
+	IndexGroups();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		RemoveGroups
+//
+// Description:		Removes the specified groups (added by AddGroups()) in a
+//					single pass.
+//
+// Input Arguments:
+//		names	= const std::vector<wxString>&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::RemoveGroups(const std::vector<wxString> &names)
+{
+	if (names.empty())
+		return;
+
+	const std::unordered_set<wxString, StringHash> removed(names.begin(), names.end());
+	unsigned int kept(0);
+	for (unsigned int i = 0; i < groups.size(); i++)
+	{
+		if (removed.find(groups[i].name) != removed.end())
+			continue;
+
+		if (kept != i)
+		{
+			groups[kept] = std::move(groups[i]);
+			if (groupRead)
+				groupSources[kept] = groupSources[i];
+		}
+		kept++;
+	}
+
+	groups.resize(kept);
+	if (groupRead)
+		groupSources.resize(kept);
+	IndexGroups();
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		MakeEquivalenceEdit
+//
+// Description:		Creates a journal record for an equivalence edit.
+//
+// Input Arguments:
+//		type	= const std::string&
+//		name	= const wxString& specifying the group
+//		e		= const Equivalence&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		EditJournal::Record
+//
+//==========================================================================
+EditJournal::Record XMLConversionFactors::MakeEquivalenceEdit(const std::string &type,
+	const wxString &name, const Equivalence &e)
+{
+	EditJournal::Record edit;
+	edit.push_back(type);
+	edit.push_back(std::string(name.utf8_str()));
+	edit.push_back(std::string(e.aUnit.utf8_str()));
+	edit.push_back(std::string(e.bUnit.utf8_str()));
+	edit.push_back(std::string(e.equation.utf8_str()));
+	return edit;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ApplyEdit
+//
+// Description:		Applies a journal record to the loaded groups.  Only the
+//					group that is edited is read (and only for equivalence
+//					edits), so replaying a journal keeps lazy loading lazy.
+//					Changed groups are not checked; the caller must check
+//					them (see CheckGroups()) and report the warnings.
+//
+// Input Arguments:
+//		edit	= const EditJournal::Record&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, index of the changed group (wxNOT_FOUND for a new group)
+//
+//==========================================================================
+int XMLConversionFactors::ApplyEdit(const EditJournal::Record &edit)
+{
+	if (edit.size() < 2)
+		throw std::runtime_error("Invalid edit");
+	const wxString name(wxString::FromUTF8(edit[1].c_str()));
+
+	if (edit[0] == addGroupEdit && edit.size() == 2)
 	{
-		if (groups[i].name.Cmp(name) == 0)
-			return groups[i];
+		AddGroups(std::vector<wxString>(1, name));
+		return wxNOT_FOUND;
 	}
 
-	throw std::runtime_error("Group not found");
+	const int i(FindGroup(name));
+	if (i == wxNOT_FOUND)
+		throw std::runtime_error(std::string((_T("Could not find group '") + name + _T("'")).mb_str()));
+	FactorGroup &group(groups[i]);
+
+	if (edit[0] == setVisibilityEdit && edit.size() == 3)
+	{
+		group.display = edit[2] == "1";
+		group.displaySet = true;
+		return i;
+	}
+
+	if (edit.size() != 5)
+		throw std::runtime_error("Invalid edit");
+
+	ReadGroup(i);
+	Equivalence e;
+	e.aUnit = wxString::FromUTF8(edit[2].c_str());
+	e.bUnit = wxString::FromUTF8(edit[3].c_str());
+	e.equation = wxString::FromUTF8(edit[4].c_str());
+	if (edit[0] == addEquivalenceEdit)
+		group.equiv.push_back(e);
+	else if (edit[0] == changeEquivalenceEdit)
+	{
+		std::vector<Equivalence>::iterator it(std::find_if(group.equiv.begin(), group.equiv.end(),
+			[&e](const Equivalence &g)
+		{
+			return g.aUnit.Cmp(e.aUnit) == 0 && g.bUnit.Cmp(e.bUnit) == 0;
+		}));
+		if (it == group.equiv.end())
+			throw std::runtime_error(std::string((_T("Could not find equivalence between '") +
+				e.aUnit + _T("' and '") + e.bUnit + _T("'")).mb_str()));
+		*it = e;
+	}
+	else
+		throw std::runtime_error("Invalid edit");
+
+	return i;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		DoErrorMessage
+// Function:		CheckGroups
 //
-// Description:		Displays "Error reading..." message.
+// Description:		Indexes, solves and checks the specified groups (after
+//					edits applied without checking), in parallel.
 //
 // Input Arguments:
-//		None
+//		names	= const std::set<wxString>&
 //
 // Output Arguments:
 //		None
 //
 // Return Value:
-//		None
+//		std::vector<wxString>, warnings for each group, in order
 //
 //==========================================================================
-void XMLConversionFactors::DoErrorMessage(const wxString &message) const
+std::vector<wxString> XMLConversionFactors::CheckGroups(const std::set<wxString> &names)
 {
-	wxMessageBox(_T("Error reading XML document:  ") + message + _T("."), _T("Error"), wxICON_ERROR);
+	std::vector<FactorGroup*> changed;
+	for (const auto &name : names)
+		changed.push_back(&groups[FindGroup(name)]);
+
+	std::vector<wxString> warnings(changed.size());
+	Parallel::For(changed.size(), [&changed, &warnings](const size_t &i)
+	{
+		changed[i]->IndexUnits();
+		warnings[i] = CheckGroup(*changed[i]);
+	});
+
+	return warnings;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		CreateEmptyDocument
+// Function:		ApplyEditToDocument
 //
-// Description:		Creates empty conversion XML document.
+// Description:		Applies a journal record to the document.
 //
 // Input Arguments:
-//		None
+//		edit	= const EditJournal::Record&, previously checked by ApplyEdit()
 //
 // Output Arguments:
 //		None
 //
 // Return Value:
-//		bool, true if file written successfully
+//		None
 //
 //==========================================================================
-bool XMLConversionFactors::CreateEmptyDocument()
+void XMLConversionFactors::ApplyEditToDocument(const EditJournal::Record &edit)
 {
-	document = std::make_unique<wxXmlDocument>();
-	document->SetRoot(new wxXmlNode(wxXML_ELEMENT_NODE, rootName));
-	
-	return document->IsOk();
+	const wxString name(wxString::FromUTF8(edit[1].c_str()));
+	if (edit[0] == addGroupEdit)
+		AddGroupToDocument(name);
+	else if (edit[0] == setVisibilityEdit)
+		SetGroupVisibilityInDocument(name, edit[2] == "1");
+	else
+	{
+		Equivalence e;
+		e.aUnit = wxString::FromUTF8(edit[2].c_str());
+		e.bUnit = wxString::FromUTF8(edit[3].c_str());
+		e.equation = wxString::FromUTF8(edit[4].c_str());
+		if (edit[0] == addEquivalenceEdit)
+			AddEquivalenceToDocument(name, e);
+		else
+			ChangeEquivalenceInDocument(name, e);
+	}
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		AddGroup
+// Function:		AddGroupToDocument
 //
-// Description:		Adds a group to the XML file.
+// Description:		Adds a group to the XML file.  The display flag is left
+//					out until it is set, so that in an overlay the group is
+//					shown or hidden as it is beneath.
 //
 // Input Arguments:
 //		name	= const wxString &name
@@ -359,22 +2025,22 @@ bool XMLConversionFactors::CreateEmptyDocument()
 //		None
 //
 //==========================================================================
-void XMLConversionFactors::AddGroup(const wxString &name)
+void XMLConversionFactors::AddGroupToDocument(const wxString &name)
 {
-	if (!document->IsOk())
+	if (!LoadDocument())
 		CreateEmptyDocument();
 	
 	wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE, groupNodeStr);
 	node->AddAttribute(nameAttr, name);
-	node->AddAttribute(displayAttr, _T("1"));
 	AddNodePreserveFormatting(document->GetRoot(), node, true);
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		AddEquivalence
+// Function:		AddEquivalenceToDocument
 //
-// Description:		Adds an equivalence to the specified group.
+// Description:		Adds an equivalence to the specified group in the XML
+//					document.
 //
 // Input Arguments:
 //		name	= const wxString& specifying the group
@@ -387,7 +2053,7 @@ void XMLConversionFactors::AddGroup(const wxString &name)
 //		None
 //
 //==========================================================================
-void XMLConversionFactors::AddEquivalence(const wxString &name, const Equivalence &e)
+void XMLConversionFactors::AddEquivalenceToDocument(const wxString &name, const Equivalence &e)
 {
 	wxXmlNode *groupNode = GetGroupNode(name);
 	AddNodePreserveFormatting(groupNode, e.ToXmlNode());
@@ -395,9 +2061,9 @@ void XMLConversionFactors::AddEquivalence(const wxString &name, const Equivalenc
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		ChangeEquivalence
+// Function:		ChangeEquivalenceInDocument
 //
-// Description:		Changes an existing equivalence.
+// Description:		Changes an existing equivalence in the XML document.
 //
 // Input Arguments:
 //		name	= const wxString& specifying the group
@@ -410,35 +2076,26 @@ void XMLConversionFactors::AddEquivalence(const wxString &name, const Equivalenc
 //		None
 //
 //==========================================================================
-void XMLConversionFactors::ChangeEquivalence(const wxString &name, const Equivalence &e)
+void XMLConversionFactors::ChangeEquivalenceInDocument(const wxString &name, const Equivalence &e)
 {
-	wxXmlNode *groupNode = GetGroupNode(name);
-	wxXmlNode *equiv = groupNode->GetChildren();
-
-	wxString aName, bName;
-	while (equiv)
+	const NodeIndex &index(GetNodeIndex(GetGroupNode(name)));
+	const auto equiv(index.equivalences.find(std::make_pair(e.aUnit, e.bUnit)));
+	if (equiv == index.equivalences.end())
 	{
-		if (equiv->GetAttribute(aUnitAttr, &aName) &&
-			equiv->GetAttribute(bUnitAttr, &bName) &&
-			aName.Cmp(e.aUnit) == 0 &&
-			bName.Cmp(e.bUnit) == 0)
-		{
-			equiv->DeleteAttribute(equationAttr);
-			equiv->AddAttribute(equationAttr, e.equation);
-			return;
-		}
-
-		equiv = equiv->GetNext();
+		assert(false);// Didn't find a match!
+		return;
 	}
 
-	assert(false);// Didn't find a match!
+	equiv->second->DeleteAttribute(equationAttr);
+	equiv->second->AddAttribute(equationAttr, e.equation);
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		SetGroupVisibility
+// Function:		SetGroupVisibilityInDocument
 //
-// Description:		Sets the visibility attribute for the specified group.
+// Description:		Sets the visibility attribute for the specified group in
+//					the XML document.
 //
 // Input Arguments:
 //		name	= const wxString&
@@ -451,7 +2108,7 @@ void XMLConversionFactors::ChangeEquivalence(const wxString &name, const Equival
 //		None
 //
 //==========================================================================
-void XMLConversionFactors::SetGroupVisibility(const wxString &name, const bool &visible)
+void XMLConversionFactors::SetGroupVisibilityInDocument(const wxString &name, const bool &visible)
 {
 	wxXmlNode *groupNode = GetGroupNode(name);
 	groupNode->DeleteAttribute(displayAttr);
@@ -464,7 +2121,9 @@ void XMLConversionFactors::SetGroupVisibility(const wxString &name, const bool &
 //
 // Description:		Adds the specified node as a child to the specified parent,
 //					and inserts indentation and newlines as necessary to make
-//					it appear just like human-entered nodes.
+//					it appear just like human-entered nodes.  Alphabetized
+//					nodes are placed before the first group that follows them
+//					alphabetically (at the end if there is none).
 //
 // Input Arguments:
 //		parent		= wxXmlNode*
@@ -478,23 +2137,21 @@ void XMLConversionFactors::SetGroupVisibility(const wxString &name, const bool &
 //		None
 //
 //==========================================================================
-void XMLConversionFactors::AddNodePreserveFormatting(wxXmlNode *parent, wxXmlNode *child, const bool &alphabetize) const
+void XMLConversionFactors::AddNodePreserveFormatting(wxXmlNode *parent, wxXmlNode *child, const bool &alphabetize)
 {
+	NodeIndex &index(GetNodeIndex(parent));
 	const bool needPreceedingNewLine(parent->GetChildren() == nullptr);
 
+	wxXmlNode *nodeAfterChild(nullptr);
 	if (alphabetize)
 	{
-		wxXmlNode *nodeAfterChild(nullptr);
-		if (GetNodeAfterAlphabetically(child->GetAttribute(nameAttr, wxEmptyString), parent, nodeAfterChild))
-			parent->InsertChild(child, nodeAfterChild);
-		else
-			parent->AddChild(child);
+		const auto next(index.groups.upper_bound(child->GetAttribute(nameAttr, wxEmptyString)));
+		if (next != index.groups.end())
+			nodeAfterChild = next->second;
 	}
-	else
-		parent->AddChild(child);
 
-	if (needPreceedingNewLine)
-		parent->InsertChild(GetNewLineNode(), child);
+	wxXmlNode *previous(nodeAfterChild ? index.previous[nodeAfterChild] : index.last);
+	InsertChildAfter(parent, child, previous);
 
 	int depth = child->GetDepth();
 	// TODO:  If preceeding node is not a newline (or is whitespace?), adjust depth
@@ -502,58 +2159,116 @@ void XMLConversionFactors::AddNodePreserveFormatting(wxXmlNode *parent, wxXmlNod
 		depth--;*/
 	// TODO:  The alphabetizing of groups makes the whitespace a little screwy, too
 
-	parent->InsertChild(GetIndentNode(depth), child);
-	parent->InsertChildAfter(GetIndentNode(depth - 1), child);
+	wxXmlNode *indent(GetIndentNode(depth));
+	InsertChildAfter(parent, indent, previous);
+	if (needPreceedingNewLine)
+		parent->InsertChild(GetNewLineNode(), indent);
+
+	wxXmlNode *closingIndent(GetIndentNode(depth - 1));
+	parent->InsertChildAfter(closingIndent, child);
 	parent->InsertChildAfter(GetNewLineNode(), child);
+
+	IndexNode(index, child, indent);
+	if (nodeAfterChild)
+		index.previous[nodeAfterChild] = closingIndent;
+	else
+		index.last = closingIndent;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
-// Function:		GetNodeAfterAlphabetically
+// Function:		GetNodeIndex
 //
-// Description:		Finds the node following the node to be added in order to
-//					maintain alphabetical entry of nodes.
+// Description:		Returns the index of the specified node's children,
+//					building it if this is the first time it is needed.
 //
 // Input Arguments:
-//		name			= const wxString&
-//		parent			= wxXmlNode*
+//		parent	= wxXmlNode*
 //
 // Output Arguments:
-//		nodeAfterChild	= wxXmlNode*&
+//		None
 //
 // Return Value:
-//		bool, true if a following node was found OR the child will be the first
-//		child for the parent (in the case of this node being the first child,
-//		nodeAfterChild will be NULL), false if no following node was found
-//		(indicating that the new node should be appended to the end of the
-//		parent's children)
+//		NodeIndex&
 //
 //==========================================================================
-bool XMLConversionFactors::GetNodeAfterAlphabetically(const wxString &name,
-	wxXmlNode *parent, wxXmlNode *&nodeAfterChild) const
+XMLConversionFactors::NodeIndex& XMLConversionFactors::GetNodeIndex(wxXmlNode *parent)
 {
-	bool hasChildren = false;
-	wxXmlNode *child = parent->GetChildren();
-	while (child)
+	const auto existing(nodeIndexes.find(parent));
+	if (existing != nodeIndexes.end())
+		return existing->second;
+
+	NodeIndex &index(nodeIndexes[parent]);
+	wxXmlNode *previous(nullptr);
+	for (wxXmlNode *child = parent->GetChildren(); child; child = child->GetNext())
 	{
-		hasChildren = true;
+		IndexNode(index, child, previous);
+		previous = child;
+	}
 
-		if (name.CmpNoCase(child->GetAttribute(nameAttr, wxEmptyString)) < 0)
-		{
-			nodeAfterChild = child;
-			return true;
-		}
+	index.last = previous;
+	return index;
+}
 
-		child = child->GetNext();
-	}
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		IndexNode
+//
+// Description:		Adds a child node to its parent's index.  Where names are
+//					repeated, the first node is kept (as a search would find).
+//
+// Input Arguments:
+//		index		= NodeIndex&
+//		node		= wxXmlNode*
+//		previous	= wxXmlNode*, sibling preceding node (NULL if it is first)
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::IndexNode(NodeIndex &index, wxXmlNode *node, wxXmlNode *previous)
+{
+	if (node->GetType() != wxXML_ELEMENT_NODE)
+		return;
 
-	if (!hasChildren)
-	{
-		nodeAfterChild = NULL;
-		return true;
-	}
+	index.previous[node] = previous;
+	if (node->GetName().Cmp(groupNodeStr) == 0)
+		index.groups.insert(std::make_pair(node->GetAttribute(nameAttr, wxEmptyString), node));
+	else if (node->GetName().Cmp(equivNode) == 0)
+		index.equivalences.insert(std::make_pair(std::make_pair(
+			node->GetAttribute(aUnitAttr, wxEmptyString),
+			node->GetAttribute(bUnitAttr, wxEmptyString)), node));
+}
 
-	return false;
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		InsertChildAfter
+//
+// Description:		Inserts a node after the specified sibling, or as the first
+//					child if there is none.  Unlike wxXmlNode::AddChild() and
+//					wxXmlNode::InsertChild(), this does not search the siblings.
+//
+// Input Arguments:
+//		parent		= wxXmlNode*
+//		child		= wxXmlNode*
+//		previous	= wxXmlNode*
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::InsertChildAfter(wxXmlNode *parent, wxXmlNode *child, wxXmlNode *previous)
+{
+	if (previous)
+		parent->InsertChildAfter(child, previous);
+	else
+		parent->InsertChild(child, parent->GetChildren());
 }
 
 //==========================================================================
@@ -617,18 +2332,14 @@ wxXmlNode* XMLConversionFactors::GetIndentNode(const unsigned int &level)
 //==========================================================================
 wxXmlNode* XMLConversionFactors::GetGroupNode(const wxString &name)
 {
-	wxXmlNode *child = document->GetRoot()->GetChildren();
-	while (child)
-	{
-		if (child->GetType() == wxXML_ELEMENT_NODE &&
-			child->GetName().Cmp(groupNodeStr) == 0)
-		{
-			if (child->GetAttribute(nameAttr, wxEmptyString).Cmp(name) == 0)
-				return child;
-		}
+	if (!LoadDocument())
+		throw std::runtime_error("Failed to load XML document for editing");
 
-		child = child->GetNext();
-	}
+	const NodeIndex &index(GetNodeIndex(document->GetRoot()));
+	const auto group(index.groups.find(name));
+	if (group != index.groups.end() &&
+		group->second->GetAttribute(nameAttr, wxEmptyString).Cmp(name) == 0)
+		return group->second;
 
 	wxString errorMessage(_T("Could not find group node for '") + name + _T("' in XML file"));
 	throw std::runtime_error(std::string(errorMessage.mb_str()));
@@ -664,12 +2375,13 @@ wxXmlNode* XMLConversionFactors::Equivalence::ToXmlNode() const
 
 //==========================================================================
 // Class:			XMLConversionFactors::FactorGroup
-// Function:		GetUnitList
+// Function:		IndexUnits
 //
-// Description:		Gets an optionally sorted list of all of the unit types in the group.
+// Description:		Builds the sorted list of distinct units, the index used
+//					to find a unit's ID and the connected components.
 //
 // Input Arguments:
-//		sort	= const bool&
+//		None
 //
 // Output Arguments:
 //		None
@@ -678,35 +2390,157 @@ wxXmlNode* XMLConversionFactors::Equivalence::ToXmlNode() const
 //		None
 //
 //==========================================================================
-wxArrayString XMLConversionFactors::FactorGroup::GetUnitList(const bool &sort) const
+void XMLConversionFactors::FactorGroup::IndexUnits()
 {
-	wxArrayString unitList;
-	for (size_t i = 0; i < equiv.size(); i++)
+	units.Clear();
+	unitIndex.clear();
+	unitIndex.reserve(equiv.size() * 2);
+	for (const auto &e : equiv)
 	{
-		unitList.Add(equiv[i].aUnit);
-		unitList.Add(equiv[i].bUnit);
+		if (unitIndex.insert(std::make_pair(e.aUnit, 0)).second)
+			units.Add(e.aUnit);
+		if (unitIndex.insert(std::make_pair(e.bUnit, 0)).second)
+			units.Add(e.bUnit);
 	}
-	if (sort)
-		unitList.Sort();
-	assert(unitList.Count() > 0);
-	for (size_t i = 1; i < unitList.Count(); i++)
+
+	units.Sort();
+	for (unsigned int i = 0; i < units.Count(); i++)
+		unitIndex[units[i]] = i;
+
+	// Each unit points toward the lowest ID in its component
+	components.resize(units.Count());
+	for (unsigned int i = 0; i < components.size(); i++)
+		components[i] = i;
+
+	auto find = [this](unsigned int i)
 	{
-		if (unitList[i].Cmp(unitList[i - 1]) == 0)
+		while (components[i] != i)
 		{
-			unitList.RemoveAt(i);
-			i--;
+			components[i] = components[components[i]];
+			i = components[i];
 		}
+		return i;
+	};
+
+	for (const auto &e : equiv)
+	{
+		const unsigned int a(find(unitIndex[e.aUnit])), b(find(unitIndex[e.bUnit]));
+		components[std::max(a, b)] = std::min(a, b);
 	}
 
-	return unitList;
+	// Roots come before their members, so one pass numbers the components
+	componentCount = 0;
+	for (unsigned int i = 0; i < components.size(); i++)
+		components[i] = components[i] == i ? componentCount++ : components[components[i]];
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::FactorGroup
+// Function:		FindUnit
+//
+// Description:		Finds the ID (index in the unit list) of the specified unit.
+//
+// Input Arguments:
+//		unit	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		int, ID of the unit or wxNOT_FOUND
+//
+//==========================================================================
+int XMLConversionFactors::FactorGroup::FindUnit(const wxString &unit) const
+{
+	std::unordered_map<wxString, unsigned int, StringHash>::const_iterator it(unitIndex.find(unit));
+	if (it == unitIndex.end())
+		return wxNOT_FOUND;
+
+	return static_cast<int>(it->second);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors::FactorGroup
+// Function:		TakeEquivalences
+//
+// Description:		Moves in the specified group's equivalences and unit
+//					index.  The name and display flag are not written.
+//
+// Input Arguments:
+//		group	= FactorGroup&&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::FactorGroup::TakeEquivalences(FactorGroup &&group)
+{
+	equiv = std::move(group.equiv);
+	units = std::move(group.units);
+	unitIndex = std::move(group.unitIndex);
+	components = std::move(group.components);
+	componentCount = group.componentCount;
 }
 
 //==========================================================================
 // Class:			XMLConversionFactors
 // Function:		Save
 //
-// Description:		Saves the specified document using transaction to prevent
-//					lost data in the event of an interrupted write.
+// Description:		Saves the edits made since the last save by appending
+//					them to the journal (which is flushed to disk).  Once the
+//					journal grows large, it is merged into the file.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLConversionFactors::Save()
+{
+	if (pendingEdits.empty())
+		return;
+
+	// An overlay's directory is created with its first edit
+	wxFileName file(fileName);
+	file.MakeAbsolute();
+	if (overlay && !file.DirExists())
+		file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+
+	if (!file.DirExists())
+	{
+		MessageReporter::Error(_T("Directory of '") + fileName + _T("' is inaccessible; changes cannot be saved."));
+		return;
+	}
+
+	if (!EditJournal::Append(journalFileName, sourceHash, sourceSize, pendingEdits))
+	{
+		MessageReporter::Error(_T("Cannot write '") + journalFileName + _T("'; changes were not saved."));
+		return;
+	}
+	pendingEdits.clear();
+
+	if (wxFileName::GetSize(journalFileName).GetValue() > maxJournalSize && !Compact())
+		MessageReporter::Warning(_T("Cannot merge '") + journalFileName + _T("' into '") + fileName +
+			_T("'; changes are saved in the journal."));
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		ReplayJournal
+//
+// Description:		Applies the journaled edits to the loaded groups.  A
+//					journal written for a different version of the file is
+//					discarded:  silently if it records that it was merged into
+//					the current file (the merge was interrupted before the
+//					journal was removed), otherwise with a warning.
 //
 // Input Arguments:
 //		None
@@ -718,19 +2552,218 @@ wxArrayString XMLConversionFactors::FactorGroup::GetUnitList(const bool &sort) c
 //		None
 //
 //==========================================================================
-void XMLConversionFactors::Save() const
+void XMLConversionFactors::ReplayJournal()
 {
-	if (!::wxDirExists(::wxGetCwd()))
+	if (!::wxFileExists(journalFileName))
+		return;
+
+	uint64_t journalHash, journalSize;
+	std::vector<EditJournal::Record> records;
+	if (!EditJournal::Read(journalFileName, journalHash, journalSize, records))
 	{
-		wxMessageBox(_T("Working directory is inaccessible; changes cannot be saved."),
-			_T("Error"), wxOK | wxICON_ERROR);
+		DoWarningMessage(_T("Cannot read '") + journalFileName + _T("'; saved edits were not applied"));
 		return;
 	}
 
-	const wxString transactionFileName(_T("~") + fileName);
-	document->Save(transactionFileName, wxXML_NO_INDENTATION);
-	wxCopyFile(transactionFileName, fileName);
-	wxRemoveFile(transactionFileName);
+	if (journalHash != sourceHash || journalSize != sourceSize)
+	{
+		const bool merged(!records.empty() && records.back().size() == 3 &&
+			records.back()[0] == compactedEdit &&
+			records.back()[1] == std::to_string(sourceHash) &&
+			records.back()[2] == std::to_string(sourceSize));
+		if (!merged)
+			DoWarningMessage(_T("Discarding edits in '") + journalFileName +
+				_T("', which were made to a different version of '") + fileName + _T("'"));
+		wxRemoveFile(journalFileName);
+		return;
+	}
+
+	std::set<wxString> changedGroups;
+	wxString errors;
+	for (const auto &edit : records)
+	{
+		if (!edit.empty() && edit[0] == compactedEdit)
+			continue;
+
+		try
+		{
+			if (ApplyEdit(edit) != wxNOT_FOUND)
+				changedGroups.insert(wxString::FromUTF8(edit[1].c_str()));
+		}
+		catch (std::exception &e)
+		{
+			errors += (errors.IsEmpty() ? wxString() : wxString(_T("\n"))) + wxString(e.what(), wxConvUTF8);
+		}
+	}
+
+	std::vector<wxString> warnings(CheckGroups(changedGroups));
+	warnings.insert(warnings.begin(), errors);
+
+	ReportMessages(std::vector<wxString>(warnings.size()), warnings);
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		Compact
+//
+// Description:		Merges the journal into the file.  The new file is written
+//					to a temporary file and flushed, then a record of it is
+//					added to the journal before it replaces the file (with an
+//					atomic rename, after which the directory is flushed) and
+//					the journal is removed.  Nothing is merged if the file
+//					has changed since it was loaded.  XML files are
+//					edited in place to keep their formatting; files in other
+//					formats are written from the loaded groups, which already
+//					include the journaled edits.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::Compact()
+{
+	uint64_t journalHash, journalSize;
+	std::vector<EditJournal::Record> records;
+	if (!EditJournal::Read(journalFileName, journalHash, journalSize, records) ||
+		journalHash != sourceHash || journalSize != sourceSize)
+		return false;
+
+	// The journal only applies to the file it was written against; if the
+	// file was changed outside the application, merging the edits into it
+	// would silently adopt the change
+	MappedFile current;
+	if (::wxFileExists(fileName) ? !current.Open(fileName) ||
+		CatalogCache::Hash(current.GetData(), current.GetSize()) != sourceHash ||
+		current.GetSize() != sourceSize : sourceSize != 0)
+		return false;
+	current.Close();
+
+	wxFileName transactionFile(fileName);
+	transactionFile.SetFullName(_T("~") + transactionFile.GetFullName());
+	const wxString transactionFileName(transactionFile.GetFullPath());
+	bool saved;
+
+	if (CatalogFormat::FromFileName(fileName) == CatalogFormat::typeXML)
+	{
+		try
+		{
+			if (!LoadDocument())
+				return false;
+
+			for (const auto &edit : records)
+			{
+				if (edit[0] != compactedEdit)
+					ApplyEditToDocument(edit);
+			}
+		}
+		catch (std::exception &)
+		{
+			document.reset();
+			return false;
+		}
+
+		saved = document->Save(transactionFileName, wxXML_NO_INDENTATION) &&
+			EditJournal::Sync(transactionFileName);
+		document.reset();
+	}
+	else
+	{
+		for (unsigned int i = 0; i < groups.size(); i++)
+			ReadGroup(i);
+		saved = CatalogFormat::Save(transactionFileName, groups);
+	}
+
+	MappedFile file;
+	if (!saved || !file.Open(transactionFileName))
+	{
+		wxRemoveFile(transactionFileName);
+		return false;
+	}
+
+	EditJournal::Record compacted;
+	compacted.push_back(compactedEdit);
+	compacted.push_back(std::to_string(CatalogCache::Hash(file.GetData(), file.GetSize())));
+	compacted.push_back(std::to_string(static_cast<uint64_t>(file.GetSize())));
+	file.Close();
+
+#ifdef __WXMSW__
+	// The file cannot be replaced while it is mapped.  Elsewhere the mapping
+	// keeps the replaced file, so groups not yet read are still read from it.
+	ReleaseSource();
+#endif
+	if (!EditJournal::Append(journalFileName, sourceHash, sourceSize,
+		std::vector<EditJournal::Record>(1, compacted)) ||
+		!wxRenameFile(transactionFileName, fileName, true))
+	{
+		wxRemoveFile(transactionFileName);
+		return false;
+	}
+
+	// The journal may only go once the rename is on disk
+	if (!EditJournal::SyncDirectory(fileName))
+		return false;
+
+	wxRemoveFile(journalFileName);
+	sourceHash = std::strtoull(compacted[1].c_str(), NULL, 10);
+	sourceSize = std::strtoull(compacted[2].c_str(), NULL, 10);
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLConversionFactors
+// Function:		Export
+//
+// Description:		Writes every group (including unsaved edits) to the
+//					specified file.  XML is written with indentation but
+//					without the formatting kept by the journal merge.
+//
+// Input Arguments:
+//		exportFileName	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLConversionFactors::Export(const wxString &exportFileName) const
+{
+	for (unsigned int i = 0; i < groups.size(); i++)
+		ReadGroup(i);
+
+	if (CatalogFormat::FromFileName(exportFileName) != CatalogFormat::typeXML)
+		return CatalogFormat::Save(exportFileName, groups);
+
+	wxXmlDocument exportDocument;
+	exportDocument.SetRoot(new wxXmlNode(wxXML_ELEMENT_NODE, rootName));
+	wxXmlNode *previous(nullptr);
+	for (const auto &group : groups)
+	{
+		wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE, groupNodeStr);
+		node->AddAttribute(nameAttr, group.name);
+		if (group.displaySet)
+			node->AddAttribute(displayAttr, group.display ? _T("1") : _T("0"));
+		InsertChildAfter(exportDocument.GetRoot(), node, previous);
+		previous = node;
+
+		wxXmlNode *previousEquivalence(nullptr);
+		for (const auto &equiv : group.equiv)
+		{
+			wxXmlNode *equivalenceNode(equiv.ToXmlNode());
+			InsertChildAfter(node, equivalenceNode, previousEquivalence);
+			previousEquivalence = equivalenceNode;
+		}
+	}
+
+	return exportDocument.Save(exportFileName, 2);
 }
 
 //==========================================================================
@@ -751,7 +2784,16 @@ void XMLConversionFactors::Save() const
 //==========================================================================
 void XMLConversionFactors::ResetForLoad()
 {
-	document = std::make_unique<wxXmlDocument>();
+	document.reset();
+	pendingEdits.clear();
+	sourceHash = 0;
+	sourceSize = 0;
 
 	groups.clear();
+	groupIndex.clear();
+	cache.reset();
+	source.reset();
+	groupRanges.clear();
+	groupSources.clear();
+	groupRead.reset();
 }
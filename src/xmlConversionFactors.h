@@ -16,21 +16,57 @@
 #define _XML_CONVERSION_FACTORS_H_
 
 // Standard C++ headers
+#include <atomic>
 #include <vector>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 // wxWidgets headers
 #include <wx/wx.h>
 #include <wx/xml/xml.h>
 
+// Local headers
+#include "stringHash.h"
+#include "editJournal.h"
+
+// Local forward declarations
+class CatalogCache;
+class MappedFile;
+
 class XMLConversionFactors
 {
 public:
-	XMLConversionFactors(const wxString &fileName);
-	~XMLConversionFactors() = default;
+	// In lazy mode, Load() only indexes the groups; each group's equivalences
+	// are read, validated and solved when the group is first used.  An
+	// overlay adds to the catalogs beneath it (see LayeredCatalog):  its file
+	// need not exist and its groups may be empty (e.g. only hiding a group).
+	XMLConversionFactors(const wxString &fileName, const bool &lazy = false, const bool &overlay = false);
+	~XMLConversionFactors();
 
 	bool Load();
-	void Save() const;
+	void Save();
+
+	// Loads the catalog, taking each group whose equivalences are unchanged
+	// from previous (already solved and checked) rather than checking it
+	// again.  May run on another thread, as long as previous is not edited
+	// (it may still read groups meanwhile, which never writes the names or
+	// display flags); groups previous has not read are compared by their
+	// source text rather than read.  Returns the names of groups that were added, removed or
+	// changed (or that could not be compared).
+	bool Load(const XMLConversionFactors &previous, std::set<wxString> &changedGroups);
+
+	// Exchanges the loaded catalogs of two objects for the same file, so a
+	// catalog loaded on another thread can be published in constant time
+	void Swap(XMLConversionFactors &other);
+
+	// Messages are normally shown as they occur.  Deferred messages (for
+	// loading on another thread) are kept until ShowMessages() is called.
+	void DeferMessages(const bool &defer) { deferMessages = defer; };
+	void ShowMessages();
 
 	class Equivalence
 	{
@@ -38,6 +74,12 @@ public:
 		wxString aUnit, bUnit;
 		wxString equation;
 
+		// Equation solved for a and for b (empty if not yet solved)
+		wxString aSolution, bSolution;
+
+		// False if conversion paths must not use this equivalence (see CycleCheck)
+		bool pathEdge = true;
+
 		wxXmlNode* ToXmlNode() const;
 	};
 
@@ -46,31 +88,136 @@ public:
 	public:
 		wxString name;
 		bool display;
+		bool displaySet = true;// False if the catalog leaves it out (see LayeredCatalog)
 
 		std::vector<Equivalence> equiv;
 
-		wxArrayString GetUnitList(const bool &sort = true) const;
+		// Each distinct unit once, sorted; a unit's ID is its index in the list.
+		// IndexUnits() must be called after equiv is changed.
+		const wxArrayString& GetUnitList() const { return units; };
+		int FindUnit(const wxString &unit) const;// ID or wxNOT_FOUND
+		void IndexUnits();
+
+		// Moves in the other group's equivalences and unit index, leaving the
+		// name and display flag as they are
+		void TakeEquivalences(FactorGroup &&group);
+
+		// Units can only be converted to units in the same connected component
+		// (components are numbered in order of their lowest unit ID)
+		unsigned int ComponentCount() const { return componentCount; };
+		unsigned int GetComponent(const unsigned int &unit) const { return components[unit]; };
+
+	private:
+		wxArrayString units;
+		std::unordered_map<wxString, unsigned int, StringHash> unitIndex;
+		std::vector<unsigned int> components;// Indexed by unit ID
+		unsigned int componentCount = 0;
 	};
 
 	unsigned int GroupCount() const { return groups.size(); };
-	FactorGroup GetGroup(const unsigned int &i) const { return groups[i]; };
-	FactorGroup GetGroup(const wxString &name) const;
+	const wxString& GetGroupName(const unsigned int &i) const { return groups[i].name; };
+	bool GroupIsDisplayed(const unsigned int &i) const { return groups[i].display; };
+	bool GroupSetsDisplay(const unsigned int &i) const { return groups[i].displaySet; };
+	const FactorGroup& GetGroup(const unsigned int &i) const;
+	const FactorGroup& GetGroup(const wxString &name) const;// Throws if not found
+	int FindGroup(const wxString &name) const;// wxNOT_FOUND if not found
 
+	// Edits apply to the loaded groups at once; Save() journals them.  These
+	// throw if the group (or for ChangeEquivalence(), the equivalence) is
+	// not found.  Equivalence edits check the group and return the warnings.
 	void AddGroup(const wxString &name);
-	void AddEquivalence(const wxString &name, const Equivalence &e);
-	void ChangeEquivalence(const wxString &name, const Equivalence &e);
+	wxString AddEquivalence(const wxString &name, const Equivalence &e);
+	wxString ChangeEquivalence(const wxString &name, const Equivalence &e);
 	void SetGroupVisibility(const wxString &name, const bool &visible);
 
+	// Adds each equivalence to its group (or changes it, if the group already
+	// has one between the same units), creating groups as needed.  If any
+	// edit fails, none are applied.  Each changed group is checked once
+	// (solutions given with the equivalences are used as they are); returns
+	// the warnings.
+	wxString AddEquivalences(const std::vector<std::pair<wxString, Equivalence> > &entries);
+
+	// Solves (where not already solved) and checks a group whose
+	// equivalences have changed, after IndexUnits().  Returns the warnings.
+	static wxString CheckGroup(FactorGroup &group);
+
+	// Checks that the relation uses both units and that they differ.
+	// Returns the error (empty if there is none).
+	static wxString CheckEquivalence(const Equivalence &e);
+
+	// Writes every group to the specified file, in the format given by its
+	// extension (see CatalogFormat), without any saved formatting
+	bool Export(const wxString &exportFileName) const;
+
 	static const wxString xmlEncoding;
 	wxString GetFileName() const { return fileName; };
+	bool IsLazy() const { return lazy; };
+	bool IsOverlay() const { return overlay; };
 
 private:
 	const wxString fileName;
+	const wxString cacheFileName;
+	const wxString journalFileName;
+
+	// Identifies the file the groups were read from (zero for the embedded
+	// catalog), so the journal is only applied to the file it was written for
+	uint64_t sourceHash = 0;
+	uint64_t sourceSize = 0;
+
+	// Edits not yet saved to the journal
+	std::vector<EditJournal::Record> pendingEdits;
+
+	static const std::string addGroupEdit;
+	static const std::string addEquivalenceEdit;
+	static const std::string changeEquivalenceEdit;
+	static const std::string setVisibilityEdit;
+	static const std::string compactedEdit;
+	static const uint64_t maxJournalSize;
+
+	static EditJournal::Record MakeEquivalenceEdit(const std::string &type,
+		const wxString &name, const Equivalence &e);
+	void AddGroups(std::vector<wxString> names);
+	void RemoveGroups(const std::vector<wxString> &names);
+	int ApplyEdit(const EditJournal::Record &edit);
+	std::vector<wxString> CheckGroups(const std::set<wxString> &names);
+	void ReplayJournal();
+	bool Compact();
+
+	// Only built when the journal is merged into the file (the catalog itself
+	// is read in a single streaming pass)
 	std::unique_ptr<wxXmlDocument> document;
+	bool LoadDocument();
+	void ApplyEditToDocument(const EditJournal::Record &edit);
+	void AddGroupToDocument(const wxString &name);
+	void AddEquivalenceToDocument(const wxString &name, const Equivalence &e);
+	void ChangeEquivalenceInDocument(const wxString &name, const Equivalence &e);
+	void SetGroupVisibilityInDocument(const wxString &name, const bool &visible);
 
 	void ResetForLoad();
-	void AddNodePreserveFormatting(wxXmlNode *parent, wxXmlNode *child, const bool &alphabetize = false) const;
-	bool GetNodeAfterAlphabetically(const wxString &name, wxXmlNode *parent, wxXmlNode *&nodeAfterChild) const;
+	bool LoadCatalog();
+	void AddNodePreserveFormatting(wxXmlNode *parent, wxXmlNode *child, const bool &alphabetize = false);
+
+	// The children of a document node, so that they can be found and
+	// inserted without walking their siblings (wxXmlNode is only linked
+	// forward).  Built when first needed and kept in step with the document
+	// by AddNodePreserveFormatting().
+	struct NoCaseLess
+	{
+		bool operator()(const wxString &a, const wxString &b) const { return a.CmpNoCase(b) < 0; }
+	};
+
+	struct NodeIndex
+	{
+		std::map<wxString, wxXmlNode*, NoCaseLess> groups;
+		std::map<std::pair<wxString, wxString>, wxXmlNode*> equivalences;// By a and b units
+		std::unordered_map<wxXmlNode*, wxXmlNode*> previous;// Sibling preceding each element
+		wxXmlNode *last = nullptr;
+	};
+
+	std::unordered_map<wxXmlNode*, NodeIndex> nodeIndexes;// By parent
+	NodeIndex& GetNodeIndex(wxXmlNode *parent);
+	static void IndexNode(NodeIndex &index, wxXmlNode *node, wxXmlNode *previous);
+	static void InsertChildAfter(wxXmlNode *parent, wxXmlNode *child, wxXmlNode *previous);
 
 	static wxXmlNode* GetNewLineNode();
 	static wxXmlNode* GetIndentNode(const unsigned int &level);
@@ -79,10 +226,42 @@ private:
 
 	wxXmlNode* GetGroupNode(const wxString &name);
 
-	std::vector<FactorGroup> groups;
+	// Groups not yet read have only a name and display flag.  They are read
+	// from the cache (if it is open) or from their byte range in source,
+	// which stays mapped until then.  Edits add groups (with no source) in
+	// order, so each group keeps the index of its source entry; groupRead is
+	// indexed by source entry.
+	mutable std::vector<FactorGroup> groups;
+	std::unordered_map<wxString, unsigned int, StringHash> groupIndex;
+	const bool lazy;
+	const bool overlay;
+	std::unique_ptr<CatalogCache> cache;
+	std::unique_ptr<MappedFile> source;
+	std::vector<std::pair<size_t, size_t> > groupRanges;
+	std::vector<int> groupSources;// By group; wxNOT_FOUND for groups added by edits
+
+	struct ReadState
+	{
+		std::once_flag once;
+		std::atomic<bool> done{false};// So other threads can tell without reading
+	};
+
+	std::unique_ptr<ReadState[]> groupRead;// NULL if all groups have been read
+	const XMLConversionFactors *reuse = nullptr;// During Load(previous, ...)
+
+	void ReadGroup(const unsigned int &i) const;
+	bool ReadAllGroups(const char *data);
+	wxString ReadGroupFromSource(const char *data, const unsigned int &range,
+		FactorGroup &group, wxString &warnings) const;
+	void ReleaseSource();
+	bool ReuseGroup(FactorGroup &group) const;
+	const FactorGroup* GetReadGroup(const unsigned int &i) const;
+	bool GetGroupSource(const unsigned int &i, const char *&first, const char *&last) const;
+	bool SameGroup(const unsigned int &i, const XMLConversionFactors &previous, const unsigned int &j) const;
+	bool CheckAllGroups();
 
-	bool ReadGroupNode(wxXmlNode *node);
-	bool ReadEquivNode(wxXmlNode *node, Equivalence &equiv);
+	// Builds groups from the streaming reader's events
+	class LoadHandler;
 
 	// XML Tags
 	static const wxString rootName;
@@ -94,9 +273,22 @@ private:
 	static const wxString bUnitAttr;
 	static const wxString equationAttr;
 
-	bool DuplicateGroupsExist() const;
+	bool IndexGroups();
+	static wxString SolveEquivalences(FactorGroup &group);
+	static bool SameEquivalences(const FactorGroup &a, const FactorGroup &b);
+	bool ReportMessages(const std::vector<wxString> &errors, const std::vector<wxString> &warnings) const;
+
+#ifdef EMBEDDED_CATALOG
+	bool LoadEmbedded();
+	void CopyGroupsToDocument();
+#endif
+
+	bool deferMessages = false;
+	mutable std::mutex messageMutex;
+	mutable wxString deferredErrors, deferredWarnings;
 
 	void DoErrorMessage(const wxString &message) const;
+	void DoWarningMessage(const wxString &message) const;
 };
 
 #endif// _XML_CONVERSION_FACTORS_H_
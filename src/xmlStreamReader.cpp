@@ -0,0 +1,663 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  xmlStreamReader.cpp
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Single-pass, event-based (SAX-style) XML reader.  Supports the
+//				 subset of XML used by Converter's files:  elements, attributes,
+//				 the predefined and numeric entities, comments, processing
+//				 instructions and CDATA (text content is not reported).
+// History:
+
+// Standard C++ headers
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Local headers
+#include "xmlStreamReader.h"
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		Parse
+//
+// Description:		Parses the document in the specified range, reporting
+//					each element to the handler as it is encountered.
+//
+// Input Arguments:
+//		first	= const char*
+//		last	= const char*
+//		handler	= Handler&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise (see GetError())
+//
+//==========================================================================
+bool XMLStreamReader::Parse(const char *first, const char *last, Handler &handler)
+{
+	start = first;
+	position = first;
+	end = last;
+	tagStart = first;
+	tagEnd = first;
+	encoding.Clear();
+	error.Clear();
+	errorPosition = nullptr;
+	openElements.clear();
+
+	// UTF-8 byte order mark
+	if (end - position >= 3 && memcmp(position, "\xEF\xBB\xBF", 3) == 0)
+		position += 3;
+	const char *content(position);
+
+	bool foundRoot(false);
+	while (position != end)
+	{
+		if (*position != '<')
+		{
+			// Text content is not needed, but outside the root it must be whitespace
+			const char *nextTag(std::find(position, end, '<'));
+			if (openElements.empty() && std::find_if(position, nextTag,
+				[](const char &c) { return !IsWhitespace(c); }) != nextTag)
+				return Fail(_T("Text found outside of the root element"));
+			position = nextTag;
+			continue;
+		}
+
+		tagStart = position;
+		if (end - position >= 6 && memcmp(position, "<?xml", 5) == 0 &&
+			IsWhitespace(position[5]))
+		{
+			if (tagStart != content)
+				return Fail(_T("XML declaration must be at the start of the document"));
+			if (!ReadDeclaration())
+				return false;
+		}
+		else if (end - position >= 2 && position[1] == '?')
+		{
+			if (!SkipPast("?>"))
+				return Fail(_T("Unterminated processing instruction"));
+		}
+		else if (end - position >= 4 && memcmp(position, "<!--", 4) == 0)
+		{
+			if (!SkipPast("-->"))
+				return Fail(_T("Unterminated comment"));
+		}
+		else if (end - position >= 9 && memcmp(position, "<![CDATA[", 9) == 0)
+		{
+			if (openElements.empty())
+				return Fail(_T("CDATA found outside of the root element"));
+			if (!SkipPast("]]>"))
+				return Fail(_T("Unterminated CDATA section"));
+		}
+		else if (end - position >= 2 && position[1] == '!')
+		{
+			// DOCTYPE (internal subsets are not supported)
+			const char *close(std::find(position, end, '>'));
+			if (std::find(position, close, '[') != close)
+				return Fail(_T("Document type definitions are not supported"));
+			if (!SkipPast(">"))
+				return Fail(_T("Unterminated document type declaration"));
+		}
+		else if (end - position >= 2 && position[1] == '/')
+		{
+			if (!ReadEndTag(handler))
+				return false;
+		}
+		else
+		{
+			if (openElements.empty() && foundRoot)
+				return Fail(_T("Only one root element is allowed"));
+			foundRoot = true;
+			if (!ReadStartTag(handler))
+				return false;
+		}
+	}
+
+	if (!foundRoot)
+		return Fail(_T("No root element"));
+	else if (!openElements.empty())
+		return Fail(_T("Missing closing tag for '") + wxString::FromUTF8(openElements.back().c_str()) + _T("'"));
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		ReadStartTag
+//
+// Description:		Reads an element's start tag (or empty-element tag) and
+//					reports it to the handler.
+//
+// Input Arguments:
+//		handler	= Handler&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLStreamReader::ReadStartTag(Handler &handler)
+{
+	position++;// '<'
+	std::string name;
+	if (!ReadName(name))
+		return Fail(_T("Expected element name"));
+
+	if (!ReadAttributes())
+		return false;
+
+	bool empty(false);
+	if (position != end && *position == '/')
+	{
+		empty = true;
+		position++;
+	}
+
+	if (position == end || *position != '>')
+		return Fail(_T("Expected '>' to close '") + wxString::FromUTF8(name.c_str()) + _T("' tag"));
+	position++;
+	tagEnd = position;
+
+	if (!handler.StartElement(name, attributes))
+		return Fail(error.IsEmpty() ? wxString(_T("Parsing stopped by handler")) : error);
+
+	if (empty)
+	{
+		if (!handler.EndElement(name))
+			return Fail(error.IsEmpty() ? wxString(_T("Parsing stopped by handler")) : error);
+	}
+	else
+		openElements.push_back(name);
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		ReadEndTag
+//
+// Description:		Reads an element's end tag and reports it to the handler.
+//
+// Input Arguments:
+//		handler	= Handler&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLStreamReader::ReadEndTag(Handler &handler)
+{
+	position += 2;// "</"
+	std::string name;
+	if (!ReadName(name))
+		return Fail(_T("Expected element name"));
+
+	SkipWhitespace();
+	if (position == end || *position != '>')
+		return Fail(_T("Expected '>' to close '") + wxString::FromUTF8(name.c_str()) + _T("' tag"));
+	position++;
+	tagEnd = position;
+
+	if (openElements.empty() || openElements.back() != name)
+		return Fail(_T("Unexpected closing tag '") + wxString::FromUTF8(name.c_str()) + _T("'"));
+	openElements.pop_back();
+
+	if (!handler.EndElement(name))
+		return Fail(error.IsEmpty() ? wxString(_T("Parsing stopped by handler")) : error);
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		ReadDeclaration
+//
+// Description:		Reads the XML declaration, recording the encoding.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLStreamReader::ReadDeclaration()
+{
+	position += 5;// "<?xml"
+	if (!ReadAttributes())
+		return false;
+
+	if (end - position < 2 || position[0] != '?' || position[1] != '>')
+		return Fail(_T("Expected '?>' to close XML declaration"));
+	position += 2;
+	tagEnd = position;
+
+	const std::string *value(FindAttribute(attributes, "encoding"));
+	if (value)
+		encoding = wxString::FromUTF8(value->c_str());
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		ReadAttributes
+//
+// Description:		Reads name="value" pairs up to the end of the tag.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLStreamReader::ReadAttributes()
+{
+	attributes.clear();
+	while (true)
+	{
+		const char *beforeWhitespace(position);
+		SkipWhitespace();
+		if (position == end)
+			return Fail(_T("Unexpected end of document"));
+		else if (*position == '>' || *position == '/' || *position == '?')
+			return true;
+		else if (position == beforeWhitespace)
+			return Fail(_T("Expected whitespace between attributes"));
+
+		Attribute attribute;
+		if (!ReadName(attribute.name))
+			return Fail(_T("Expected attribute name"));
+
+		SkipWhitespace();
+		if (position == end || *position != '=')
+			return Fail(_T("Expected '=' after attribute '") + wxString::FromUTF8(attribute.name.c_str()) + _T("'"));
+		position++;
+		SkipWhitespace();
+
+		if (position == end || (*position != '"' && *position != '\''))
+			return Fail(_T("Expected quoted value for attribute '") + wxString::FromUTF8(attribute.name.c_str()) + _T("'"));
+
+		const char *valueEnd(std::find(position + 1, end, *position));
+		if (valueEnd == end)
+			return Fail(_T("Unterminated value for attribute '") + wxString::FromUTF8(attribute.name.c_str()) + _T("'"));
+
+		if (!DecodeValue(position + 1, valueEnd, attribute.value))
+			return false;
+		position = valueEnd + 1;
+
+		if (FindAttribute(attributes, attribute.name.c_str()))
+			return Fail(_T("Duplicate attribute '") + wxString::FromUTF8(attribute.name.c_str()) + _T("'"));
+
+		attributes.push_back(std::move(attribute));
+	}
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		DecodeValue
+//
+// Description:		Copies an attribute value, replacing entity and character
+//					references and normalizing whitespace characters.
+//
+// Input Arguments:
+//		first	= const char*
+//		last	= const char*
+//
+// Output Arguments:
+//		value	= std::string&
+//
+// Return Value:
+//		bool, true for success, false otherwise
+//
+//==========================================================================
+bool XMLStreamReader::DecodeValue(const char *first, const char *last, std::string &value)
+{
+	value.clear();
+	value.reserve(last - first);
+	for (const char *p = first; p != last; p++)
+	{
+		if (*p == '<')
+		{
+			position = p;
+			return Fail(_T("'<' is not allowed in attribute values"));
+		}
+		else if (*p == '\t' || *p == '\n' || *p == '\r')
+		{
+			value.push_back(' ');
+			continue;
+		}
+		else if (*p != '&')
+		{
+			value.push_back(*p);
+			continue;
+		}
+
+		const char *semicolon(std::find(p, last, ';'));
+		if (semicolon == last)
+		{
+			position = p;
+			return Fail(_T("Unterminated entity reference"));
+		}
+
+		const std::string entity(p + 1, semicolon);
+		if (entity == "amp")
+			value.push_back('&');
+		else if (entity == "lt")
+			value.push_back('<');
+		else if (entity == "gt")
+			value.push_back('>');
+		else if (entity == "quot")
+			value.push_back('"');
+		else if (entity == "apos")
+			value.push_back('\'');
+		else if (entity.size() > 1 && entity[0] == '#')
+		{
+			const bool hex(entity[1] == 'x');
+			char *numberEnd;
+			const unsigned long codePoint(strtoul(entity.c_str() + (hex ? 2 : 1), &numberEnd, hex ? 16 : 10));
+			if (*numberEnd != '\0' || codePoint == 0 || codePoint > 0x10FFFF)
+			{
+				position = p;
+				return Fail(_T("Invalid character reference '&") + wxString::FromUTF8(entity.c_str()) + _T(";'"));
+			}
+			AppendUTF8(codePoint, value);
+		}
+		else
+		{
+			position = p;
+			return Fail(_T("Unknown entity '&") + wxString::FromUTF8(entity.c_str()) + _T(";'"));
+		}
+
+		p = semicolon;
+	}
+
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		AppendUTF8
+//
+// Description:		Appends the UTF-8 encoding of a code point to the string.
+//
+// Input Arguments:
+//		codePoint	= const unsigned long&
+//
+// Output Arguments:
+//		s			= std::string&
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLStreamReader::AppendUTF8(const unsigned long &codePoint, std::string &s)
+{
+	if (codePoint < 0x80)
+		s.push_back(static_cast<char>(codePoint));
+	else if (codePoint < 0x800)
+	{
+		s.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+		s.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else if (codePoint < 0x10000)
+	{
+		s.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+		s.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		s.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else
+	{
+		s.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+		s.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+		s.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		s.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		ReadName
+//
+// Description:		Reads an element or attribute name.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		name	= std::string&
+//
+// Return Value:
+//		bool, true if a name was found
+//
+//==========================================================================
+bool XMLStreamReader::ReadName(std::string &name)
+{
+	const char *nameStart(position);
+	while (position != end && IsNameCharacter(*position))
+		position++;
+
+	if (position == nameStart || (*nameStart >= '0' && *nameStart <= '9') ||
+		*nameStart == '-' || *nameStart == '.')
+		return false;
+
+	name.assign(nameStart, position);
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		SkipPast
+//
+// Description:		Advances the position past the next occurrence of the
+//					specified string.
+//
+// Input Arguments:
+//		terminator	= const char*
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, true if the terminator was found
+//
+//==========================================================================
+bool XMLStreamReader::SkipPast(const char *terminator)
+{
+	const char *terminatorEnd(terminator + strlen(terminator));
+	const char *found(std::search(position, end, terminator, terminatorEnd));
+	if (found == end)
+		return false;
+
+	position = found + (terminatorEnd - terminator);
+	tagEnd = position;
+	return true;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		SkipWhitespace
+//
+// Description:		Advances the position past any whitespace.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLStreamReader::SkipWhitespace()
+{
+	while (position != end && IsWhitespace(*position))
+		position++;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		IsWhitespace
+//
+// Description:		Tests for XML whitespace characters.
+//
+// Input Arguments:
+//		c	= const char&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool XMLStreamReader::IsWhitespace(const char &c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		IsNameCharacter
+//
+// Description:		Tests for characters that may appear in names.  All
+//					non-ASCII (multi-byte UTF-8) characters are accepted.
+//
+// Input Arguments:
+//		c	= const char&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool
+//
+//==========================================================================
+bool XMLStreamReader::IsNameCharacter(const char &c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+		c == '_' || c == ':' || c == '-' || c == '.' || (c & 0x80) != 0;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		FindAttribute
+//
+// Description:		Finds the value of the named attribute.
+//
+// Input Arguments:
+//		attributes	= const AttributeList&
+//		name		= const char*
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		const std::string*, NULL if the attribute is not present
+//
+//==========================================================================
+const std::string* XMLStreamReader::FindAttribute(const AttributeList &attributes, const char *name)
+{
+	for (const auto &attribute : attributes)
+	{
+		if (attribute.name.compare(name) == 0)
+			return &attribute.value;
+	}
+
+	return NULL;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		SetError
+//
+// Description:		Allows handlers to describe why they stopped the parse.
+//
+// Input Arguments:
+//		message	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		None
+//
+//==========================================================================
+void XMLStreamReader::SetError(const wxString &message)
+{
+	error = message;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		Fail
+//
+// Description:		Records an error at the current position.
+//
+// Input Arguments:
+//		message	= const wxString&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		bool, always false
+//
+//==========================================================================
+bool XMLStreamReader::Fail(const wxString &message)
+{
+	error = message;
+	errorPosition = position;
+	return false;
+}
+
+//==========================================================================
+// Class:			XMLStreamReader
+// Function:		GetLine
+//
+// Description:		Returns the line number on which the error occurred (or
+//					the current line, if there is no error).  Lines are only
+//					counted when requested, so the parse itself never pays
+//					for it.
+//
+// Input Arguments:
+//		None
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		unsigned int
+//
+//==========================================================================
+unsigned int XMLStreamReader::GetLine() const
+{
+	const char *p(errorPosition ? errorPosition : position);
+	if (!start || !p)
+		return 0;
+
+	return static_cast<unsigned int>(std::count(start, p, '\n')) + 1;
+}
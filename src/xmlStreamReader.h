@@ -0,0 +1,94 @@
+/*===================================================================================
+                                       Converter
+                              Copyright Kerry R. Loux 2013
+
+  This code is licensed under the MIT License (http://opensource.org/licenses/MIT).
+
+===================================================================================*/
+
+// File:  xmlStreamReader.h
+// Created:  10/19/2026
+// Author:  K. Loux
+// Description:  Single-pass, event-based (SAX-style) XML reader.  Supports the
+//				 subset of XML used by Converter's files:  elements, attributes,
+//				 the predefined and numeric entities, comments, processing
+//				 instructions and CDATA (text content is not reported).
+// History:
+
+#ifndef _XML_STREAM_READER_H_
+#define _XML_STREAM_READER_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+
+// wxWidgets headers
+#include <wx/wx.h>
+
+class XMLStreamReader
+{
+public:
+	struct Attribute
+	{
+		std::string name;
+		std::string value;// UTF-8, entities replaced
+	};
+
+	typedef std::vector<Attribute> AttributeList;
+
+	class Handler
+	{
+	public:
+		virtual ~Handler() = default;
+
+		// Return false to stop parsing (GetError() returns the message from
+		// the handler, if one was set with SetError())
+		virtual bool StartElement(const std::string &name, const AttributeList &attributes) = 0;
+		virtual bool EndElement(const std::string &name) = 0;
+	};
+
+	bool Parse(const char *first, const char *last, Handler &handler);
+
+	static const std::string* FindAttribute(const AttributeList &attributes, const char *name);
+
+	// Encoding named in the XML declaration (empty if there was no declaration)
+	wxString GetEncoding() const { return encoding; };
+
+	// Byte offsets (from first) of the tag currently being reported
+	size_t GetTagStart() const { return tagStart - start; };
+	size_t GetTagEnd() const { return tagEnd - start; };
+
+	void SetError(const wxString &message);
+	wxString GetError() const { return error; };
+	unsigned int GetLine() const;
+
+private:
+	const char *start = nullptr;
+	const char *position = nullptr;
+	const char *end = nullptr;
+	const char *tagStart = nullptr;
+	const char *tagEnd = nullptr;
+
+	wxString encoding;
+	wxString error;
+	const char *errorPosition = nullptr;
+
+	std::vector<std::string> openElements;
+	AttributeList attributes;
+
+	bool Fail(const wxString &message);
+	bool SkipPast(const char *terminator);
+	void SkipWhitespace();
+	bool ReadName(std::string &name);
+	bool ReadAttributes();
+	bool ReadDeclaration();
+	bool ReadStartTag(Handler &handler);
+	bool ReadEndTag(Handler &handler);
+	bool DecodeValue(const char *first, const char *last, std::string &value);
+
+	static bool IsWhitespace(const char &c);
+	static bool IsNameCharacter(const char &c);
+	static void AppendUTF8(const unsigned long &codePoint, std::string &s);
+};
+
+#endif// _XML_STREAM_READER_H_